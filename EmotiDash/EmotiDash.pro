@@ -1,4 +1,4 @@
-QT      += core gui network widgets printsupport  charts
+QT      += core gui network widgets printsupport
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,25 +10,74 @@ CONFIG += c++17
 
 SOURCES += \
     channelfrequencies.cpp \
+    compressedseries.cpp \
     doublebuffer.cpp \
+    dspfilters.cpp \
+    edaanalyzer.cpp \
     emotibitcontroller.cpp \
     emotibitwifirobotea.cpp \
     formplot.cpp \
     formvistaemotibit.cpp \
+    framescheduler.cpp \
+    hrvspectrum.cpp \
+    imuengine.cpp \
+    latencytracer.cpp \
     main.cpp \
     mainwindow.cpp \
-    qemotibitpacket.cpp
+    minmaxpyramid.cpp \
+    multirateresampler.cpp \
+    packetlogmodel.cpp \
+    perfhud.cpp \
+    plotdecimator.cpp \
+    ppgbeatdetector.cpp \
+    qemotibitpacket.cpp \
+    rateestimator.cpp \
+    realfft.cpp \
+    recordingwriter.cpp \
+    sessionstore.cpp \
+    signalquality.cpp \
+    streampipeline.cpp \
+    stripchart.cpp \
+    stripchartrenderer.cpp \
+    timeseriesstore.cpp \
+    welchpsd.cpp \
+    windowedstats.cpp
 
 HEADERS += \
     channelfrequencies.h \
+    compressedseries.h \
     doublebuffer.h \
+    dspfilters.h \
+    edaanalyzer.h \
     emotiBitComms.h \
     emotibitcontroller.h \
     emotibitwifirobotea.h \
     formplot.h \
     formvistaemotibit.h \
+    framescheduler.h \
+    hrvspectrum.h \
+    imuengine.h \
+    latencytracer.h \
     mainwindow.h \
-    qemotibitpacket.h
+    minmaxpyramid.h \
+    multirateresampler.h \
+    packetlogmodel.h \
+    perfcounters.h \
+    perfhud.h \
+    plotdecimator.h \
+    ppgbeatdetector.h \
+    qemotibitpacket.h \
+    rateestimator.h \
+    realfft.h \
+    recordingwriter.h \
+    sessionstore.h \
+    signalquality.h \
+    streampipeline.h \
+    stripchart.h \
+    stripchartrenderer.h \
+    timeseriesstore.h \
+    welchpsd.h \
+    windowedstats.h
 
 FORMS += \
     formplot.ui \
@@ -48,6 +48,10 @@ ChannelFrequencies::ChannelFrequencies() {
     channelFrequencies["BI"] = 1; // Intervalo entre latidos (calculado)
     channelFrequencies["BV"] = 1; // Canal no identificado
 
+    // Los canales calculados se emiten por eventos (latidos, respuestas EDA), no a frecuencia fija;
+    // la frecuencia indicada arriba es solo su tasa nominal de referencia
+    eventChannels = { "HR", "SR", "SF", "SA", "BI", "BV" };
+
 
 }
 
@@ -98,3 +102,18 @@ QMap<QString, double> ChannelFrequencies::getAllFrequencies() const {
     return channelFrequencies;
 }
 
+
+
+
+
+// Indica si el canal es de eventos
+/**
+ * Indica si un canal se genera por eventos y no a una frecuencia fija.
+ * Sus muestras se reparten en el intervalo transcurrido desde el paquete anterior.
+ *
+ * @param channel El canal a verificar.
+ * @return true si el canal es de eventos.
+ */
+bool ChannelFrequencies::isEventChannel(const QString& channel) const {
+    return eventChannels.contains(channel);
+}
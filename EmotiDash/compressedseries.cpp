@@ -0,0 +1,272 @@
+/****************************************************************************
+ * CompressedSeries.cpp
+ *
+ * Descripción: Codificación Gorilla de series temporales en bloques.
+ * Los tiempos se codifican como delta-of-delta con prefijos de longitud
+ * variable y los valores float como XOR con el valor anterior.
+ *
+ * Fecha: 2025-05-22
+ ****************************************************************************/
+
+#include "compressedseries.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+quint32 floatBits(float v){
+    quint32 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(quint32 bits){
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// Ceros a la izquierda de un valor de 32 bits distinto de cero
+int leadingZeros(quint32 x){
+    int n = 0;
+    if ((x & 0xFFFF0000u) == 0) { n += 16; x <<= 16; }
+    if ((x & 0xFF000000u) == 0) { n += 8;  x <<= 8; }
+    if ((x & 0xF0000000u) == 0) { n += 4;  x <<= 4; }
+    if ((x & 0xC0000000u) == 0) { n += 2;  x <<= 2; }
+    if ((x & 0x80000000u) == 0) { n += 1; }
+    return n;
+}
+
+// Ceros a la derecha de un valor de 32 bits distinto de cero
+int trailingZeros(quint32 x){
+    int n = 0;
+    if ((x & 0x0000FFFFu) == 0) { n += 16; x >>= 16; }
+    if ((x & 0x000000FFu) == 0) { n += 8;  x >>= 8; }
+    if ((x & 0x0000000Fu) == 0) { n += 4;  x >>= 4; }
+    if ((x & 0x00000003u) == 0) { n += 2;  x >>= 2; }
+    if ((x & 0x00000001u) == 0) { n += 1; }
+    return n;
+}
+
+// ZigZag: enteros con signo pequeños → enteros sin signo pequeños
+quint64 zigzag(qint64 v)   { return (quint64(v) << 1) ^ quint64(v >> 63); }
+qint64  unzigzag(quint64 v){ return qint64(v >> 1) ^ -qint64(v & 1); }
+
+}
+
+
+
+/**
+ * @param samplesPerBlock Muestras por bloque; bloques más grandes comprimen algo mejor
+ *        pero obligan a descomprimir más para acceder a un instante concreto.
+ */
+CompressedSeries::CompressedSeries(int samplesPerBlock)
+    : m_samplesPerBlock(std::max(16, samplesPerBlock))
+{
+}
+
+
+
+void CompressedSeries::append(const qint64 *tUs, const float *values, int n){
+    for (int i = 0; i < n; ++i)
+        append(tUs[i], values[i]);
+}
+
+
+
+/**
+ * Añade una muestra al bloque abierto; abre un bloque nuevo cuando el actual está lleno.
+ *
+ * @param tUs Tiempo en microsegundos.
+ * @param value Valor de la muestra.
+ */
+void CompressedSeries::append(qint64 tUs, float value){
+    if (m_blocks.empty() || m_blocks.back().summary.count >= m_samplesPerBlock) {
+        if (!m_blocks.empty())
+            m_blocks.back().bytes.shrink_to_fit();   // el bloque cerrado ya no crece
+        m_blocks.emplace_back();
+        m_blocks.back().bytes.reserve(size_t(m_samplesPerBlock) * 2);
+    }
+
+    Block &block = m_blocks.back();
+    BlockSummary &s = block.summary;
+    const quint32 bits = floatBits(value);
+
+    if (s.count == 0) {
+        // Primera muestra del bloque en bruto
+        writeBits(block, quint64(tUs), 64);
+        writeBits(block, bits, 32);
+        m_prevDelta = 0;
+        m_lead = -1;
+        s.tStart = tUs;
+        s.vMin = s.vMax = value;
+    } else {
+        encodeTime(block, tUs);
+        encodeValue(block, bits);
+        s.vMin = std::min(s.vMin, value);
+        s.vMax = std::max(s.vMax, value);
+    }
+
+    m_prevT = tUs;
+    m_prevBits = bits;
+    s.tEnd = std::max(s.tEnd, tUs);
+    s.sum += value;
+    ++s.count;
+    ++m_sampleCount;
+}
+
+
+
+void CompressedSeries::clear(){
+    m_blocks.clear();
+    m_sampleCount = 0;
+}
+
+
+
+/**
+ * @return Memoria ocupada por los datos comprimidos y los resúmenes.
+ */
+size_t CompressedSeries::memoryBytes() const {
+    size_t bytes = m_blocks.capacity() * sizeof(Block);
+    for (const Block &b : m_blocks)
+        bytes += b.bytes.capacity();
+    return bytes;
+}
+
+
+
+// Escribe los n bits menos significativos de value, empezando por el más significativo
+void CompressedSeries::writeBits(Block &block, quint64 value, int n){
+    while (n > 0) {
+        const int bitOffset = int(block.bitCount & 7);
+        if (bitOffset == 0) block.bytes.push_back(0);
+        const int space = 8 - bitOffset;
+        const int take = std::min(space, n);
+        const quint8 chunk = quint8((value >> (n - take)) & ((1u << take) - 1));
+        block.bytes.back() |= quint8(chunk << (space - take));
+        n -= take;
+        block.bitCount += take;
+    }
+}
+
+
+
+// Delta-of-delta con prefijos: 0 | 10+7 | 110+12 | 1110+20 | 1111+64 bits (ZigZag)
+void CompressedSeries::encodeTime(Block &block, qint64 tUs){
+    const qint64 delta = tUs - m_prevT;
+    const quint64 dod = zigzag(delta - m_prevDelta);
+    m_prevDelta = delta;
+
+    if (dod == 0)                 writeBits(block, 0b0, 1);
+    else if (dod < (1u << 7))   { writeBits(block, 0b10, 2);   writeBits(block, dod, 7); }
+    else if (dod < (1u << 12))  { writeBits(block, 0b110, 3);  writeBits(block, dod, 12); }
+    else if (dod < (1u << 20))  { writeBits(block, 0b1110, 4); writeBits(block, dod, 20); }
+    else                        { writeBits(block, 0b1111, 4); writeBits(block, dod, 64); }
+}
+
+
+
+// XOR con el valor anterior: 0 | 10+bits en la ventana previa | 11+ceros(5)+longitud-1(5)+bits
+void CompressedSeries::encodeValue(Block &block, quint32 bits){
+    const quint32 x = bits ^ m_prevBits;
+    if (x == 0) {
+        writeBits(block, 0b0, 1);
+        return;
+    }
+
+    const int lead = std::min(31, leadingZeros(x));
+    const int trail = trailingZeros(x);
+
+    if (m_lead >= 0 && lead >= m_lead && trail >= m_trail) {
+        writeBits(block, 0b10, 2);
+        writeBits(block, x >> m_trail, 32 - m_lead - m_trail);
+    } else {
+        const int significant = 32 - lead - trail;
+        writeBits(block, 0b11, 2);
+        writeBits(block, quint64(lead), 5);
+        writeBits(block, quint64(significant - 1), 5);
+        writeBits(block, x >> trail, significant);
+        m_lead = lead;
+        m_trail = trail;
+    }
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      BlockDecoder
+// ---------------------------------------------------------------------------
+
+CompressedSeries::BlockDecoder::BlockDecoder(const CompressedSeries &series, int block)
+    : m_bytes(series.m_blocks[block].bytes),
+    m_bitLimit(series.m_blocks[block].bitCount),
+    m_remaining(series.m_blocks[block].summary.count)
+{
+}
+
+
+
+/**
+ * Devuelve la siguiente muestra del bloque.
+ *
+ * @param tUs Tiempo decodificado en microsegundos.
+ * @param value Valor decodificado.
+ * @return false cuando no quedan muestras.
+ */
+bool CompressedSeries::BlockDecoder::next(qint64 &tUs, float &value){
+    if (m_remaining <= 0) return false;
+
+    if (m_index == 0) {
+        m_prevT = qint64(readBits(64));
+        m_prevBits = quint32(readBits(32));
+        m_prevDelta = 0;
+    } else {
+        // tiempo
+        quint64 dod = 0;
+        if (readBit()) {
+            if (!readBit())      dod = readBits(7);
+            else if (!readBit()) dod = readBits(12);
+            else if (!readBit()) dod = readBits(20);
+            else                 dod = readBits(64);
+        }
+        m_prevDelta += unzigzag(dod);
+        m_prevT += m_prevDelta;
+
+        // valor
+        if (readBit()) {
+            if (readBit()) {
+                m_lead = int(readBits(5));
+                const int significant = int(readBits(5)) + 1;
+                m_trail = 32 - m_lead - significant;
+            }
+            const int significant = 32 - m_lead - m_trail;
+            m_prevBits ^= quint32(readBits(significant) << m_trail);
+        }
+    }
+
+    tUs = m_prevT;
+    value = bitsFloat(m_prevBits);
+    ++m_index;
+    --m_remaining;
+    return true;
+}
+
+
+
+quint64 CompressedSeries::BlockDecoder::readBits(int n){
+    quint64 value = 0;
+    while (n > 0 && m_bitPos < m_bitLimit) {
+        const int bitOffset = int(m_bitPos & 7);
+        const int avail = 8 - bitOffset;
+        const int take = std::min(avail, n);
+        const quint8 byte = m_bytes[size_t(m_bitPos >> 3)];
+        const quint64 chunk = (byte >> (avail - take)) & ((1u << take) - 1);
+        value = (value << take) | chunk;
+        n -= take;
+        m_bitPos += take;
+    }
+    return value;
+}
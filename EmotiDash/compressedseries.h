@@ -0,0 +1,134 @@
+/**
+*  file CompressedSeries.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef COMPRESSEDSERIES_H
+#define COMPRESSEDSERIES_H
+
+#include <QtGlobal>
+#include <vector>
+#include <cstddef>
+
+/*!
+ * \class CompressedSeries
+ * \brief Serie temporal comprimida en memoria al estilo Gorilla (delta-of-delta + XOR de floats).
+ *
+ * Las muestras se agrupan en bloques de unos miles. Dentro de cada bloque:
+ * - el primer tiempo (µs) y el primer valor se guardan en bruto;
+ * - cada tiempo siguiente guarda la diferencia de su delta con el delta anterior, con un prefijo
+ *   de longitud variable ('0' si el periodo no cambia, lo habitual a frecuencia fija);
+ * - cada valor guarda el XOR con el anterior: '0' si se repite, o solo los bits significativos,
+ *   reutilizando la ventana de ceros iniciales/finales del valor previo cuando cabe.
+ *
+ * Cada bloque tiene un resumen (tiempos extremos, mínimo, máximo, suma y número de muestras) que
+ * permite saltar bloques enteros y dibujar vistas alejadas sin descomprimir. La descompresión se
+ * hace bloque a bloque con BlockDecoder, sin materializar la sesión completa.
+ *
+ * Un único hilo (el del controlador) escribe y lee la serie.
+ *
+ * \see SessionStore
+ * \author Enrique Fuentes
+ * \date 2025-05-22
+ */
+class CompressedSeries {
+public:
+    struct BlockSummary {
+        qint64 tStart = 0;
+        qint64 tEnd = 0;
+        float  vMin = 0.0f;
+        float  vMax = 0.0f;
+        double sum = 0.0;
+        int    count = 0;
+    };
+
+    /// Decodificador secuencial de un bloque.
+    class BlockDecoder {
+    public:
+        BlockDecoder(const CompressedSeries &series, int block);
+        bool next(qint64 &tUs, float &value);
+
+    private:
+        quint64 readBits(int n);
+        bool readBit() { return readBits(1) != 0; }
+
+        const std::vector<quint8> &m_bytes;
+        quint64 m_bitLimit;
+        quint64 m_bitPos = 0;
+        int m_remaining;
+        int m_index = 0;
+        qint64 m_prevT = 0;
+        qint64 m_prevDelta = 0;
+        quint32 m_prevBits = 0;
+        int m_lead = 0;
+        int m_trail = 0;
+    };
+
+    explicit CompressedSeries(int samplesPerBlock = 4096);
+
+    void append(qint64 tUs, float value);
+    void append(const qint64 *tUs, const float *values, int n);
+    void clear();
+
+    int blockCount() const { return int(m_blocks.size()); }
+    const BlockSummary &summary(int block) const { return m_blocks[block].summary; }
+    quint64 sampleCount() const { return m_sampleCount; }
+    size_t memoryBytes() const;
+
+    // Descomprime un bloque llamando a f(qint64 tUs, float v) por muestra
+    template <typename F>
+    void decodeBlock(int block, F &&f) const {
+        BlockDecoder dec(*this, block);
+        qint64 t; float v;
+        while (dec.next(t, v)) f(t, v);
+    }
+
+    // Recorre en streaming las muestras de [t0Us, t1Us], saltando los bloques que no lo tocan
+    template <typename F>
+    void forEachInRange(qint64 t0Us, qint64 t1Us, F &&f) const {
+        for (int b = 0; b < blockCount(); ++b) {
+            const BlockSummary &s = summary(b);
+            if (s.count == 0 || s.tEnd < t0Us) continue;
+            if (s.tStart > t1Us) break;
+            decodeBlock(b, [&](qint64 t, float v) {
+                if (t >= t0Us && t <= t1Us) f(t, v);
+            });
+        }
+    }
+
+private:
+    struct Block {
+        BlockSummary summary;
+        std::vector<quint8> bytes;
+        quint64 bitCount = 0;
+    };
+
+    void writeBits(Block &block, quint64 value, int n);
+    void encodeTime(Block &block, qint64 tUs);
+    void encodeValue(Block &block, quint32 bits);
+
+    int m_samplesPerBlock;
+    std::vector<Block> m_blocks;
+    quint64 m_sampleCount = 0;
+
+    // Estado del codificador del bloque abierto
+    qint64 m_prevT = 0;
+    qint64 m_prevDelta = 0;
+    quint32 m_prevBits = 0;
+    int m_lead = -1;     // -1: aún no hay ventana de bits significativos
+    int m_trail = 0;
+};
+
+#endif // COMPRESSEDSERIES_H
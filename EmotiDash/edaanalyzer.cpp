@@ -0,0 +1,131 @@
+/****************************************************************************
+ * EdaAnalyzer.cpp
+ *
+ * Descripción: Análisis en línea de la actividad electrodérmica a partir de
+ * la señal EA: separación tónica/fásica y detección de respuestas (SCR)
+ * con amplitud, tiempo de subida y frecuencia, con coste O(1) por muestra.
+ *
+ * Fecha: 2025-05-24
+ ****************************************************************************/
+
+#include "edaanalyzer.h"
+
+EdaAnalyzer::EdaAnalyzer()
+    : EdaAnalyzer(Settings())
+{
+}
+
+EdaAnalyzer::EdaAnalyzer(const Settings &settings)
+{
+    setSettings(settings);
+}
+
+
+
+/**
+ * Cambia los umbrales y filtros. Se reinicia el estado para no mezclar configuraciones.
+ *
+ * @param settings Nueva configuración.
+ */
+void EdaAnalyzer::setSettings(const Settings &settings){
+    m_settings = settings;
+    m_lowPass = Biquad::lowPass(settings.lowPassHz, settings.sampleHz);
+    m_tonic.setTimeConstant(settings.tonicTauSeconds, settings.sampleHz);
+    reset();
+}
+
+
+
+void EdaAnalyzer::reset(){
+    m_primed = false;
+    m_rising = false;
+    m_peakTimes.clear();
+    m_lastPublishedCount = -1;
+    m_responses = 0;
+}
+
+
+
+/**
+ * Procesa un lote de muestras EA. Los resultados anteriores se descartan.
+ *
+ * @param tUs Tiempos en microsegundos.
+ * @param values Conductancia en µS.
+ * @param n Número de muestras.
+ */
+void EdaAnalyzer::process(const qint64 *tUs, const float *values, int n){
+    m_tonicOut.clear();
+    m_phasicOut.clear();
+    m_amplitudeOut.clear();
+    m_riseOut.clear();
+    m_frequencyOut.clear();
+
+    for (int i = 0; i < n; ++i)
+        processSample(tUs[i], values[i]);
+}
+
+
+
+void EdaAnalyzer::processSample(qint64 tUs, double x){
+    if (!m_primed) {
+        // Primera muestra: filtros en régimen permanente para evitar el transitorio
+        m_lowPass.reset(x);
+        m_tonic.reset(x);
+        m_prevT = tUs;
+        m_prevY = x;
+        m_primed = true;
+        m_tonicOut.push(tUs, float(x));
+        m_phasicOut.push(tUs, 0.0f);
+        return;
+    }
+
+    const double y = m_lowPass.process(x);
+    const double dtSeconds = (tUs - m_prevT) / 1e6;
+    const double slope = dtSeconds > 0.0 ? (y - m_prevY) / dtSeconds : 0.0;
+
+    if (!m_rising) {
+        if (slope > m_settings.onsetSlope) {
+            m_rising = true;
+            m_onsetT = m_prevT;
+            m_onsetY = m_prevY;
+        } else {
+            m_tonic.process(y);     // el nivel tónico solo avanza fuera de las respuestas
+        }
+    } else if (slope <= 0.0) {
+        // Pico: se valida la respuesta
+        m_rising = false;
+        const double amplitude = m_prevY - m_onsetY;
+        const double rise = (m_prevT - m_onsetT) / 1e6;
+        if (amplitude >= m_settings.minAmplitude && rise <= m_settings.maxRiseSeconds) {
+            m_amplitudeOut.push(m_prevT, float(amplitude));
+            m_riseOut.push(m_prevT, float(rise));
+            m_peakTimes.push_back(m_prevT);
+            ++m_responses;
+        }
+    } else if ((tUs - m_onsetT) / 1e6 > m_settings.maxRiseSeconds) {
+        // Subida demasiado larga: es deriva del nivel tónico, no una respuesta
+        m_rising = false;
+        m_tonic.reset(y);
+    }
+
+    m_tonicOut.push(tUs, float(m_tonic.value()));
+    m_phasicOut.push(tUs, float(y - m_tonic.value()));
+    publishFrequency(tUs);
+
+    m_prevT = tUs;
+    m_prevY = y;
+}
+
+
+
+// SCR por minuto en la ventana; solo se publica cuando cambia
+void EdaAnalyzer::publishFrequency(qint64 tUs){
+    const qint64 windowUs = qint64(m_settings.frequencyWindowSeconds * 1e6);
+    while (!m_peakTimes.empty() && tUs - m_peakTimes.front() > windowUs)
+        m_peakTimes.pop_front();
+
+    const int count = int(m_peakTimes.size());
+    if (count == m_lastPublishedCount) return;
+    m_lastPublishedCount = count;
+    m_frequencyOut.push(tUs, float(count * 60.0 / m_settings.frequencyWindowSeconds));
+}
@@ -0,0 +1,100 @@
+/**
+*  file EdaAnalyzer.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef EDAANALYZER_H
+#define EDAANALYZER_H
+
+#include <QtGlobal>
+#include <deque>
+#include "dspfilters.h"
+#include "timeseriesstore.h"
+
+/*!
+ * \class EdaAnalyzer
+ * \brief Análisis incremental de EDA en el PC: nivel tónico/fásico y detección de SCR.
+ *
+ * Procesa la señal EA (15 Hz) muestra a muestra con coste constante:
+ * 1. Paso bajo bicuadrático para eliminar ruido de la medida.
+ * 2. Nivel tónico con un paso bajo de constante de tiempo larga que se congela mientras dura
+ *    una respuesta; el componente fásico es la diferencia entre la señal y el nivel tónico.
+ * 3. Detección de SCR por pendiente: el inicio se marca cuando la derivada supera onsetSlope y
+ *    el pico cuando vuelve a ser no positiva. La respuesta se acepta si la amplitud supera
+ *    minAmplitude y la subida no excede maxRiseSeconds.
+ *
+ * Cada llamada a process() deja los resultados en lotes con los mismos tiempos que la entrada,
+ * listos para publicarse como canales del PC: H_ET (tónico), H_EP (fásico) y, en cada SCR,
+ * H_SA (amplitud), H_SR (tiempo de subida) y H_SF (SCR por minuto en la ventana).
+ *
+ * \see EmotiBitController, OnePole, Biquad
+ * \author Enrique Fuentes
+ * \date 2025-05-24
+ */
+class EdaAnalyzer {
+public:
+    struct Settings {
+        double sampleHz          = 15.0;   // frecuencia nominal de EA
+        double lowPassHz         = 1.0;    // corte del filtro de ruido
+        double tonicTauSeconds   = 8.0;    // constante de tiempo del nivel tónico
+        double onsetSlope        = 0.02;   // µS/s para marcar el inicio de una SCR
+        double minAmplitude      = 0.03;   // µS mínimos para aceptar una SCR
+        double maxRiseSeconds    = 5.0;    // subida máxima admitida
+        double frequencyWindowSeconds = 60.0;  // ventana para SCR por minuto
+    };
+
+    EdaAnalyzer();
+    explicit EdaAnalyzer(const Settings &settings);
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+    void reset();
+
+    // Procesa un lote de muestras EA (tiempos en µs, valores en µS)
+    void process(const qint64 *tUs, const float *values, int n);
+
+    // Resultados del último process()
+    const SampleBatch &tonic() const     { return m_tonicOut; }
+    const SampleBatch &phasic() const    { return m_phasicOut; }
+    const SampleBatch &amplitude() const { return m_amplitudeOut; }
+    const SampleBatch &riseTime() const  { return m_riseOut; }
+    const SampleBatch &frequency() const { return m_frequencyOut; }
+
+    quint64 responseCount() const { return m_responses; }
+
+private:
+    void processSample(qint64 tUs, double x);
+    void publishFrequency(qint64 tUs);
+
+    Settings m_settings;
+    Biquad m_lowPass;
+    OnePole m_tonic;
+
+    bool m_primed = false;
+    qint64 m_prevT = 0;
+    double m_prevY = 0.0;
+
+    // Detección de SCR
+    bool m_rising = false;
+    qint64 m_onsetT = 0;
+    double m_onsetY = 0.0;
+    std::deque<qint64> m_peakTimes;     // picos dentro de la ventana de frecuencia
+    int m_lastPublishedCount = -1;
+    quint64 m_responses = 0;
+
+    SampleBatch m_tonicOut, m_phasicOut, m_amplitudeOut, m_riseOut, m_frequencyOut;
+};
+
+#endif // EDAANALYZER_H
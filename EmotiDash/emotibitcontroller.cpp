@@ -27,6 +27,39 @@ EmotiBitController::EmotiBitController(QObject *parent)
     // Conecta la señal de nuevos paquetes de datos
     connect(&wifiHost, &EmotiBitWiFiRoboTEA::newDataPacket,
             this, &EmotiBitController::onNewPacketReceived);
+    wifiHost.setPerfCounters(&m_perf);
+
+    // Grabación local: lotes cada 100 ms, bloques de 64 KiB, fsync cada segundo y rotación a 256 MB
+    m_recordSettings.header = "timestamp,channelID,sampleTime,value\n";
+    m_recordSettings.maxFileBytes = 256LL * 1024 * 1024;
+    m_recordFlushTimer.setInterval(100);
+    connect(&m_recordFlushTimer, &QTimer::timeout, this, &EmotiBitController::flushRecordBatch);
+    connect(&m_recorder, &RecordingWriter::backpressureChanged, this, [this](bool active) {
+        emit newMessage(active ? QString("Grabación saturada: se descartan paquetes (%1 bytes perdidos).")
+                                     .arg(m_recorder.droppedBytes())
+                               : QString("Grabación recuperada."));
+    });
+    connect(&m_recorder, &RecordingWriter::fileRotated, this, [this](const QString &filePath) {
+        emit newMessage("Grabación continúa en: " + filePath);
+    });
+    connect(&m_recorder, &RecordingWriter::writeError, this, &EmotiBitController::newMessage);
+
+    // Calidad: los segundos se cierran también sin muestras nuevas del canal
+    m_qualityTimer.setInterval(250);
+    connect(&m_qualityTimer, &QTimer::timeout, this, [this]() {
+        m_quality.closeDue();
+        publishQuality();
+    });
+    m_qualityTimer.start();
+
+    // Informe de latencia cada segundo; los histogramas vuelven a empezar tras cada informe
+    m_latencyTimer.setInterval(1000);
+    connect(&m_latencyTimer, &QTimer::timeout, this, [this]() {
+        const LatencyTracer::Report report = m_latency.report();
+        m_latency.resetHistograms();
+        emit latencyReport(report);
+    });
+    m_latencyTimer.start();
 }
 
 EmotiBitController::~EmotiBitController(){
@@ -109,19 +142,20 @@ bool EmotiBitController::startLocalRecording(const QString &filePath){
         emit newMessage("Ya grabando.");
         return false;
     }
-    m_localOutputFile.setFileName(filePath);
-    if (!m_localOutputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+
+    RecordingWriter::Settings settings = m_recordSettings;
+    settings.filePath = filePath;
+    if (!m_recorder.start(settings)) {
         emit newMessage("Error al abrir archivo.");
         return false;
     }
 
-    m_localOutputStream.setDevice(&m_localOutputFile);
+    m_recordBatch.clear();
+    m_recordFlushTimer.start();
     m_isRecordingLocally = true;
     sendNota("INICIA_GRABACION");
 
     emit newMessage("Grabación iniciada: " + filePath);
-
-    m_localOutputStream << "timestamp,channelID,sampleTime,value\n";
     return true;
 }
 
@@ -146,15 +180,42 @@ bool EmotiBitController::stopLocalRecording(){
         return false;
     }
 
-    if (m_localOutputFile.isOpen()) {
-        m_localOutputStream.flush();
-        m_localOutputFile.close();
-    }
+    m_recordFlushTimer.stop();
+    flushRecordBatch();
+    m_recorder.stop();   // vacía la cola, escribe el último bloque y hace fsync
     m_isRecordingLocally = false;
-    emit newMessage("Grabación detenida.");
+
+    if (m_recorder.droppedBytes() > 0)
+        emit newMessage(QString("Grabación detenida con %1 bytes descartados.").arg(m_recorder.droppedBytes()));
+    else
+        emit newMessage("Grabación detenida.");
     return true;
 }
 
+
+
+/**
+ * Cambia la configuración de la grabación local (tamaño de bloque, cadencia de fsync,
+ * rotación, memoria máxima). Se aplica en la siguiente grabación.
+ *
+ * @param settings Nueva configuración; filePath se ignora.
+ */
+void EmotiBitController::setRecordingSettings(const RecordingWriter::Settings &settings){
+    m_recordSettings = settings;
+}
+
+
+
+/**
+ * Entrega al escritor asíncrono los paquetes acumulados desde la última entrega.
+ */
+void EmotiBitController::flushRecordBatch(){
+    if (m_recordBatch.isEmpty()) return;
+    m_recorder.submit(std::move(m_recordBatch));
+    m_recordBatch = QByteArray();
+    PerfCounters::set(m_perf.recorderQueuedBytes, m_recorder.queuedBytes());
+}
+
 // -------------------------------------------------------------------
 //      Grabación local en SD EmotiBit
 // ------------------------------------------------------------------
@@ -196,9 +257,12 @@ bool EmotiBitController::stopRecordingOnSD(){
  * Procesa un paquete de datos recibido y realiza las acciones correspondientes.
  *
  * @param packet El paquete de datos recibido.
+ * @param rxNs Instante de llegada del datagrama (LatencyTracer::nowNs()).
+ * @param decodeNs Instante en que el hilo de datos separó el paquete.
  */
-void EmotiBitController::onNewPacketReceived(const QString &packet)
+void EmotiBitController::onNewPacketReceived(const QString &packet, qint64 rxNs, qint64 decodeNs)
 {
+    PerfCounters::bump(m_perf.handled);
     QString trimmedPacket = packet.trimmed();
     if (trimmedPacket.isEmpty()) {
         emit newMessage("Paquete vacío.");
@@ -210,10 +274,14 @@ void EmotiBitController::onNewPacketReceived(const QString &packet)
         emit newMessage("Paquete con formato incorrecto.");
         return;
     }
+    m_latency.packetReceived(rxNs, decodeNs, fields[0].toLongLong());
 
-    // Graba localmente si está en modo grabación
-    if (m_isRecordingLocally && m_localOutputFile.isOpen()) {
-        m_localOutputStream << packet << "\n";
+    // Graba localmente si está en modo grabación: se acumula y se entrega por lotes
+    if (m_isRecordingLocally) {
+        m_recordBatch += packet.toUtf8();
+        m_recordBatch += '\n';
+        if (m_recordBatch.size() >= 32 * 1024)
+            flushRecordBatch();
     }
 
     QString channelID = fields[3];
@@ -232,6 +300,12 @@ void EmotiBitController::onNewPacketReceived(const QString &packet)
         return;
     }
 
+    if (channelID == "DC" || channelID == "DO") {
+        processDataEvents(fields, channelID == "DC");
+        emit newMessage(packet);
+        return;
+    }
+
     // Muestra paquete si no es relevante para el gráfico
     if (!channelFrequencies.contains(channelID) || channelID == "UN") {
         emit newMessage(packet);
@@ -241,8 +315,8 @@ void EmotiBitController::onNewPacketReceived(const QString &packet)
     // Procesa datos de sensores
     qint64 timestamp = fields[0].toLongLong();
     QStringList dataFields = fields.mid(6);
-    double frequency = channelFrequencies.getFrequency(channelID);
-    double dt = 1.0 / frequency;
+    // Intervalo entre muestras según la frecuencia real estimada (no la nominal fija)
+    double dt = rateEstimator(channelID).update(timestamp, numSamples);
 
     // Control de timestamp inicial
     if (!firstTimestampFound) {
@@ -300,13 +374,74 @@ void EmotiBitController::processBatteryPacket(const QStringList &fields)
 }
 
 /**
- * Procesa los datos de los sensores y emite los valores.
+ * Procesa un paquete DC (saturación) o DO (desbordamiento). La carga útil es una lista de
+ * canales, cada uno seguido opcionalmente del número de muestras afectadas.
+ *
+ * @param fields El conjunto de campos del paquete.
+ * @param clipping true para DC, false para DO.
+ */
+void EmotiBitController::processDataEvents(const QStringList &fields, bool clipping)
+{
+    for (int i = 6; i < fields.size(); ++i) {
+        const QString &channel = fields[i];
+        int count = 1;
+        bool ok = false;
+        if (i + 1 < fields.size()) {
+            const int n = fields[i + 1].toInt(&ok);
+            if (ok) { count = n; ++i; }
+        }
+        if (clipping)
+            m_quality.addClipEvent(channel, count);
+        else
+            m_quality.addOverflowEvent(channel, count);
+    }
+}
+
+/**
+ * Emite los informes de calidad de los segundos cerrados y, si se está grabando,
+ * los añade a la grabación como líneas QS: timestamp,0,2,QS,1,100,canal,puntuación.
+ */
+void EmotiBitController::publishQuality()
+{
+    const QVector<SignalQuality::Report> reports = m_quality.takeReports();
+    for (const SignalQuality::Report &r : reports) {
+        emit signalQualityUpdated(r.channelID, r.score);
+        if (m_isRecordingLocally) {
+            const qint64 deviceTs = initialTimestamp + r.tUs / 1000;
+            m_recordBatch += QString("%1,0,2,QS,1,100,%2,%3\n")
+                                 .arg(deviceTs).arg(r.channelID).arg(r.score, 0, 'f', 0).toUtf8();
+        }
+    }
+}
+
+/**
+ * Devuelve el estimador de frecuencia del canal, creándolo la primera vez con la
+ * frecuencia nominal de ChannelFrequencies.
+ *
+ * @param channelID El ID del canal de datos.
+ * @return Estimador del canal.
+ */
+RateEstimator &EmotiBitController::rateEstimator(const QString &channelID){
+    auto it = m_rates.find(channelID);
+    if (it == m_rates.end())
+        it = m_rates.insert(channelID, RateEstimator(channelFrequencies.getFrequency(channelID),
+                                                     channelFrequencies.isEventChannel(channelID)));
+    return it.value();
+}
+
+/**
+ * Procesa los datos de los sensores y los añade como un único lote al almacén de series
+ * (ventana reciente) y a la sesión comprimida (historia completa).
+ * Los tiempos se guardan en microsegundos relativos al primer paquete recibido.
+ *
+ * La calidad se evalúa sobre la señal en bruto; el resto de consumidores (almacén, sesión,
+ * espectro y analíticas) reciben el lote ya pasado por la cadena de acondicionamiento del canal.
  *
  * @param channelID El ID del canal de datos.
  * @param timestamp El timestamp del paquete.
  * @param dataFields Los datos del paquete.
  * @param numSamples El número de muestras en el paquete.
- * @param dt El intervalo de tiempo entre muestras.
+ * @param dt El intervalo de tiempo entre muestras (estimado por RateEstimator).
  */
 void EmotiBitController::processSensorData(const QString &channelID, qint64 timestamp, const QStringList &dataFields, int numSamples, double dt){
     if (dataFields.size() < numSamples) {
@@ -314,18 +449,240 @@ void EmotiBitController::processSensorData(const QString &channelID, qint64 time
         return;
     }
 
-    double relativeTime = (timestamp - initialTimestamp) / 1000.0;
+    const qint64 relativeTimeUs = (timestamp - initialTimestamp) * 1000;
 
+    m_batch.clear();
     for (int i = 0; i < numSamples; ++i) {
         bool ok;
         double value = dataFields[i].toDouble(&ok);
         if (ok) {
-            double sampleTime = relativeTime - (numSamples - 1 - i) * dt;
-            emit sensorDataReceived(channelID, sampleTime, value);
+            qint64 sampleTimeUs = relativeTimeUs - qRound64((numSamples - 1 - i) * dt * 1e6);
+            m_batch.push(sampleTimeUs, float(value));
         } else {
             emit newMessage(QString("Dato inválido en índice %1").arg(i));
         }
     }
+
+    // Los canales de eventos (HR, BI, SCR...) pueden pasar segundos sin datos: no se puntúan
+    if (!channelFrequencies.isEventChannel(channelID)) {
+        m_quality.addSamples(channelID, m_batch.t.data(), m_batch.v.data(), m_batch.size());
+        publishQuality();
+    }
+
+    m_pipeline.process(channelID, m_batch);
+    const int decimation = m_pipeline.decimation(channelID);
+    if (decimation != m_decimation.value(channelID, 1))
+        applyChannelRate(channelID, decimation);
+    if (m_batch.isEmpty()) return;   // p. ej. un diezmado que aún no ha completado su grupo
+
+    const qint64 *t = m_batch.t.data();
+    const float *v = m_batch.v.data();
+    const int n = m_batch.size();
+
+    ChannelRing *ring = m_store.channel(channelID, channelFrequencies.getFrequency(channelID));
+    ring->append(t, v, n);
+    m_latency.samplesStored(channelID, ring->epoch());
+    PerfCounters::bump(m_perf.samples, quint64(n));
+    m_session.append(channelID, t, v, n);
+    m_stats.add(channelID, t, v, n);
+
+    if (!channelFrequencies.isEventChannel(channelID))
+        spectrumFor(channelID).push(v, n);
+
+    feedAligned(channelID, t, v, n);
+
+    // Analíticas en el PC: se actualizan con cada muestra, sin esperar a los canales calculados del dispositivo
+    if (channelID == "EA") {
+        m_eda.process(t, v, n);
+        publishDerived("H_ET", 15.0, m_eda.tonic());
+        publishDerived("H_EP", 15.0, m_eda.phasic());
+        publishDerived("H_SA", 1.0, m_eda.amplitude());
+        publishDerived("H_SR", 1.0, m_eda.riseTime());
+        publishDerived("H_SF", 1.0, m_eda.frequency());
+    } else if (channelID == m_ppg.settings().sourceChannel) {
+        m_ppg.process(t, v, n);
+        publishDerived("H_HR", 1.0, m_ppg.heartRate());
+        publishDerived("H_BI", 1.0, m_ppg.interBeat());
+        publishDerived("H_RMSSD", 1.0, m_ppg.rmssd());
+        publishDerived("H_SDNN", 1.0, m_ppg.sdnn());
+        publishDerived("H_PNN50", 1.0, m_ppg.pnn50());
+        m_hrvSpectrum.addBeats(m_ppg.interBeat());
+        publishDerived("H_LF", 1.0, m_hrvSpectrum.lf());
+        publishDerived("H_HF", 1.0, m_hrvSpectrum.hf());
+        publishDerived("H_LFHF", 1.0, m_hrvSpectrum.ratio());
+    } else if (ImuEngine::isImuChannel(channelID)) {
+        m_imu.addSamples(channelID, t, v, n);
+        publishDerived("H_ROLL", 25.0, m_imu.roll());
+        publishDerived("H_PITCH", 25.0, m_imu.pitch());
+        publishDerived("H_YAW", 25.0, m_imu.yaw());
+        publishDerived("H_ACT", 25.0, m_imu.activity());
+        publishDerived("H_STEP", 1.0, m_imu.steps());
+        publishDerived("H_FIDG", 1.0, m_imu.fidgets());
+        publishDerived("H_STILL", 1.0, m_imu.stillness());
+    }
+}
+
+
+
+/**
+ * Cambia la cadena de acondicionamiento de un canal de sensor. Puede llamarse con la captura
+ * en marcha: la cadena nueva se instala al comienzo del siguiente paquete del canal.
+ *
+ * @param channelID El ID del canal de datos.
+ * @param spec Etapas separadas por ';' (ver StreamPipeline); vacío para quitar el procesado.
+ * @param error Mensaje de error opcional.
+ * @return false si la descripción no es válida (se mantiene la cadena anterior).
+ */
+bool EmotiBitController::setChannelPipeline(const QString &channelID, const QString &spec, QString *error){
+    const double hz = channelFrequencies.getFrequency(channelID);
+    if (!m_pipeline.configure(channelID, spec, hz, error))
+        return false;
+    emit newMessage(spec.trimmed().isEmpty()
+                        ? QString("Canal %1 sin acondicionamiento").arg(channelID)
+                        : QString("Canal %1: %2").arg(channelID, spec));
+    return true;
+}
+
+/**
+ * Devuelve el estimador espectral del canal, creándolo la primera vez con segmentos
+ * de unos 10 s (potencia de dos), 50 % de solape y media de 8 periodogramas.
+ *
+ * @param channelID El ID del canal de datos.
+ * @return Estimador del canal.
+ */
+WelchPsd &EmotiBitController::spectrumFor(const QString &channelID){
+    auto it = m_spectra.find(channelID);
+    if (it == m_spectra.end()) {
+        const double hz = effectiveHz(channelID);
+        int segment = 16;
+        while (segment < hz * 10.0) segment <<= 1;
+        it = m_spectra.insert(channelID, std::make_shared<WelchPsd>(segment, segment / 2, 8, hz));
+    }
+    return *it.value();
+}
+
+/**
+ * @param channelID El ID del canal de datos.
+ * @return Frecuencia nominal del canal dividida por el diezmado de su cadena.
+ */
+double EmotiBitController::effectiveHz(const QString &channelID) const {
+    return m_pipeline.outputHz(channelID, channelFrequencies.getFrequency(channelID));
+}
+
+/**
+ * @return Frecuencia de trabajo del motor IMU: la del eje de acelerómetro o giroscopio más
+ * lento, para que el emparejamiento por tiempo encuentre una muestra de cada eje.
+ */
+double EmotiBitController::imuHz() const {
+    double hz = 0.0;
+    for (const char *c : { "AX", "AY", "AZ", "GX", "GY", "GZ" }) {
+        const double h = effectiveHz(c);
+        if (h > 0.0 && (hz == 0.0 || h < hz)) hz = h;
+    }
+    return hz > 0.0 ? hz : m_imu.settings().sampleHz;
+}
+
+/**
+ * Ajusta a la nueva frecuencia del canal la PSD (se crea de nuevo), el analizador que lo usa
+ * como entrada (se reinicia) y su columna de la tabla alineada.
+ *
+ * @param channelID El ID del canal de datos.
+ * @param decimation Factor de diezmado de la cadena recién instalada.
+ */
+void EmotiBitController::applyChannelRate(const QString &channelID, int decimation){
+    m_decimation.insert(channelID, decimation);
+    m_spectra.remove(channelID);
+    const double hz = effectiveHz(channelID);
+
+    if (channelID == "EA") {
+        setEdaSettings(m_eda.settings());
+    } else if (channelID == m_ppg.settings().sourceChannel) {
+        setPpgSettings(m_ppg.settings());
+    } else if (ImuEngine::isImuChannel(channelID)) {
+        setImuSettings(m_imu.settings());
+    }
+    m_aligner.setInputHz(channelID, hz);
+}
+
+/**
+ * Las frecuencias de muestreo de los analizadores se toman siempre de la cadena de su canal.
+ */
+void EmotiBitController::setEdaSettings(const EdaAnalyzer::Settings &settings){
+    EdaAnalyzer::Settings s = settings;
+    s.sampleHz = effectiveHz("EA");
+    m_eda.setSettings(s);
+}
+
+void EmotiBitController::setPpgSettings(const PpgBeatDetector::Settings &settings){
+    PpgBeatDetector::Settings s = settings;
+    s.sampleHz = effectiveHz(s.sourceChannel);
+    m_ppg.setSettings(s);
+}
+
+void EmotiBitController::setImuSettings(const ImuEngine::Settings &settings){
+    ImuEngine::Settings s = settings;
+    s.sampleHz = imuHz();
+    m_imu.setSettings(s);
+}
+
+/**
+ * @param channelID El ID del canal de datos.
+ * @return PSD de Welch del canal, o nullptr si aún no se han recibido muestras.
+ */
+const WelchPsd *EmotiBitController::spectrum(const QString &channelID) const {
+    auto it = m_spectra.constFind(channelID);
+    return it != m_spectra.constEnd() ? it.value().get() : nullptr;
+}
+
+/**
+ * Publica un lote de un canal calculado en el PC en el almacén de series y en la sesión,
+ * de forma que la interfaz lo lee igual que un canal recibido del dispositivo.
+ *
+ * @param channelID El ID del canal calculado (prefijo H_).
+ * @param nominalHz Frecuencia nominal, usada para dimensionar el anillo.
+ * @param batch Muestras a publicar.
+ */
+void EmotiBitController::publishDerived(const QString &channelID, double nominalHz, const SampleBatch &batch){
+    if (batch.isEmpty()) return;
+    ChannelRing *ring = m_store.channel(channelID, nominalHz);
+    ring->append(batch.t.data(), batch.v.data(), batch.size());
+    m_latency.samplesStored(channelID, ring->epoch());
+    m_session.append(channelID, batch.t.data(), batch.v.data(), batch.size());
+    m_stats.add(channelID, batch.t.data(), batch.v.data(), batch.size());
+    feedAligned(channelID, batch.t.data(), batch.v.data(), batch.size());
+}
+
+
+
+/**
+ * Configura la tabla alineada. Los canales del dispositivo de frecuencia fija se interpolan
+ * linealmente; los de eventos y los calculados en el PC (H_...) mantienen su último valor.
+ *
+ * @param channels Columnas de la tabla, en orden; vacía para desactivarla.
+ * @param outputHz Frecuencia de las tramas.
+ * @param maxLatencySeconds Retraso máximo de una trama respecto al canal más adelantado.
+ */
+void EmotiBitController::setAlignedOutput(const QStringList &channels, double outputHz, double maxLatencySeconds){
+    MultiRateResampler::Settings settings;
+    settings.outputHz = outputHz;
+    settings.maxLatencySeconds = maxLatencySeconds;
+    m_aligner = MultiRateResampler(settings);
+
+    for (const QString &id : channels) {
+        const bool continuous = channelFrequencies.contains(id) && !channelFrequencies.isEventChannel(id);
+        m_aligner.addChannel(id, effectiveHz(id),
+                             continuous ? MultiRateResampler::Mode::Linear : MultiRateResampler::Mode::Hold);
+    }
+    m_alignEnabled = !channels.isEmpty();
+}
+
+
+
+void EmotiBitController::feedAligned(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    if (!m_alignEnabled || !m_aligner.hasChannel(channelID)) return;
+    m_aligner.addSamples(channelID, tUs, values, n);
+    if (m_aligner.frames().frameCount() > 0)
+        emit alignedFramesReady(m_aligner.frames());
 }
 
 /**
@@ -338,11 +695,24 @@ void EmotiBitController::sendNota(QString nota){
 }
 
 /**
- * Reinicia el tiempo de la grabación.
+ * Reinicia el tiempo de la grabación y vacía las series almacenadas.
  */
 void EmotiBitController::reiniciarTiempo(){
     initialTimestamp = 0;
     firstTimestampFound = false;
+    m_store.clear();
+    m_session.clear();
+    m_stats.clear();
+    m_rates.clear();
+    m_eda.reset();
+    m_ppg.reset();
+    m_imu.reset();
+    m_quality.reset();
+    m_spectra.clear();
+    m_hrvSpectrum.reset();
+    m_pipeline.reset();
+    m_aligner.reset();
+    m_latency.clear();
 }
 
 
@@ -34,6 +34,22 @@
 #include<channelfrequencies.h>
 #include<QEmotiBitPacket.h>
 #include "EmotiBitWiFiRoboTEA.h"
+#include "timeseriesstore.h"
+#include "recordingwriter.h"
+#include "sessionstore.h"
+#include "rateestimator.h"
+#include "edaanalyzer.h"
+#include "ppgbeatdetector.h"
+#include "imuengine.h"
+#include "signalquality.h"
+#include "welchpsd.h"
+#include "hrvspectrum.h"
+#include "streampipeline.h"
+#include "multirateresampler.h"
+#include "windowedstats.h"
+#include "latencytracer.h"
+#include "perfcounters.h"
+#include <memory>
 
 
 /**
@@ -77,8 +93,52 @@ public:
     bool startLocalRecording(const QString &filePath);
     bool stopLocalRecording();
     bool startLocalRecording();
+    void setRecordingSettings(const RecordingWriter::Settings &settings);
+    const RecordingWriter &recorder() const { return m_recorder; }
     void reiniciarTiempo( );
 
+    // Almacén de series por canal; la interfaz y las analíticas lo leen por referencia
+    const TimeSeriesStore &store() const { return m_store; }
+
+    // Mínimo, máximo, media y desviación de la ventana reciente de cada canal
+    const ChannelStats &stats() const { return m_stats; }
+    void setStatsWindow(double seconds) { m_stats.setWindowSeconds(seconds); }
+
+    // Sesión completa comprimida en memoria (para desplazarse por toda la sesión)
+    const SessionStore &session() const { return m_session; }
+
+    // Umbrales del análisis de EDA calculado en el PC (canales H_ET, H_EP, H_SA, H_SR, H_SF)
+    void setEdaSettings(const EdaAnalyzer::Settings &settings);
+    const EdaAnalyzer::Settings &edaSettings() const { return m_eda.settings(); }
+
+    // Detector de latidos del PC (canales H_HR, H_BI, H_RMSSD, H_SDNN, H_PNN50)
+    void setPpgSettings(const PpgBeatDetector::Settings &settings);
+    const PpgBeatDetector::Settings &ppgSettings() const { return m_ppg.settings(); }
+
+    // Orientación y actividad del PC (canales H_ROLL, H_PITCH, H_YAW, H_ACT, H_STEP, H_FIDG, H_STILL)
+    void setImuSettings(const ImuEngine::Settings &settings);
+    const ImuEngine::Settings &imuSettings() const { return m_imu.settings(); }
+
+    // PSD de Welch de un canal de sensor; nullptr si aún no hay muestras del canal
+    const WelchPsd *spectrum(const QString &channelID) const;
+
+    // Cadena de acondicionamiento del canal, p. ej. "lowpass:5;decimate:2" (vacía = sin procesado).
+    // Se aplica desde el siguiente paquete, sin detener la captura; con diezmado, la PSD, las
+    // analíticas y el alineado pasan a la frecuencia de salida de la cadena.
+    bool setChannelPipeline(const QString &channelID, const QString &spec, QString *error = nullptr);
+    QString channelPipeline(const QString &channelID) const { return m_pipeline.describe(channelID); }
+
+    // Tramas alineadas de varios canales a outputHz (lista vacía = desactivado); se entregan con alignedFramesReady
+    void setAlignedOutput(const QStringList &channels, double outputHz, double maxLatencySeconds = 2.0);
+    QStringList alignedChannels() const { return m_alignEnabled ? m_aligner.channels() : QStringList(); }
+
+    // Latencia por etapas desde el datagrama hasta la pantalla; las gráficas cierran las sondas
+    LatencyTracer &latency() { return m_latency; }
+    void setLatencySlo(double endToEndMs) { m_latency.setSlo(endToEndMs); }
+
+    // Contadores sin bloqueos para el panel de rendimiento (las gráficas añaden los suyos)
+    PerfCounters &perfCounters() { return m_perf; }
+
 signals:
     // Emite un mensaje genérico (por ejemplo, texto para mostrar en la interfaz).
     void newMessage(const QString &message);
@@ -88,8 +148,14 @@ signals:
     void batteryLevelUpdated(int batteryLevel);
     void deviceModeUpdated(const QString &mode);
 
-    // Señal con datos de sensores (para graficar)
-    void sensorDataReceived(const QString &channelID, double sampleTime, double value);
+    // Calidad de un canal en el último segundo (0..100)
+    void signalQualityUpdated(const QString &channelID, float score);
+
+    // Nuevas tramas completas de la tabla alineada (una fila por instante, una columna por canal)
+    void alignedFramesReady(const AlignedFrames &frames);
+
+    // Percentiles de latencia del último segundo y cumplimiento del objetivo
+    void latencyReport(const LatencyTracer::Report &report);
 
     // (Opcional) señal cuando se descubren dispositivos
     void devicesDiscovered(const QStringList &deviceIds);
@@ -102,7 +168,10 @@ signals:
 
 private slots:
     // Slot que recibe paquetes en bruto desde wifiHost.
-    void onNewPacketReceived(const QString &packet);
+    void onNewPacketReceived(const QString &packet, qint64 rxNs, qint64 decodeNs);
+
+    // Entrega al escritor el lote de paquetes acumulado
+    void flushRecordBatch();
 
 private:
     // Procesa la parte de estado del dispositivo (EM,...).
@@ -111,10 +180,35 @@ private:
     // Procesa datos de batería u otros especiales.
     void processBatteryPacket(const QStringList &fields);
 
-    // Procesa los datos de sensor y emite la señal sensorDataReceived(...) por cada muestra.
+    // Estimador de frecuencia real del canal (se crea con la frecuencia nominal)
+    RateEstimator &rateEstimator(const QString &channelID);
+
+    // Procesa los datos de sensor y los añade como un lote al almacén de series.
     void processSensorData(const QString &channelID, qint64 timestamp,
                            const QStringList &dataFields, int numSamples, double dt);
 
+    // Procesa los avisos de saturación (DC) y desbordamiento (DO) del dispositivo.
+    void processDataEvents(const QStringList &fields, bool clipping);
+
+    // Emite y graba los informes de calidad de los segundos cerrados
+    void publishQuality();
+
+    // Estimador espectral del canal (segmentos de unos 10 s con 50 % de solape)
+    WelchPsd &spectrumFor(const QString &channelID);
+
+    // Frecuencia del canal a la salida de su cadena de acondicionamiento
+    double effectiveHz(const QString &channelID) const;
+    double imuHz() const;
+
+    // Rehace los consumidores del canal cuando su cadena cambia el factor de diezmado
+    void applyChannelRate(const QString &channelID, int decimation);
+
+    // Publica un canal calculado en el PC igual que un canal del dispositivo
+    void publishDerived(const QString &channelID, double nominalHz, const SampleBatch &batch);
+
+    // Entrega un lote al remuestreador y emite las tramas que se completen
+    void feedAligned(const QString &channelID, const qint64 *tUs, const float *values, int n);
+
 
 
 private:
@@ -124,9 +218,31 @@ private:
 
     //control grabacion
     bool m_isRecordingLocally = false;
-    QFile m_localOutputFile;
-    QTextStream m_localOutputStream;
-
+    RecordingWriter m_recorder;                 // escribe en disco desde su propio hilo
+    RecordingWriter::Settings m_recordSettings;
+    QByteArray m_recordBatch;                   // paquetes pendientes de entregar al escritor
+    QTimer m_recordFlushTimer;
+
+    // Series por canal (único escritor: este controlador)
+    TimeSeriesStore m_store;
+    SessionStore m_session;
+    ChannelStats m_stats;                    // estadísticas de ventana por canal
+    QHash<QString, RateEstimator> m_rates;   // frecuencia real estimada por canal
+    EdaAnalyzer m_eda;                       // SCR y nivel tónico calculados a partir de EA
+    PpgBeatDetector m_ppg;                   // latidos y HRV calculados a partir de PPG
+    ImuEngine m_imu;                         // orientación y actividad a partir de AX..MZ
+    SignalQuality m_quality;                 // calidad por canal y segundo
+    QTimer m_qualityTimer;                   // cierra los segundos de los canales que dejan de llegar
+    QHash<QString, std::shared_ptr<WelchPsd>> m_spectra;  // PSD por canal de sensor
+    HrvSpectrum m_hrvSpectrum;               // LF/HF a partir de los IBI del detector de latidos
+    StreamPipeline m_pipeline;               // acondicionamiento configurable por canal
+    QHash<QString, int> m_decimation;        // diezmado con el que están configurados los consumidores
+    MultiRateResampler m_aligner;            // tabla alineada de los canales elegidos
+    bool m_alignEnabled = false;
+    SampleBatch m_batch;                     // lote reutilizado para cada paquete
+    LatencyTracer m_latency;                 // latencia del datagrama a la pantalla
+    QTimer m_latencyTimer;
+    PerfCounters m_perf;                     // contadores de red, controlador y gráficas
 };
 
 #endif // EMOTIBITCONTROLLER_H
@@ -1,5 +1,6 @@
 #include "EmotiBitWiFiRoboTEA.h"
 #include "qemotibitpacket.h"
+#include "latencytracer.h"
 #include <QString>
 #include <QVector>
 #include <QDebug>
@@ -990,10 +991,14 @@ void EmotiBitWiFiRoboTEA::threadSleepFor(int sleepMicros){
  * separa los paquetes utilizando el delimitador CSV definido y analiza su cabecera.
  * Si el paquete contiene una solicitud de datos (`REQUEST_DATA`), se procesa mediante `processRequestData()`.
  * También se encarga de evitar duplicados y sincronizar el puerto de envío si es necesario.
+ * El envío múltiple del firmware repite el datagrama entero, así que al encontrar un número
+ * de paquete repetido se descarta el resto del datagrama, no solo ese paquete.
  *
  * @note Usa `dataCxnMutex` para proteger el acceso al socket UDP.
  */
 void EmotiBitWiFiRoboTEA::updateData() {
+    if (resetPacketNumber.exchange(false))
+        hasPacketNumber = false;   // la numeración de paquetes vuelve a empezar con el nuevo dispositivo
     while (dataCxn->hasPendingDatagrams()) {
         QByteArray message;
         QHostAddress remoteAddress;
@@ -1003,6 +1008,8 @@ void EmotiBitWiFiRoboTEA::updateData() {
 
         //dataCxn->readDatagram(message.data(), message.size());  //:::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
         dataCxn->readDatagram(message.data(), message.size(), &remoteAddress, &remotePort);
+        const qint64 rxNs = LatencyTracer::nowNs();   // llegada del datagrama (reloj monotónico)
+        if (perfCounters) PerfCounters::bump(perfCounters->datagrams);
 
         dataCxnMutex.unlock();
 
@@ -1064,20 +1071,29 @@ void EmotiBitWiFiRoboTEA::updateData() {
                                     dataCxnMutex.unlock();
                                 }
                                 if (header.packetNumber == receivedDataPacketNumber)    {
-                                    // Saltar paquetes duplicados
+                                    // Saltar paquetes duplicados: el envío múltiple repite el datagrama entero
+                                    if (perfCounters) PerfCounters::bump(perfCounters->duplicates);
+                                    break;
                                 }
                                 else {
                                     // Actualizar el número de paquete recibido para rastrear futuros duplicados
                                     receivedDataPacketNumber = header.packetNumber;
                                 }
                             }
+                            // Huecos en la numeración = paquetes perdidos por el camino
+                            if (hasPacketNumber && perfCounters) {
+                                const quint16 gap = quint16(header.packetNumber - lastPacketNumber - 1);
+                                if (gap != 0 && gap < 0x8000) PerfCounters::bump(perfCounters->dropped, gap);
+                            }
+                            lastPacketNumber = header.packetNumber;
+                            hasPacketNumber = true;
                             //qDebug() << "TIPETAG_HEADER_____________"<<header.typeTag;
                             if (header.typeTag.compare(qEmotiBitPacket::TypeTag::REQUEST_DATA) == 0)   {  // Process data requests
                                 processRequestData(packet, dataStartChar);
                                 //qDebug()  << "Se ha rearizado una___SOLICITUD DE DATOS_____";
                             }
-                            dataPackets.push_back(packet);
-                            emit newDataPacket(packet);
+                            if (perfCounters) PerfCounters::bump(perfCounters->packets);
+                            emit newDataPacket(packet, rxNs, LatencyTracer::nowNs());
                         }
                     }
                 }
@@ -1265,27 +1281,6 @@ quint8 EmotiBitWiFiRoboTEA::sendControl(const QString &packet) {
 
 
 
-/*
- * @brief Convierte y devuelve los paquetes almacenados como std::string.
- * @param packets Vector donde se almacenarán los paquetes convertidos.
- */
-void EmotiBitWiFiRoboTEA::readData(std::vector<std::string> &packets) {
-    //_________________________________________________________________________________
-    // MArgen de mejora, comencé utilizando  el tipo std::string pero para aprobechar...
-    //...las ventajas de Qt terminé utilizando QStrin para muchas variables...
-    //...deberia intentar dejar de utilizar std::string en todo el codigo y ahorrar en conversiones
-    //---------------------------------------------------------------------------------
-    std::vector<QString> temp;   //
-    dataPackets.get(temp); // Obtén los datos como QString
-
-    packets.clear(); // Limpia el vector de salida
-    packets.reserve(temp.size());
-    for (const auto &qstr : temp) {
-        packets.push_back(qstr.toStdString()); // Convierte QString a std::string //_______________________Esto deberia simplificarlo
-    }
-}
-
-
 //_____________________________________________________________________________
 //_____________________________________________________________________________
 // Método para obtener una copia de los EmotiBits descubiertos de manera segura
@@ -1339,6 +1334,7 @@ qint8 EmotiBitWiFiRoboTEA::connect(const QString &deviceId){
             connectedEmotibitIp = ip.toStdString();
             connectedEmotibitIdentifier = deviceId;
             isStartingConnection = true;
+            resetPacketNumber = true;   // el hilo de datos reinicia la numeración de paquetes
             startCxnAbortTimer = QDateTime::currentMSecsSinceEpoch();
             //qDebug() << "Iniciando conexión con EmotiBit:" << deviceId << "IP:" << ip;
 
@@ -81,6 +81,7 @@ entorno Qt, extendiendo su funcionalidad y reorganizando su estructura.
 
 
 #include "DoubleBuffer.h" // Incluye la definición de DoubleBuffer
+#include "perfcounters.h"
 #include <unordered_map>
 #include <QObject>
 
@@ -143,8 +144,6 @@ public:
 
     QString connectedEmotibitIdentifier;
 
-    DoubleBuffer<QString> dataPackets;
-
     bool _isConnected;
     bool isStartingConnection;
     quint16 startCxnTimeout = 5000;	// milliseconds
@@ -206,6 +205,13 @@ public:
     atomic_bool stopAdvertisingThread = { false };
 
     quint16 receivedDataPacketNumber = 60000;	// Tracks packet numbers (for multi-send). inicializa con un numero arbitrario largo
+    quint16 lastPacketNumber = 0;               // último número de paquete aceptado, para contar huecos
+    bool hasPacketNumber = false;               // solo lo usa el hilo de datos
+    atomic_bool resetPacketNumber = { false };  // connect() pide reiniciar la numeración; lo atiende el hilo de datos
+
+    // Contadores de datagramas, duplicados y pérdidas (se escriben desde el hilo de datos)
+    void setPerfCounters(PerfCounters *counters) { perfCounters = counters; }
+    PerfCounters *perfCounters = nullptr;
 
     void updateDataThread();
     void processAdvertisingThread();
@@ -219,7 +225,6 @@ public:
 
     quint8 sendControl(const QString &packet);
     quint8 sendData(const QString &packet);
-    void readData(vector<string> &packets);
 
     qint8 connect(const QString &deviceId);
     //qint8 connect(qint8 i);          //esta declarado pero no esta desarrollado en el cpp
@@ -229,7 +234,7 @@ public slots:
     void writeControlData(const QByteArray &data, const QString &expectedClientIp);
     //void  sendToControlPort(const QString &data);
 signals:
-    void newDataPacket(const QString &packet); // Señal para los paquetes nuevos.
+    void newDataPacket(const QString &packet, qint64 rxNs, qint64 decodeNs); // Señal para los paquetes nuevos (con instantes de llegada y decodificación).
     void sendDatagram(const QByteArray &data, const QHostAddress &address, quint16 port, QString socketType);
     void processIncomingData(const QByteArray &data, const QHostAddress &address, quint16 port, QString socketType);
     void controlDataToSend(const QByteArray &data, const QString &expectedClientIp);
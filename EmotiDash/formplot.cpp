@@ -1,10 +1,10 @@
 #include "formplot.h"
 #include "ui_formplot.h"
 
-#include <limits>
-#include <cmath>
 #include <QBoxLayout>
-#include <QDateTime>
+#include <QShortcut>
+#include <QThread>
+#include <algorithm>
 
 
 
@@ -36,32 +36,41 @@ FormPlot::FormPlot(QWidget *parent)
         {"T1","customPlotT1THT0", Qt::black,      "TEMP1"},
         {"TH","customPlotT1THT0", Qt::darkRed,    "THERM"},
         {"HR","customPlotHR"    , Qt::red,        "HR"},
+        {"H_HR","customPlotHR"  , Qt::darkRed,    "HR (PC)"},
         //{"SR","customPlotSR"    , Qt::blue,       "SCR:RIS"},
         {"SF","customPlotSF"    , Qt::darkCyan,   "SCR:FREQ"},
+        {"H_SF","customPlotSF"  , Qt::blue,       "SCR:FREQ (PC)"},
          {"EL","customPlotSR"    , Qt::blue,   "EDLevel"},
         {"EA","customPlotEA"    , Qt::darkBlue,   "EDA"},
+        {"H_ET","customPlotEA"  , Qt::gray,       "EDA tónica (PC)"},
        // {"SA","customPlotSA"    , Qt::darkMagenta,"SCR:AMP"},
          {"BI","customPlotSA"    , Qt::darkMagenta,"Heart Inter-beat Interval"},
+         {"H_BI","customPlotSA"  , Qt::magenta,    "Inter-beat Interval (PC)"},
         {"PI","customPlotPI"    , Qt::darkRed,    "PPG:IR"},
         {"PR","customPlotPR"    , Qt::red,        "PPG:RED"},
         {"PG","customPlotPG"    , Qt::darkGreen,  "PPG:GREEN"}
     };
 
-    setupCharts();
-
-
-
+    // rasterizado fuera del hilo de la interfaz, dejándole un núcleo libre
+    renderPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+    renderPool.setObjectName("FormPlotRender");
 
-    currentTime  = QDateTime::currentMSecsSinceEpoch() / 1000.0;
-    smoothDt    = 0.0;
-    //   scrollTimer  = new QTimer(this);
-    //   connect(scrollTimer, &QTimer::timeout,this,   &FormPlot::advanceTimeWindow);   scrollTimer->start(30);
+    setupCharts();
 
-    // timer para repintar
-    replotTimer = new QTimer(this);
-    connect(replotTimer, &QTimer::timeout,
-            this,        &FormPlot::refreshCharts);
-    replotTimer->start(100);              // ms
+    // reloj de fotogramas ligado al refresco de la pantalla: una sola pasada por fotograma
+    frameScheduler = new FrameScheduler(this);
+    connect(frameScheduler, &FrameScheduler::frame,
+            this,           &FormPlot::refreshCharts);
+    frameScheduler->start();
+
+    // panel de rendimiento, oculto hasta pulsar F3
+    perfHud = new PerfHud(this);
+    perfHud->setFrameScheduler(frameScheduler);
+    auto *hudShortcut = new QShortcut(QKeySequence(Qt::Key_F3), this);
+    hudShortcut->setContext(Qt::ApplicationShortcut);
+    connect(hudShortcut, &QShortcut::activated, this, [this]() {
+        setPerfHudVisible(!isPerfHudVisible());
+    });
 }
 
 
@@ -72,100 +81,45 @@ FormPlot::FormPlot(QWidget *parent)
  */
 FormPlot::~FormPlot()
 {
-    if (replotTimer) replotTimer->stop();
+    if (frameScheduler) frameScheduler->stop();
+    renderPool.waitForDone();
     delete ui;
 }
 
 // ----------------------------------------------------------------
-// ----  crea cada QChart y lo incrusta en el placeholder del .ui
+// ----  crea cada StripChart y la incrusta en el placeholder del .ui
 // ----------------------------------------------------------------
 /*
  * setupCharts
- * Crea y configura los gráficos (QCharts), ejes y leyendas para cada conjunto de canales.
- * Asocia las series de datos a sus respectivos ejes y contenedores visuales.
+ * Crea una gráfica de desplazamiento por placeholder y le añade sus canales,
+ * en el orden de la tabla.
  */
 void FormPlot::setupCharts(){
-    // agrupar canales por plotName
-    QMap<QString, QList<ChannelInfo>> plotChannels;
-    for (const auto &info : channelInfos)
-        plotChannels[info.plotName].append(info);
-
-
-
-    for (auto it = plotChannels.cbegin(); it != plotChannels.cend(); ++it)  {
-        const QString plotName = it.key();
-        const auto   &chs      = it.value();
-
-        QWidget *placeholder = findChild<QWidget *>(plotName);
-        if (!placeholder) continue;
-
-        // ---- chart ----
-        QChart *chart = new QChart;
-        chart->setBackgroundVisible(false);
-
-        chart->legend()->setLayoutDirection(Qt::LeftToRight);
-        chart->legend()->setMaximumHeight(100);  // o lo que necesites
-        chart->legend()->setContentsMargins(0, 0, 0, 0);
-
-        QLegend *legend = chart->legend();
-        legend->setVisible(true);
-        legend->setAlignment(Qt::AlignLeft);
-        legend->setMarkerShape(QLegend::MarkerShapeFromSeries);
-        legend->setFont(QFont("Arial", 6));
-        legend->setContentsMargins(0, 0, 0, 0);
-        legend->setBackgroundVisible(false);
-        legend->setBrush(Qt::NoBrush);
-
-        // eje X (tiempo)
-        auto *axX = new QValueAxis;
-        axX->setRange(0.0, windowSize);
-        axX->setVisible(false);
-        chart->addAxis(axX, Qt::AlignBottom);
-
-        // eje Y
-        auto *axY = new QValueAxis;
-        axY->setTickCount(3);
-        axY->setLabelFormat("%.2f");
-
-        axY->setLabelsVisible(true);
-        chart->addAxis(axY, Qt::AlignRight);
-        chart->setMargins(QMargins(0, 0, 0, 0));  // márgenes
-        axY->setLineVisible(true);
-        QFont axisFont("Arial", 6);
-        axY->setLabelsFont(axisFont);
-        axY->setTickCount(3);  // 3 valores: min, medio, max
-        plotCache.insert(plotName,   { axX, axY,false, false, 0.0, 0.0,  0.0 });
-
-        // series por canal
-        for (const auto &info : chs)
-        {
-            auto *series = new QLineSeries;
-            series->setName(info.channelID);
-            series->setColor(info.color);
-            chart->addSeries(series);
-            series->attachAxis(axX);
-            series->attachAxis(axY);
-            channel2plot.insert(info.channelID, plotName);
-            seriesMap.insert(info.channelID, series);
-        }
-
-        // chart view
-        auto *view = new QChartView(chart, placeholder);
-        view->setRenderHint(QPainter::Antialiasing);
-        view->setGeometry(placeholder->rect());
-        view->setMinimumHeight(80);
-        view->setMaximumHeight(80);
-        view->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Fixed);
-
-        // Establece layout si no existe
-        if (!placeholder->layout()) {
-            auto *layout = new QVBoxLayout(placeholder);
+    for (const auto &info : std::as_const(channelInfos)) {
+        StripChart *chart = chartMap.value(info.plotName, nullptr);
+        if (!chart) {
+            QWidget *placeholder = findChild<QWidget *>(info.plotName);
+            if (!placeholder) continue;
+
+            chart = new StripChart(placeholder);
+            chart->setWindowSeconds(windowSize);
+            chart->setRenderPool(&renderPool);
+            chart->setLatencyTracer(latencyTracer);
+            chart->setGeometry(placeholder->rect());
+
+            auto *layout = placeholder->layout();
+            if (!layout) layout = new QVBoxLayout(placeholder);
             layout->setContentsMargins(0, 0, 0, 0);
-        } else {
-            placeholder->layout()->addWidget(view);
+            layout->addWidget(chart);
+            chartMap.insert(info.plotName, chart);
+
+            connect(chart, &StripChart::viewChanged, this, [this, chart](qint64 t0Us, qint64 t1Us) {
+                syncView(chart, t0Us, t1Us);
+            });
+            connect(chart, &StripChart::liveRequested, this, &FormPlot::resumeLive);
         }
-        view->show();
-        chartViewMap.insert(plotName, view);
+        chart->addChannel(info.channelID, info.color, info.label);
+        channel2plot.insert(info.channelID, info.plotName);
     }
 }
 
@@ -174,120 +128,199 @@ void FormPlot::setupCharts(){
 
 //________________________________________________________
 /*
- * onNewDataReceived
- * Recibe nuevos datos y actualiza la serie y el buffer del canal correspondiente.
- * También marca la gráfica como "sucia" para recalcular los ejes.
+ * setChannelQuality
+ * Añade la puntuación de calidad al nombre del canal en la leyenda y lo
+ * dibuja discontinuo mientras el contacto del sensor es malo.
  *
- * @param channelID Identificador del canal (ej. "AX", "HR", etc.)
- * @param t Tiempo en segundos
- * @param y Valor del dato
+ * @param channelID Canal evaluado
+ * @param score Puntuación de 0 a 100
  */
-void FormPlot::onNewDataReceived(const QString &channelID,
-                                 double         t,
-                                 double         y)
+void FormPlot::setChannelQuality(const QString &channelID, float score)
 {
-    constexpr int MAX_SAMPLES  = 1000;
-    constexpr double windowSize = 10.0;       // segundos visibles
-    const double  tMin = t - windowSize;
-
-    // --- serie y buffer ---
-    auto *series = seriesMap.value(channelID, nullptr);
-    if (!series) return;
-
-    auto &buf = buffers[channelID];
-    buf.data.append({t, y});
-    while (!buf.data.isEmpty() && buf.data.first().x() < tMin)
-        buf.data.removeFirst();
-    if (buf.data.size() > MAX_SAMPLES)
-        buf.data.remove(0, buf.data.size() - MAX_SAMPLES);
-
-    QVector<QPointF> v = buf.data;
-    if (!v.isEmpty() && t - v.last().x() > 0.05 * windowSize)
-        v.append({t, v.last().y()});          // punto fantasma
-    series->replace(v);
-
-    //--- eje X ---
-    auto &cache = plotCache[channel2plot.value(channelID)];
-    if (cache.axX) cache.axX->setRange(tMin, t);
-    cache.dirty = true;                       // recalcular Y
+    if (auto *chart = chartMap.value(channel2plot.value(channelID), nullptr))
+        chart->setChannelQuality(channelID, score);
+}
+
+
+
+
+//________________________________________________________
+/*
+ * setStore
+ * Asigna el almacén de series del controlador. FormPlot solo lo lee: en cada
+ * fotograma cada gráfica toma de sus anillos las muestras nuevas.
+ *
+ * @param store Almacén compartido (puede ser nullptr para desconectar)
+ */
+void FormPlot::setStore(const TimeSeriesStore *store)
+{
+    this->store = store;
+    for (auto *chart : std::as_const(chartMap))
+        chart->setStore(store);
+}
+
+
+
+
+//________________________________________________________
+/*
+ * setStats
+ * Asigna las estadísticas de ventana del controlador. El rango Y de cada
+ * gráfica se toma de ellas en tiempo constante, sin recorrer los puntos.
+ *
+ * @param stats Estadísticas compartidas (puede ser nullptr para desconectar)
+ */
+void FormPlot::setStats(const ChannelStats *stats)
+{
+    this->stats = stats;
+    for (auto *chart : std::as_const(chartMap))
+        chart->setStats(stats);
+}
+
+
+
+
+//________________________________________________________
+/*
+ * setSession
+ * Asigna la sesión completa del controlador. Al alejar con la rueda o
+ * arrastrar, las gráficas dibujan desde sus pirámides de resúmenes.
+ *
+ * @param session Sesión compartida (puede ser nullptr para desconectar)
+ */
+void FormPlot::setSession(const SessionStore *session)
+{
+    this->session = session;
+    for (auto *chart : std::as_const(chartMap))
+        chart->setSession(session);
+}
+
+
+
+
+//________________________________________________________
+/*
+ * setLatencyTracer
+ * Asigna el trazador de latencia. Cada fotograma en vivo se lleva las
+ * sondas de sus canales y las cierra cuando se pinta.
+ *
+ * @param tracer Trazador compartido (puede ser nullptr para no medir)
+ */
+void FormPlot::setLatencyTracer(LatencyTracer *tracer)
+{
+    latencyTracer = tracer;
+    for (auto *chart : std::as_const(chartMap))
+        chart->setLatencyTracer(tracer);
+}
+
+
+
+
+//________________________________________________________
+/*
+ * setPerfCounters
+ * Asigna los contadores que lee el panel de rendimiento. En cada fotograma
+ * se cuentan el fotograma, los puntos dibujados y los saltados.
+ *
+ * @param counters Contadores compartidos (puede ser nullptr para no contar)
+ */
+void FormPlot::setPerfCounters(PerfCounters *counters)
+{
+    perfCounters = counters;
+    perfHud->setCounters(counters);
+}
+
+
+
+void FormPlot::setLatencyReport(const LatencyTracer::Report &report)
+{
+    perfHud->setLatency(report);
+}
+
+
+
+void FormPlot::setPerfHudVisible(bool visible)
+{
+    perfHud->setVisible(visible);
+}
+
+
+
+bool FormPlot::isPerfHudVisible() const
+{
+    return perfHud->isVisible();
+}
+
+
+
+
+//________________________________________________________
+/*
+ * syncView
+ * Lleva la vista de la sesión elegida en una gráfica a todas las demás, para
+ * que todas muestren el mismo tramo de tiempo.
+ */
+void FormPlot::syncView(StripChart *source, qint64 t0Us, qint64 t1Us)
+{
+    for (auto *chart : std::as_const(chartMap))
+        if (chart != source) chart->setView(t0Us, t1Us);
 
-    // --- etiqueta de tiempo (opcional) ---
     if (ui->labelTime)
-        ui->labelTime->setText(QString::number(t, 'f', 2));
+        ui->labelTime->setText(QString("%1 - %2").arg(t0Us / 1e6, 0, 'f', 2)
+                                                .arg(t1Us / 1e6, 0, 'f', 2));
+}
+
+
+
+
+//________________________________________________________
+/*
+ * resumeLive
+ * Vuelve a seguir los datos en vivo en todas las gráficas (doble clic).
+ */
+void FormPlot::resumeLive()
+{
+    for (auto *chart : std::as_const(chartMap))
+        chart->setLive();
 }
 
 
 
 
 /* ----------------------------------------------------------------
- * repinta charts y re‑escala Y solo cuando es necesario
+ * avanza y repinta cada gráfica
  * ----------------------------------------------------------------
  * refreshCharts
- * Reescala los ejes Y si hay datos nuevos y repinta las gráficas.
+ * Se llama una vez por fotograma desde FrameScheduler. Cada gráfica visible
+ * copia su último fotograma terminado y lanza el siguiente en renderPool,
+ * donde se desplaza el trazado y se dibujan las muestras nuevas; sin datos
+ * nuevos no se hace nada y la que aún no ha terminado el anterior se salta.
+ * Las gráficas ocultas no se tocan y se ponen al día en cuanto se ven.
  */
 void FormPlot::refreshCharts(){
-    for (auto it = chartViewMap.cbegin(); it != chartViewMap.cend(); ++it)    {
-        const QString plotName = it.key();
-        QChartView   *view     = it.value();
-        auto         &cache    = plotCache[plotName];
-
-        if (cache.dirty && cache.axY)        {
-            const double xMin = cache.axX->min();
-            const double xMax = cache.axX->max();
-
-            double minY =  std::numeric_limits<double>::max();
-            double maxY = -std::numeric_limits<double>::max();
-
-            for (auto *s : view->chart()->series())            {
-                auto *ls = qobject_cast<QLineSeries*>(s);
-                if (!ls) continue;
-                for (const QPointF &p : ls->pointsVector())            {
-                    if (p.x() < xMin || p.x() > xMax) continue;
-                    minY = std::min(minY, p.y());
-                    maxY = std::max(maxY, p.y());
-                }
-            }
-
-            if (minY == std::numeric_limits<double>::max()) {
-                minY = -1.0; maxY = 1.0;
-            } else if (minY == maxY) {
-                minY -= 1.0; maxY += 1.0;
-            } else {
-                const double margin = 0.10 * (maxY - minY);
-                minY -= margin;
-                maxY += margin;
-            }
-
-            // Suavizado exponencial
-            const double alpha = 0.4; // más pequeño = más suavizado
-
-            if (cache.smoothMinY == cache.smoothMaxY) {
-                // Primera vez
-                cache.smoothMinY = minY;
-                cache.smoothMaxY = maxY;
-            } else {
-                cache.smoothMinY = (1.0 - alpha) * cache.smoothMinY + alpha * minY;
-                cache.smoothMaxY = (1.0 - alpha) * cache.smoothMaxY + alpha * maxY;
-            }
-            cache.axY->setRange(cache.smoothMinY, cache.smoothMaxY);
-
-            // Formato dinámico de etiquetas
-            double absMax = std::max(std::fabs(cache.smoothMinY), std::fabs(cache.smoothMaxY));
-            int decimals;
-            if (absMax < 100.0)
-                decimals = 4;
-            else if (absMax < 1000.0)
-                decimals = 3;
-            else if (absMax < 10000.0)
-                decimals = 1;
-            else
-                decimals = 0;
-            QString format = QString("%.%1f").arg(decimals);
-            cache.axY->setLabelFormat(format);
-            cache.dirty = false;
+    if (!store) return;
+
+    double latestT = -1.0;
+    for (auto *chart : std::as_const(chartMap)) {
+        if (!chart->isVisible() || chart->visibleRegion().isEmpty()) continue;
+        latestT = std::max(latestT, chart->advance());
+    }
+
+    if (perfCounters) {
+        quint64 points = 0, skipped = 0;
+        for (auto *chart : std::as_const(chartMap)) {
+            points += chart->pointsDrawn();
+            skipped += quint64(chart->skippedFrames());
         }
-        if (view) view->update();  // repintar vista
+        PerfCounters::bump(perfCounters->frames);
+        PerfCounters::set(perfCounters->pointsDrawn, points);
+        PerfCounters::set(perfCounters->skippedFrames, skipped);
+        PerfCounters::set(perfCounters->renderJobs, renderPool.activeThreadCount());
     }
+
+    // --- etiqueta de tiempo (opcional) ---
+    if (ui->labelTime && latestT >= 0.0)
+        ui->labelTime->setText(QString::number(latestT, 'f', 2));
 }
 
 
@@ -299,98 +332,15 @@ void FormPlot::refreshCharts(){
 // ----------------------------------------------------------------
 /*
  * resetAllData
- * Limpia todos los datos de las gráficas y reinicia los ejes y temporizadores.
+ * Limpia todos los datos de las gráficas y reinicia los ejes.
  */
 void FormPlot::resetAllData()
 {
-    // Borrar todas las series
-    for (auto *series : std::as_const(seriesMap))
-        if (series)
-            series->clear();
-
-    // Vaciar los buffers de datos guardados
-    for (auto &bufPair : buffers)
-        bufPair.data.clear();
-
-    // Reiniciar ejes X/Y y flags
-    for (auto &cache : plotCache)
-    {
-        if (cache.axX) cache.axX->setRange(0.0, windowSize);
-        if (cache.axY)
-        {
-            cache.axY->setRange(-1.0, 1.0);
-            cache.smoothMinY = cache.axY->min();
-            cache.smoothMaxY = cache.axY->max();
-        }
-        cache.dirty    = false;
-        cache.lastT    = 0.0;
-        cache.fracPixPend = 0.0;
-    }
-
-    //  Resetear el tiempo de arranque
-    currentTime = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    // Borrar los trazados: se vuelve a leer del almacén
+    for (auto *chart : std::as_const(chartMap))
+        chart->reset();
 
     // Actualizar la etiqueta de tiempo si la usas
     if (ui->labelTime)
         ui->labelTime->setText(QStringLiteral("0.00"));
 }
-//_______________
-
-
-
-//____________________________________________________________________________
-/*
- * advanceTimeWindow
- * Avanza suavemente la ventana de tiempo mostrada en el eje X de cada gráfica.
- * Realiza scroll en píxeles y sincroniza los rangos cada cierto tiempo.
- */
-void FormPlot::advanceTimeWindow()
-{
-    //  tiempo actual
-    const double now = QDateTime::currentMSecsSinceEpoch()/1000.0;
-
-    //  rawDt
-    const double rawDt = now - currentTime;
-    currentTime        = now;
-    if (rawDt <= 0.0) return;
-
-    //  suavizado exponencial del delta-tiempo
-    constexpr double alpha = 0.2;
-    if (smoothDt == 0.0)         // primer frame
-        smoothDt = rawDt;
-    else
-        smoothDt = alpha*rawDt + (1.0 - alpha)*smoothDt;
-    const double dt = smoothDt;
-
-    // actualiza etiqueta de tiempo (opcional)
-    if (ui->labelTime)
-        ui->labelTime->setText(QString::number(now, 'f', 2));
-
-    //  desplazamiento en cada gráfico
-    // calculamos píxeles/segundo una sola vez por frame
-    double wPix = chartViewMap.isEmpty() ? 0.0
-                                         : chartViewMap.begin().value()->viewport()->width();
-    const double pxPerSec = wPix / windowSize;
-
-    for (auto it = plotCache.begin(); it != plotCache.end(); ++it)
-    {
-        const QString &plotName = it.key();
-        PlotCache     &cache    = it.value();
-        QChartView    *view     = chartViewMap.value(plotName, nullptr);
-        if (!view || !cache.axX) continue;
-
-        // ) scroll "suave" con fracción acumulada
-        double moveAcc = pxPerSec * dt + cache.fracPixPend;
-        int    dxPix   = int(moveAcc);
-        cache.fracPixPend = moveAcc - dxPix;
-        if (dxPix > 0)
-            view->chart()->scroll(dxPix, 0);
-
-        //  cada ~0.5 s sincronizamos  el rango X
-        if (now - cache.lastT > 0.5) {
-            cache.axX->setRange(now - windowSize, now);
-            cache.lastT = now;
-        }
-    }
-}
-
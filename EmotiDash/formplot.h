@@ -19,15 +19,15 @@
 
 #pragma once
 #include <QWidget>
-#include <QTimer>
 #include <QMap>
+#include <QThreadPool>
 #include <QColor>
-#include <QQueue>
 
-#include <QtCharts/QChartView>
-#include <QtCharts/QChart>
-#include <QtCharts/QLineSeries>
-#include <QtCharts/QValueAxis>
+#include "timeseriesstore.h"
+#include "windowedstats.h"
+#include "stripchart.h"
+#include "framescheduler.h"
+#include "perfhud.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class FormPlot; }
@@ -48,14 +48,54 @@ public:
     ~FormPlot();
 
     /**
-     * @brief Recibe nuevos datos para visualizarlos en los gráficos.
-     * @param channelID Identificador del canal de datos.
-     * @param t Marca de tiempo del dato recibido.
-     * @param y Valor numérico recibido.
+     * @brief Asigna el almacén de series del que se leen los datos a graficar.
+     * @param store Almacén compartido del controlador (se lee por referencia, sin copias).
      */
-    void onNewDataReceived(const QString &channelID,
-                           double         t,
-                           double         y);
+    void setStore(const TimeSeriesStore *store);
+
+    /**
+     * @brief Asigna las estadísticas de ventana por canal usadas para autoescalar el eje Y.
+     * @param stats Estadísticas compartidas del controlador.
+     */
+    void setStats(const ChannelStats *stats);
+
+    /**
+     * @brief Asigna la sesión completa del controlador, usada al alejar o desplazar las gráficas.
+     * @param session Sesión comprimida con sus pirámides de resúmenes.
+     */
+    void setSession(const SessionStore *session);
+
+    /**
+     * @brief Asigna el trazador de latencia del controlador; las gráficas cierran sus sondas al pintarse.
+     * @param tracer Trazador compartido (nullptr para no medir).
+     */
+    void setLatencyTracer(LatencyTracer *tracer);
+
+    /**
+     * @brief Asigna los contadores de rendimiento; las gráficas añaden fotogramas y puntos dibujados.
+     * @param counters Contadores del controlador, leídos también por el panel de rendimiento.
+     */
+    void setPerfCounters(PerfCounters *counters);
+
+    /**
+     * @brief Último informe de latencia, para el panel de rendimiento.
+     * @param report Percentiles por etapa del último segundo.
+     */
+    void setLatencyReport(const LatencyTracer::Report &report);
+
+    /**
+     * @brief Muestra u oculta el panel de rendimiento (también con F3).
+     * @param visible true para mostrarlo.
+     */
+    void setPerfHudVisible(bool visible);
+    bool isPerfHudVisible() const;
+
+    /**
+     * @brief Muestra la calidad del último segundo de un canal en su leyenda.
+     * @param channelID Canal evaluado.
+     * @param score Puntuación de 0 a 100.
+     */
+    void setChannelQuality(const QString &channelID, float score);
 
     /**
      * @brief Limpia y reinicia todos los gráficos y datos.
@@ -72,49 +112,28 @@ private:
         QString label;
     };
 
-
-    QTimer *scrollTimer {nullptr};   //  +  un timer dedicado
-     double _t0 = -1.0;
-    /*  en PlotCache añadimos la fracción de píxel pendiente */
-
-
-
-    struct PlotCache
-    {
-        QValueAxis *axX{}, *axY{};
-        bool   dirty{false};
-        bool   xInit{false};          // NUEVO  ← ¿ya se fijó el rango?
-        double lastT{0.0};
-        double smoothMinY{0.0}, smoothMaxY{0.0};
-        double fracPixPend{0.0};
-    };
-
-    struct PlotBuffer {
-        /* cola de puntos para no crecer sin límite */
-        QQueue<QPointF> data;
-    };
-
-
     /* ----- helpers ------------------------------------------------- */
-    void setupCharts();        // crea charts al arrancar
-    void refreshCharts();      // timer → repinta + re‑escala Y
+    void setupCharts();        // crea una StripChart en cada placeholder
+    void refreshCharts();      // fotograma → cada gráfica visible lee lo nuevo del almacén y lo dibuja
+    void syncView(StripChart *source, qint64 t0Us, qint64 t1Us);   // misma vista en todas las gráficas
+    void resumeLive();
 
     /* ----- miembros ------------------------------------------------ */
     Ui::FormPlot *ui{};
-    QTimer *replotTimer{nullptr};
-    double currentTime = 0.0;
-    double   smoothDt    = 0.0;
+    FrameScheduler *frameScheduler{nullptr};
+    PerfHud *perfHud{nullptr};              // panel de rendimiento superpuesto (F3)
+    QThreadPool renderPool;     // un trabajo de rasterizado por gráfica, en paralelo
     QVector<ChannelInfo> channelInfos;
 
-    void advanceTimeWindow();
-
     /* mapas de acceso O(1) */
-    QMap<QString, QChartView*>  chartViewMap; // plotName → view
-    QMap<QString, QLineSeries*> seriesMap;    // channelID → serie
-    QMap<QString, QString>                channel2plot; // canal → plotName
-    QMap<QString, PlotCache>              plotCache;    // plotName → cache
-    QMap<QString, PlotBuffer>             buffers;      // canal → buffer
+    QMap<QString, StripChart*> chartMap;      // plotName → gráfica
+    QMap<QString, QString>     channel2plot;  // canal → plotName
+
+    const TimeSeriesStore *store{nullptr};   // muestras compartidas con el controlador
+    const ChannelStats    *stats{nullptr};   // mínimo/máximo de la ventana por canal
+    const SessionStore    *session{nullptr}; // sesión completa para el zoom y el desplazamiento
+    LatencyTracer         *latencyTracer{nullptr}; // latencia del datagrama a la pantalla
+    PerfCounters          *perfCounters{nullptr};  // fotogramas y puntos para el panel de rendimiento
 
     double windowSize{10.0};   // segundos mostrados en X
 };
-//scrollTimer
@@ -24,6 +24,7 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QPushButton>
+#include <QScrollBar>
 #include<QEmotiBitPacket.h>
 
 #include "ChannelFrequencies.h"
@@ -68,7 +69,30 @@ FormVistaEmotiBit::FormVistaEmotiBit(QWidget *parent) : QWidget(parent), ui(new
     connect(&controller, &EmotiBitController::recordingStateUpdated,this, &FormVistaEmotiBit::updateDeviceState);
     connect(&controller, &EmotiBitController::batteryLevelUpdated, this, &FormVistaEmotiBit::updateBatteryLevel);
     connect(&controller, &EmotiBitController::deviceModeUpdated,this, &FormVistaEmotiBit::updateDeviceMode);
-    connect(&controller, &EmotiBitController::sensorDataReceived,this, &FormVistaEmotiBit::onNewSensorData);
+    connect(&controller, &EmotiBitController::signalQualityUpdated, this, &FormVistaEmotiBit::updateSignalQuality);
+    // Las gráficas leen las muestras directamente del almacén del controlador
+    if (formPlot) {
+        formPlot->setStore(&controller.store());
+        formPlot->setStats(&controller.stats());
+        formPlot->setSession(&controller.session());
+        formPlot->setLatencyTracer(&controller.latency());
+        formPlot->setPerfCounters(&controller.perfCounters());
+    }
+    connect(&controller, &EmotiBitController::latencyReport, this, &FormVistaEmotiBit::updateLatency);
+    // Registro de paquetes: anillo de capacidad fija publicado una vez por fotograma
+    packetLog = new PacketLogModel(2000, this);
+    ui->listViewPaquetes->setModel(packetLog);
+    connect(ui->lineEditFiltroPaquetes, &QLineEdit::textChanged, this, [this](const QString &text) {
+        packetLog->setTagFilter(text.split(',', Qt::SkipEmptyParts));
+    });
+    connect(packetLog, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+        const QScrollBar *bar = ui->listViewPaquetes->verticalScrollBar();
+        packetLogAtBottom = bar->value() >= bar->maximum();
+    });
+    connect(packetLog, &QAbstractItemModel::rowsInserted, this, [this]() {
+        if (packetLogAtBottom) ui->listViewPaquetes->scrollToBottom();
+    });
+
     ui->pushButtonConectar->setEnabled(false);
     ui->pushButtonDesconectar->setEnabled(false);
 }
@@ -295,15 +319,16 @@ void FormVistaEmotiBit::desconectarPulsera(){
 // -----------------------------------------------------------
 
 /**
- * @brief Muestra un paquete de datos recibido en el TextBrowser correspondiente si está activado.
+ * @brief Añade un paquete recibido al registro de paquetes si está activado.
+ *
+ * El registro guarda las últimas líneas en un anillo y las publica en la lista
+ * una vez por fotograma, así que el coste no crece con la duración de la sesión.
  *
  * @param packet Contenido textual del paquete recibido.
  */
 void FormVistaEmotiBit::displayPacket(const QString &packet){
-    // Muestra el texto en textBrowserMensajes
-    // o en textBrowserPaquetes (depende de tu preferencia)
     if (ui->checkBoxPaquetesRecibidos->isChecked()) {
-        ui->textBrowserPaquetes->append(packet);
+        packetLog->append(packet);
     }
 }
 //________________________
@@ -328,6 +353,57 @@ void FormVistaEmotiBit::updateDeviceState(bool isRecording, const QString &fileN
 }
 
 
+/**
+ * @brief Muestra la calidad de un canal en su gráfica y avisa cuando el contacto
+ * del sensor pasa a ser malo o se recupera.
+ *
+ * @param channelID Canal evaluado.
+ * @param score Puntuación de calidad del último segundo (0-100).
+ */
+void FormVistaEmotiBit::updateSignalQuality(const QString &channelID, float score){
+    if (formPlot) formPlot->setChannelQuality(channelID, score);
+
+    const bool bad = score < 50.0f;
+    if (bad && !badQualityChannels.contains(channelID)) {
+        badQualityChannels.insert(channelID);
+        ui->textBrowserMensajes->append(QString("<span style='color:red;'>Calidad:</span> señal %1 no utilizable (%2/100)")
+                                            .arg(channelID).arg(qRound(score)));
+    } else if (!bad && score >= 80.0f && badQualityChannels.remove(channelID)) {
+        ui->textBrowserMensajes->append(QString("<span style='color:green;'>Calidad:</span> señal %1 recuperada")
+                                            .arg(channelID));
+    }
+}
+
+
+/**
+ * @brief Pasa el informe de latencia al panel de rendimiento y avisa cuando la latencia
+ * de extremo a extremo (p95 del último segundo) supera el objetivo y cuando vuelve a
+ * cumplirlo, indicando la etapa más lenta.
+ *
+ * @param report Percentiles por etapa del último segundo.
+ */
+void FormVistaEmotiBit::updateLatency(const LatencyTracer::Report &report){
+    if (formPlot) formPlot->setLatencyReport(report);
+
+    const auto &e2e = report.stages[LatencyTracer::EndToEnd];
+    if (e2e.count == 0 || report.sloMet == latencySloMet) return;
+    latencySloMet = report.sloMet;
+
+    if (!report.sloMet) {
+        int worst = LatencyTracer::SocketToDecode;
+        for (int s = LatencyTracer::SocketToDecode; s <= LatencyTracer::PlotToPresent; ++s)
+            if (report.stages[s].p95Ms > report.stages[worst].p95Ms) worst = s;
+        ui->textBrowserMensajes->append(QString("<span style='color:red;'>Latencia:</span> p95 %1 ms (objetivo %2 ms), etapa más lenta %3 (%4 ms)")
+                                            .arg(e2e.p95Ms, 0, 'f', 1).arg(report.sloMs, 0, 'f', 0)
+                                            .arg(LatencyTracer::stageName(LatencyTracer::Stage(worst)))
+                                            .arg(report.stages[worst].p95Ms, 0, 'f', 1));
+    } else {
+        ui->textBrowserMensajes->append(QString("<span style='color:green;'>Latencia:</span> p95 %1 ms, dentro del objetivo")
+                                            .arg(e2e.p95Ms, 0, 'f', 1));
+    }
+}
+
+
 /**
  * @brief Actualiza el nivel de batería del EmotiBit mostrado en la interfaz.
  *
@@ -360,24 +436,6 @@ void FormVistaEmotiBit::updateDeviceMode(const QString &mode){
 //____________________________
 
 
-/**
- * @brief Slot que recibe nuevas muestras de sensores y las envía al FormPlot para su graficado.
- *
- * @param channelID Identificador del canal de datos (ej. "AX", "HR", "EA").
- * @param sampleTime Tiempo relativo de la muestra en segundos.
- * @param value Valor de la muestra.
- */
-
-void FormVistaEmotiBit::onNewSensorData(const QString &channelID, double sampleTime, double value){
-    // Aquí actualizamos la gráfica
-    if (formPlot) {
-        formPlot->onNewDataReceived(channelID, sampleTime, value);
-    }
-}//__________________________ reset
-
-
-
-
 /**
  * @brief Envía una nota de usuario al EmotiBit con el texto introducido en la interfaz.
  */
@@ -22,10 +22,12 @@
 #define FORMVISTAEMOTIBIT_H
 
 #include <QWidget>
+#include <QSet>
 
 #include <QTextStream>
 #include "EmotiBitController.h"
 #include "FormPlot.h"
+#include "packetlogmodel.h"
 
 namespace Ui {
 class FormVistaEmotiBit;
@@ -108,7 +110,8 @@ private slots:
     void updateDeviceState(bool isRecording, const QString &fileName);
     void updateBatteryLevel(int batteryLevel);
     void updateDeviceMode(const QString &mode);
-    void onNewSensorData(const QString &channelID, double sampleTime, double value);
+    void updateSignalQuality(const QString &channelID, float score);
+    void updateLatency(const LatencyTracer::Report &report);
 
     // Slot para enviar una nota
     void on_pushButtonNota_clicked();
@@ -117,8 +120,12 @@ private slots:
 private:
     Ui::FormVistaEmotiBit *ui;
     FormPlot *formPlot = nullptr;
+    PacketLogModel *packetLog = nullptr;   // registro acotado de paquetes recibidos
+    bool packetLogAtBottom = true;         // seguir la última línea mientras no se desplace la vista
 
     EmotiBitController controller;  // Instancia del controlador
+    QSet<QString> badQualityChannels;  // canales con mal contacto ya notificados
+    bool latencySloMet = true;         // último estado notificado del objetivo de latencia
 
     // Variables para grabación en archivo local
     bool m_isRecording = false;  
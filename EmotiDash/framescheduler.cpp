@@ -0,0 +1,172 @@
+/****************************************************************************
+ * FrameScheduler.cpp
+ *
+ * Descripción: Reloj de fotogramas de la interfaz. Sigue la frecuencia de
+ * refresco de la pantalla, la divide bajo carga y se detiene mientras la
+ * ventana está oculta o minimizada.
+ *
+ * Fecha: 2025-06-01
+ ****************************************************************************/
+
+#include "framescheduler.h"
+#include <QWidget>
+#include <QWindow>
+#include <QScreen>
+#include <QEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kLoadHigh  = 0.75;   // fracción del presupuesto a partir de la que se baja
+constexpr double kLoadLow   = 0.35;   // fracción del presupuesto más rápido por debajo de la que se sube
+constexpr double kWorkAlpha = 0.1;    // suavizado de la media del trabajo por fotograma
+constexpr int    kCooldown  = 30;     // fotogramas entre cambios de divisor
+
+}
+
+
+
+/**
+ * @param host Widget cuyo contenido se repinta en cada fotograma. Se vigila su visibilidad y la
+ *        de su ventana para no emitir fotogramas que nadie va a ver.
+ */
+FrameScheduler::FrameScheduler(QWidget *host)
+    : QObject(host), m_host(host)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FrameScheduler::onTick);
+
+    m_host->installEventFilter(this);
+    m_host->window()->installEventFilter(this);
+    applyInterval();
+}
+
+
+
+void FrameScheduler::start(){
+    m_running = true;
+    attachWindow();
+    updateActive();
+}
+
+
+
+void FrameScheduler::stop(){
+    m_running = false;
+    m_timer.stop();
+}
+
+
+
+void FrameScheduler::setMaxDivisor(int divisor){
+    m_maxDivisor = std::max(1, divisor);
+    if (m_divisor > m_maxDivisor) {
+        m_divisor = m_maxDivisor;
+        applyInterval();
+    }
+}
+
+
+
+// Un fotograma: el receptor hace todo su trabajo dentro de frame() y aquí se mide
+void FrameScheduler::onTick(){
+    m_work.start();
+    emit frame();
+    adaptToLoad(m_work.nsecsElapsed() / 1e6);
+}
+
+
+
+// Ajusta el divisor de la frecuencia de pantalla según el trabajo medio por fotograma
+void FrameScheduler::adaptToLoad(double workMs){
+    m_workMs += kWorkAlpha * (workMs - m_workMs);
+    if (m_cooldown > 0) {
+        --m_cooldown;
+        return;
+    }
+
+    int divisor = m_divisor;
+    if (m_workMs > kLoadHigh * frameBudgetMs() && m_divisor < m_maxDivisor)
+        ++divisor;
+    else if (m_divisor > 1 && m_workMs < kLoadLow * 1000.0 * (m_divisor - 1) / m_refreshHz)
+        --divisor;
+
+    if (divisor != m_divisor) {
+        m_divisor = divisor;
+        m_cooldown = kCooldown;
+        applyInterval();
+    }
+}
+
+
+
+bool FrameScheduler::eventFilter(QObject *watched, QEvent *event){
+    switch (event->type()) {
+    case QEvent::Show:
+        // El anfitrión puede haber cambiado de ventana al incrustarse en otro formulario
+        m_host->window()->installEventFilter(this);
+        attachWindow();
+        updateActive();
+        break;
+    case QEvent::Hide:
+    case QEvent::WindowStateChange:
+        updateActive();
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+
+
+// La ventana nativa solo existe una vez mostrada; desde ella se sigue la pantalla y la visibilidad
+void FrameScheduler::attachWindow(){
+    QWindow *window = m_host->window()->windowHandle();
+    if (!window || window == m_window) return;
+
+    if (m_window) m_window->disconnect(this);
+    m_window = window;
+    connect(window, &QWindow::screenChanged, this, &FrameScheduler::setScreen);
+    connect(window, &QWindow::visibilityChanged, this, [this]() { updateActive(); });
+    setScreen(window->screen());
+}
+
+
+
+void FrameScheduler::setScreen(QScreen *screen){
+    const double hz = screen ? screen->refreshRate() : 0.0;
+    m_refreshHz = (hz >= 20.0 && hz <= 500.0) ? hz : 60.0;   // algunos controladores informan 0
+    applyInterval();
+}
+
+
+
+void FrameScheduler::applyInterval(){
+    m_timer.setInterval(std::max(1, int(std::lround(frameBudgetMs()))));
+    emit frameRateChanged(frameRate());
+}
+
+
+
+// Arranca o detiene el reloj según la visibilidad real del anfitrión
+void FrameScheduler::updateActive(){
+    const bool active = m_running && hostVisible();
+    if (active && !m_timer.isActive()) {
+        m_timer.start();
+        onTick();                      // pone al día el contenido al volver a mostrarse
+    } else if (!active && m_timer.isActive()) {
+        m_timer.stop();
+    }
+}
+
+
+
+bool FrameScheduler::hostVisible() const {
+    const QWidget *top = m_host->window();
+    if (!m_host->isVisible() || top->isMinimized()) return false;
+    if (m_window && (m_window->visibility() == QWindow::Hidden
+                     || m_window->visibility() == QWindow::Minimized)) return false;
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+*  file FrameScheduler.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+
+class QWidget;
+class QWindow;
+class QScreen;
+
+/*!
+ * \class FrameScheduler
+ * \brief Reloj único de fotogramas de la interfaz, ligado a la frecuencia de refresco de la pantalla.
+ *
+ * Emite frame() una vez por fotograma, y en esa única pasada el receptor lee todo lo pendiente
+ * del almacén, reescala y repinta. La llegada de datos nunca provoca repintados por sí misma.
+ *
+ * - El periodo base es el de la pantalla en la que está la ventana (QScreen::refreshRate) y se
+ *   recalcula si la ventana cambia de pantalla.
+ * - Se mide el tiempo de trabajo de cada fotograma; si la media supera la mayor parte del
+ *   presupuesto se pasa a uno de cada 2, 3... fotogramas de pantalla, y se vuelve a subir
+ *   cuando sobra holgura.
+ * - Con la ventana oculta o minimizada, o el widget anfitrión oculto, el reloj se detiene.
+ *
+ * \see FormPlot
+ * \author Enrique Fuentes
+ * \date 2025-06-01
+ */
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameScheduler(QWidget *host);
+
+    void start();
+    void stop();
+
+    double refreshRate() const { return m_refreshHz; }
+    double frameRate() const { return m_refreshHz / m_divisor; }
+    double frameBudgetMs() const { return 1000.0 * m_divisor / m_refreshHz; }
+    double averageWorkMs() const { return m_workMs; }
+    bool isActive() const { return m_timer.isActive(); }
+
+    // Máximo divisor de la frecuencia de pantalla bajo carga (1 = nunca se baja)
+    void setMaxDivisor(int divisor);
+
+signals:
+    void frame();
+    void frameRateChanged(double fps);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void onTick();
+    void adaptToLoad(double workMs);
+    void attachWindow();
+    void setScreen(QScreen *screen);
+    void applyInterval();
+    void updateActive();
+    bool hostVisible() const;
+
+    QWidget *m_host;
+    QPointer<QWindow> m_window;
+    QTimer m_timer;
+    QElapsedTimer m_work;
+
+    bool m_running = false;
+    double m_refreshHz = 60.0;
+    int m_divisor = 1;
+    int m_maxDivisor = 4;
+    double m_workMs = 0.0;     // media exponencial del trabajo por fotograma
+    int m_cooldown = 0;        // fotogramas antes de volver a cambiar el divisor
+};
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,96 @@
+/****************************************************************************
+ * HrvSpectrum.cpp
+ *
+ * Descripción: Interpolación de los intervalos entre latidos a una rejilla
+ * uniforme y cálculo de las bandas LF/HF de la variabilidad cardiaca con
+ * el estimador de Welch incremental.
+ *
+ * Fecha: 2025-05-28
+ ****************************************************************************/
+
+#include "hrvspectrum.h"
+#include <cmath>
+
+namespace {
+const double kLfLow = 0.04, kLfHigh = 0.15;
+const double kHfLow = 0.15, kHfHigh = 0.40;
+const double kMaxGapSeconds = 5.0;       // hueco máximo entre latidos que se interpola
+}
+
+
+
+/**
+ * @param resampleHz Frecuencia de la rejilla de interpolación.
+ * @param segmentSize Muestras por segmento de Welch (256 a 4 Hz = 64 s).
+ * @param hop Muestras entre segmentos (32 a 4 Hz = un valor cada 8 s).
+ * @param averages Segmentos promediados.
+ */
+HrvSpectrum::HrvSpectrum(double resampleHz, int segmentSize, int hop, int averages)
+    : m_psd(segmentSize, hop, averages, resampleHz),
+    m_gridStepUs(qint64(1e6 / resampleHz))
+{
+}
+
+
+
+void HrvSpectrum::reset(){
+    m_psd.reset();
+    m_hasBeat = false;
+    m_lfOut.clear();
+    m_hfOut.clear();
+    m_ratioOut.clear();
+}
+
+
+
+/**
+ * Añade los latidos de un lote. Los resultados anteriores se descartan.
+ *
+ * @param ibis Tiempos de latido (µs) e IBI en ms.
+ */
+void HrvSpectrum::addBeats(const SampleBatch &ibis){
+    m_lfOut.clear();
+    m_hfOut.clear();
+    m_ratioOut.clear();
+    for (int i = 0; i < ibis.size(); ++i)
+        addBeat(ibis.t[i], ibis.v[i]);
+}
+
+
+
+void HrvSpectrum::addBeat(qint64 tUs, double ibiMs){
+    if (m_hasBeat && (tUs <= m_prevT || (tUs - m_prevT) / 1e6 > kMaxGapSeconds)) {
+        m_psd.reset();
+        m_hasBeat = false;
+    }
+
+    if (!m_hasBeat) {
+        m_hasBeat = true;
+        m_prevT = tUs;
+        m_prevIbi = ibiMs;
+        m_nextGridT = tUs;
+        return;
+    }
+
+    // Muestras de la rejilla entre el latido anterior y este
+    float grid[64];
+    int n = 0;
+    while (m_nextGridT <= tUs) {
+        const double f = double(m_nextGridT - m_prevT) / double(tUs - m_prevT);
+        grid[n++] = float(m_prevIbi + f * (ibiMs - m_prevIbi));
+        m_nextGridT += m_gridStepUs;
+        if (n == 64 || m_nextGridT > tUs) {
+            if (m_psd.push(grid, n) > 0) {
+                const double lf = m_psd.bandPower(kLfLow, kLfHigh);
+                const double hf = m_psd.bandPower(kHfLow, kHfHigh);
+                m_lfOut.push(tUs, float(lf));
+                m_hfOut.push(tUs, float(hf));
+                m_ratioOut.push(tUs, float(hf > 0.0 ? lf / hf : 0.0));
+            }
+            n = 0;
+        }
+    }
+
+    m_prevT = tUs;
+    m_prevIbi = ibiMs;
+}
@@ -0,0 +1,66 @@
+/**
+*  file HrvSpectrum.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef HRVSPECTRUM_H
+#define HRVSPECTRUM_H
+
+#include <QtGlobal>
+#include "welchpsd.h"
+#include "timeseriesstore.h"
+
+/*!
+ * \class HrvSpectrum
+ * \brief HRV en el dominio de la frecuencia (bandas LF y HF) a partir de los intervalos entre latidos.
+ *
+ * La serie de IBI no está muestreada uniformemente (un valor por latido), así que se interpola
+ * linealmente a una rejilla de 4 Hz y se pasa a un WelchPsd de segmentos de 64 s. Con cada
+ * segmento nuevo se publican la potencia LF (0,04–0,15 Hz), HF (0,15–0,4 Hz), en ms², y el
+ * cociente LF/HF. Un hueco de más de 5 s entre latidos reinicia la interpolación y
+ * la PSD para no inventar datos.
+ *
+ * \see WelchPsd, PpgBeatDetector
+ * \author Enrique Fuentes
+ * \date 2025-05-28
+ */
+class HrvSpectrum {
+public:
+    explicit HrvSpectrum(double resampleHz = 4.0, int segmentSize = 256, int hop = 32, int averages = 4);
+
+    void reset();
+
+    // Añade un latido con su IBI en ms; publica si se ha completado un segmento
+    void addBeat(qint64 tUs, double ibiMs);
+    void addBeats(const SampleBatch &ibis);
+
+    // Resultados desde la última llamada a addBeats()
+    const SampleBatch &lf() const    { return m_lfOut; }
+    const SampleBatch &hf() const    { return m_hfOut; }
+    const SampleBatch &ratio() const { return m_ratioOut; }
+
+private:
+    WelchPsd m_psd;
+
+    bool m_hasBeat = false;
+    qint64 m_prevT = 0;
+    double m_prevIbi = 0.0;
+    qint64 m_nextGridT = 0;
+    qint64 m_gridStepUs;
+
+    SampleBatch m_lfOut, m_hfOut, m_ratioOut;
+};
+
+#endif // HRVSPECTRUM_H
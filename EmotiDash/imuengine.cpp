@@ -0,0 +1,389 @@
+/****************************************************************************
+ * ImuEngine.cpp
+ *
+ * Descripción: Fusión de acelerómetro, giróscopo y magnetómetro con el
+ * filtro de Madgwick y cálculo de actividad, pasos, inquietud y quietud
+ * sobre bloques SoA de muestras de movimiento.
+ *
+ * Fecha: 2025-05-26
+ ****************************************************************************/
+
+#include "imuengine.h"
+#include <limits>
+
+namespace {
+const float kDegToRad = 0.0174532925f;
+const float kRadToDeg = 57.2957795f;
+const qint64 kWalkingHoldUs = 2000000;   // tras un paso se considera marcha durante 2 s
+
+float invSqrt(float x){
+    return 1.0f / std::sqrt(x);
+}
+}
+
+ImuEngine::ImuEngine()
+    : ImuEngine(Settings())
+{
+}
+
+ImuEngine::ImuEngine(const Settings &settings)
+{
+    setSettings(settings);
+}
+
+
+
+/**
+ * @param channelID Canal a comprobar.
+ * @return true si es uno de los nueve canales de movimiento.
+ */
+bool ImuEngine::isImuChannel(const QString &channelID){
+    return channelID.size() == 2
+           && (channelID[0] == 'A' || channelID[0] == 'G' || channelID[0] == 'M')
+           && (channelID[1] == 'X' || channelID[1] == 'Y' || channelID[1] == 'Z');
+}
+
+
+
+void ImuEngine::setSettings(const Settings &settings){
+    m_settings = settings;
+    const int window = int(std::lround(settings.windowSeconds * settings.sampleHz));
+    m_accWindow.resize(window);
+    m_gyroWindow.resize(window);
+    m_stepFilter = Biquad::lowPass(3.0, settings.sampleHz);
+    reset();
+}
+
+
+
+void ImuEngine::reset(){
+    for (int a = 0; a < AxisCount; ++a) {
+        m_pending[a].clear();
+        m_pendingT[a].clear();
+        m_head[a] = 0;
+    }
+    m_magSeen = false;
+    m_q0 = 1.0f; m_q1 = m_q2 = m_q3 = 0.0f;
+    m_primed = false;
+    m_warmup = int(2.0 * m_settings.sampleHz);
+    m_accWindow.resize(int(m_accWindow.ring.size()));
+    m_gyroWindow.resize(int(m_gyroWindow.ring.size()));
+    m_stepFilter.reset();
+    m_s1 = m_s2 = 0.0f;
+    m_lastStepT = m_lastFidgetT = 0;
+    m_fidgetActive = false;
+    m_stepCount = m_fidgetCount = 0;
+    m_still = -1;
+}
+
+
+
+/**
+ * Añade las muestras de un eje. Los instantes que ya tienen muestra en todos los ejes
+ * necesarios se procesan en bloque.
+ *
+ * @param channelID Canal de movimiento (AX..MZ).
+ * @param tUs Tiempos en microsegundos.
+ * @param values Valores del eje.
+ * @param n Número de muestras.
+ */
+void ImuEngine::addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    m_rollOut.clear();
+    m_pitchOut.clear();
+    m_yawOut.clear();
+    m_activityOut.clear();
+    m_stepOut.clear();
+    m_fidgetOut.clear();
+    m_stillOut.clear();
+
+    if (!isImuChannel(channelID) || n <= 0) return;
+
+    const int axis = (channelID[0] == 'A' ? AX : channelID[0] == 'G' ? GX : MX)
+                     + (channelID[1] == 'X' ? 0 : channelID[1] == 'Y' ? 1 : 2);
+    m_pending[axis].insert(m_pending[axis].end(), values, values + n);
+    m_pendingT[axis].insert(m_pendingT[axis].end(), tUs, tUs + n);
+    if (axis >= MX)
+        m_magSeen = true;
+
+    processReady();
+}
+
+
+
+/**
+ * Empareja por tiempo las cabezas de las colas y procesa los instantes completos.
+ *
+ * El instante candidato es la cabeza más reciente de acelerómetro y giróscopo; las cabezas
+ * anteriores a él en más de medio periodo no tienen pareja en algún eje y se descartan. El
+ * magnetómetro se añade si tiene muestra para ese instante; si aún no ha llegado se espera,
+ * salvo que el retraso supere una ventana, y entonces el instante se procesa sin él y sus
+ * muestras tardías se descartan después.
+ */
+void ImuEngine::processReady(){
+    const qint64 tolUs = qint64(0.5e6 / m_settings.sampleHz);
+    auto available = [this](int a) { return m_pendingT[a].size() - m_head[a]; };
+    auto headT = [this](int a) { return m_pendingT[a][m_head[a]]; };
+
+    for (auto &axis : m_block) axis.clear();
+    m_blockT.clear();
+    m_blockHasMag.clear();
+
+    for (;;) {
+        bool empty = false;
+        qint64 tRef = std::numeric_limits<qint64>::min();
+        for (int a = AX; a <= GZ && !empty; ++a) {
+            if (available(a) == 0) empty = true;
+            else tRef = std::max(tRef, headT(a));
+        }
+        if (empty) break;
+
+        bool dropped = false;
+        for (int a = AX; a <= GZ; ++a) {
+            while (available(a) > 0 && headT(a) < tRef - tolUs) {
+                ++m_head[a];
+                dropped = true;
+            }
+        }
+        if (dropped) continue;   // las cabezas han cambiado: nuevo candidato
+
+        bool hasMag = false;
+        if (m_magSeen) {
+            bool late = false, missing = false;
+            for (int a = MX; a <= MZ; ++a) {
+                while (available(a) > 0 && headT(a) < tRef - tolUs) ++m_head[a];
+                if (available(a) == 0) late = true;
+                else if (headT(a) > tRef + tolUs) missing = true;
+            }
+            if (late && !missing) {
+                size_t backlog = available(AX);
+                for (int a = AY; a <= GZ; ++a) backlog = std::min(backlog, available(a));
+                if (backlog < m_accWindow.ring.size()) break;
+            }
+            hasMag = !late && !missing;
+        }
+
+        m_blockT.push_back(headT(AX));
+        for (int a = AX; a <= GZ; ++a)
+            m_block[a].push_back(m_pending[a][m_head[a]++]);
+        for (int a = MX; a <= MZ; ++a)
+            m_block[a].push_back(hasMag ? m_pending[a][m_head[a]++] : 0.0f);
+        m_blockHasMag.push_back(hasMag ? 1 : 0);
+    }
+
+    if (!m_blockT.empty())
+        processBlock(int(m_blockT.size()));
+
+    // Retira de las colas lo consumido o descartado
+    for (int a = 0; a < AxisCount; ++a) {
+        m_pending[a].erase(m_pending[a].begin(), m_pending[a].begin() + m_head[a]);
+        m_pendingT[a].erase(m_pendingT[a].begin(), m_pendingT[a].begin() + m_head[a]);
+        m_head[a] = 0;
+    }
+}
+
+
+
+void ImuEngine::processBlock(int k){
+    float *ax = m_block[AX].data(), *ay = m_block[AY].data(), *az = m_block[AZ].data();
+    float *gx = m_block[GX].data(), *gy = m_block[GY].data(), *gz = m_block[GZ].data();
+    const float *mx = m_block[MX].data(), *my = m_block[MY].data(), *mz = m_block[MZ].data();
+    const qint64 *t = m_blockT.data();
+    const quint8 *hasMag = m_blockHasMag.data();
+
+    m_gyroMag.resize(k);
+    m_accDyn.resize(k);
+    float *gyroMag = m_gyroMag.data();
+    float *accDyn = m_accDyn.data();
+
+    // Bucles vectorizables: sin dependencias entre muestras y con vectores contiguos
+    for (int i = 0; i < k; ++i)
+        gyroMag[i] = std::sqrt(gx[i] * gx[i] + gy[i] * gy[i] + gz[i] * gz[i]);
+    for (int i = 0; i < k; ++i)
+        accDyn[i] = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]) - 1.0f;
+    for (int i = 0; i < k; ++i) {
+        gx[i] *= kDegToRad;
+        gy[i] *= kDegToRad;
+        gz[i] *= kDegToRad;
+    }
+
+    const float nominalDt = float(1.0 / m_settings.sampleHz);
+    const qint64 minStepUs = qint64(m_settings.minStepSeconds * 1e6);
+    const qint64 minFidgetUs = qint64(m_settings.minFidgetSeconds * 1e6);
+
+    for (int i = 0; i < k; ++i) {
+        float dt = nominalDt;
+        if (m_primed && t[i] > m_lastT)
+            dt = std::min(0.5f, float((t[i] - m_lastT) / 1e6));
+        m_lastT = t[i];
+        m_primed = true;
+
+        // Orientación
+        if (hasMag[i])
+            madgwick(gx[i], gy[i], gz[i], ax[i], ay[i], az[i], mx[i], my[i], mz[i], dt);
+        else
+            madgwickImu(gx[i], gy[i], gz[i], ax[i], ay[i], az[i], dt);
+        if (m_warmup > 0) --m_warmup;
+
+        const float q0 = m_q0, q1 = m_q1, q2 = m_q2, q3 = m_q3;
+        const float roll  = std::atan2(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2);
+        const float pitch = std::asin(std::clamp(-2.0f * (q1 * q3 - q0 * q2), -1.0f, 1.0f));
+        const float yaw   = std::atan2(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3);
+        m_rollOut.push(t[i], roll * kRadToDeg);
+        m_pitchOut.push(t[i], pitch * kRadToDeg);
+        m_yawOut.push(t[i], yaw * kRadToDeg);
+
+        // Actividad
+        m_accWindow.push(accDyn[i]);
+        m_gyroWindow.push(gyroMag[i]);
+        const double activity = m_accWindow.rms();
+        m_activityOut.push(t[i], float(activity));
+
+        // Pasos: máximo local de la aceleración dinámica filtrada
+        const float s = float(m_stepFilter.process(accDyn[i]));
+        if (m_s1 > m_s2 && m_s1 >= s && m_s1 > m_settings.stepThresholdG
+            && t[i] - m_lastStepT >= minStepUs) {
+            m_lastStepT = t[i];
+            m_stepOut.push(t[i], float(++m_stepCount));
+        }
+        m_s2 = m_s1;
+        m_s1 = s;
+
+        // Inquietud: inicio de una ráfaga de giro fuera de la marcha
+        const bool turning = gyroMag[i] > m_settings.fidgetGyroDps;
+        const bool walking = m_stepCount > 0 && t[i] - m_lastStepT < kWalkingHoldUs;
+        if (turning && !m_fidgetActive && !walking && t[i] - m_lastFidgetT >= minFidgetUs) {
+            m_lastFidgetT = t[i];
+            m_fidgetOut.push(t[i], float(++m_fidgetCount));
+        }
+        m_fidgetActive = turning;
+
+        // Quietud sobre la ventana completa
+        if (m_accWindow.full()) {
+            const int still = (activity < m_settings.stillActivityG
+                               && m_gyroWindow.rms() < m_settings.stillGyroDps) ? 1 : 0;
+            if (still != m_still) {
+                m_still = still;
+                m_stillOut.push(t[i], float(still));
+            }
+        }
+    }
+}
+
+
+
+// Filtro de Madgwick con magnetómetro (MARG). Giro en rad/s.
+void ImuEngine::madgwick(float gx, float gy, float gz, float ax, float ay, float az,
+                         float mx, float my, float mz, float dt){
+    if (mx == 0.0f && my == 0.0f && mz == 0.0f) {
+        madgwickImu(gx, gy, gz, ax, ay, az, dt);
+        return;
+    }
+
+    float q0 = m_q0, q1 = m_q1, q2 = m_q2, q3 = m_q3;
+    const float beta = m_warmup > 0 ? 2.5f : m_settings.beta;
+
+    float qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (!(ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+        float recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+        ax *= recipNorm; ay *= recipNorm; az *= recipNorm;
+        recipNorm = invSqrt(mx * mx + my * my + mz * mz);
+        mx *= recipNorm; my *= recipNorm; mz *= recipNorm;
+
+        const float _2q0mx = 2.0f * q0 * mx;
+        const float _2q0my = 2.0f * q0 * my;
+        const float _2q0mz = 2.0f * q0 * mz;
+        const float _2q1mx = 2.0f * q1 * mx;
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _2q0q2 = 2.0f * q0 * q2;
+        const float _2q2q3 = 2.0f * q2 * q3;
+        const float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        const float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        const float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // Dirección de referencia del campo magnético terrestre
+        const float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2
+                         + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+        const float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1
+                         + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+        const float _2bx = std::sqrt(hx * hx + hy * hy);
+        const float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1
+                           + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+        const float _4bx = 2.0f * _2bx;
+        const float _4bz = 2.0f * _2bz;
+
+        // Paso de descenso de gradiente
+        const float fax = 2.0f * q1q3 - _2q0q2 - ax;
+        const float fay = 2.0f * q0q1 + _2q2q3 - ay;
+        const float faz = 1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az;
+        const float fmx = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+        const float fmy = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+        const float fmz = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+        float s0 = -_2q2 * fax + _2q1 * fay - _2bz * q2 * fmx + (-_2bx * q3 + _2bz * q1) * fmy
+                   + _2bx * q2 * fmz;
+        float s1 = _2q3 * fax + _2q0 * fay - 4.0f * q1 * faz + _2bz * q3 * fmx
+                   + (_2bx * q2 + _2bz * q0) * fmy + (_2bx * q3 - _4bz * q1) * fmz;
+        float s2 = -_2q0 * fax + _2q3 * fay - 4.0f * q2 * faz + (-_4bx * q2 - _2bz * q0) * fmx
+                   + (_2bx * q1 + _2bz * q3) * fmy + (_2bx * q0 - _4bz * q2) * fmz;
+        float s3 = _2q1 * fax + _2q2 * fay + (-_4bx * q3 + _2bz * q1) * fmx
+                   + (-_2bx * q0 + _2bz * q2) * fmy + _2bx * q1 * fmz;
+        const float sn = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sn > 0.0f) {
+            recipNorm = invSqrt(sn);
+            qDot1 -= beta * s0 * recipNorm;
+            qDot2 -= beta * s1 * recipNorm;
+            qDot3 -= beta * s2 * recipNorm;
+            qDot4 -= beta * s3 * recipNorm;
+        }
+    }
+
+    q0 += qDot1 * dt; q1 += qDot2 * dt; q2 += qDot3 * dt; q3 += qDot4 * dt;
+    const float recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    m_q0 = q0 * recipNorm; m_q1 = q1 * recipNorm; m_q2 = q2 * recipNorm; m_q3 = q3 * recipNorm;
+}
+
+
+
+// Filtro de Madgwick solo con acelerómetro y giróscopo. Giro en rad/s.
+void ImuEngine::madgwickImu(float gx, float gy, float gz, float ax, float ay, float az, float dt){
+    float q0 = m_q0, q1 = m_q1, q2 = m_q2, q3 = m_q3;
+    const float beta = m_warmup > 0 ? 2.5f : m_settings.beta;
+
+    float qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (!(ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+        float recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+        ax *= recipNorm; ay *= recipNorm; az *= recipNorm;
+
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1
+                   + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2
+                   + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        const float sn = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sn > 0.0f) {
+            recipNorm = invSqrt(sn);
+            qDot1 -= beta * s0 * recipNorm;
+            qDot2 -= beta * s1 * recipNorm;
+            qDot3 -= beta * s2 * recipNorm;
+            qDot4 -= beta * s3 * recipNorm;
+        }
+    }
+
+    q0 += qDot1 * dt; q1 += qDot2 * dt; q2 += qDot3 * dt; q3 += qDot4 * dt;
+    const float recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    m_q0 = q0 * recipNorm; m_q1 = q1 * recipNorm; m_q2 = q2 * recipNorm; m_q3 = q3 * recipNorm;
+}
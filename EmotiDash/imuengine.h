@@ -0,0 +1,152 @@
+/**
+*  file ImuEngine.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef IMUENGINE_H
+#define IMUENGINE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "dspfilters.h"
+#include "timeseriesstore.h"
+
+/*!
+ * \class ImuEngine
+ * \brief Orientación y actividad a partir de los nueve canales de movimiento (AX..MZ).
+ *
+ * Cada eje llega en su propio paquete, así que las muestras se acumulan por eje en colas SoA,
+ * con sus tiempos, y se emparejan por tiempo: un instante se procesa cuando acelerómetro y
+ * giróscopo (y magnetómetro, si el dispositivo lo envía) tienen una muestra a menos de medio
+ * periodo de muestreo. Las muestras sin pareja (un paquete perdido en otro eje, o
+ * magnetómetro que llega tarde) se descartan, de modo que un eje nunca queda desplazado.
+ *
+ * Por bloque:
+ * - Pasos vectorizables (bucles sin dependencias sobre vectores contiguos): conversión del
+ *   giróscopo a rad/s y módulos de aceleración y velocidad angular.
+ * - Filtro de Madgwick (MARG con magnetómetro, IMU sin él), que es recursivo y se evalúa
+ *   muestra a muestra; publica roll, pitch y yaw en grados.
+ * - Actividad: RMS de la aceleración dinámica (|a| − 1 g) en una ventana deslizante.
+ * - Pasos: picos de la aceleración dinámica filtrada con periodo mínimo entre pasos.
+ * - Inquietud (fidget): ráfagas de giro que no forman parte de una marcha.
+ * - Quietud: actividad y giro por debajo de umbral durante toda la ventana.
+ *
+ * Canales del PC: H_ROLL, H_PITCH, H_YAW, H_ACT (25 Hz), H_STEP y H_FIDG (contadores, por
+ * evento) y H_STILL (1/0, al cambiar).
+ *
+ * \see EmotiBitController, Biquad
+ * \author Enrique Fuentes
+ * \date 2025-05-26
+ */
+class ImuEngine {
+public:
+    struct Settings {
+        double sampleHz          = 25.0;
+        float  beta              = 0.1f;   // ganancia del filtro de Madgwick
+        double windowSeconds     = 2.0;    // ventana de actividad y quietud
+        double stepThresholdG    = 0.15;   // pico mínimo de aceleración dinámica para un paso
+        double minStepSeconds    = 0.3;
+        double fidgetGyroDps     = 60.0;   // giro mínimo para una ráfaga de inquietud
+        double minFidgetSeconds  = 0.5;
+        double stillActivityG    = 0.02;   // RMS de actividad máximo para quietud
+        double stillGyroDps      = 5.0;    // RMS de giro máximo para quietud
+    };
+
+    ImuEngine();
+    explicit ImuEngine(const Settings &settings);
+
+    static bool isImuChannel(const QString &channelID);
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+    void reset();
+
+    // Añade las muestras de un eje; procesa los instantes ya completos en todos los ejes
+    void addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n);
+
+    // Resultados de la última llamada a addSamples()
+    const SampleBatch &roll() const      { return m_rollOut; }
+    const SampleBatch &pitch() const     { return m_pitchOut; }
+    const SampleBatch &yaw() const       { return m_yawOut; }
+    const SampleBatch &activity() const  { return m_activityOut; }
+    const SampleBatch &steps() const     { return m_stepOut; }
+    const SampleBatch &fidgets() const   { return m_fidgetOut; }
+    const SampleBatch &stillness() const { return m_stillOut; }
+
+private:
+    enum Axis { AX, AY, AZ, GX, GY, GZ, MX, MY, MZ, AxisCount };
+
+    /// Ventana deslizante con suma de cuadrados
+    struct RmsWindow {
+        std::vector<float> ring;
+        int pos = 0;
+        int filled = 0;
+        double sum2 = 0.0;
+
+        void resize(int n) { ring.assign(std::max(1, n), 0.0f); pos = filled = 0; sum2 = 0.0; }
+        void push(float x) {
+            sum2 += double(x) * x - double(ring[pos]) * ring[pos];
+            ring[pos] = x;
+            pos = (pos + 1) % int(ring.size());
+            if (filled < int(ring.size())) ++filled;
+        }
+        bool full() const { return filled == int(ring.size()); }
+        double rms() const { return filled ? std::sqrt(std::max(0.0, sum2) / filled) : 0.0; }
+    };
+
+    void processReady();
+    void processBlock(int k);
+    void madgwick(float gx, float gy, float gz, float ax, float ay, float az,
+                  float mx, float my, float mz, float dt);
+    void madgwickImu(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+    Settings m_settings;
+
+    // Colas SoA por eje pendientes de emparejar (valores, tiempos y primera sin consumir)
+    std::vector<float> m_pending[AxisCount];
+    std::vector<qint64> m_pendingT[AxisCount];
+    size_t m_head[AxisCount] = {};
+    bool m_magSeen = false;
+
+    // Bloque de instantes emparejados (SoA) reutilizado entre llamadas
+    std::vector<float> m_block[AxisCount];
+    std::vector<qint64> m_blockT;
+    std::vector<quint8> m_blockHasMag;
+    std::vector<float> m_gyroMag, m_accDyn;
+
+    // Estado de la fusión
+    float m_q0 = 1.0f, m_q1 = 0.0f, m_q2 = 0.0f, m_q3 = 0.0f;
+    qint64 m_lastT = 0;
+    bool m_primed = false;
+    int m_warmup = 0;                   // muestras con ganancia alta para converger al inicio
+
+    // Actividad, pasos, inquietud y quietud
+    Biquad m_stepFilter;
+    RmsWindow m_accWindow, m_gyroWindow;
+    float m_s1 = 0.0f, m_s2 = 0.0f;     // últimas muestras filtradas para localizar picos
+    qint64 m_lastStepT = 0;
+    qint64 m_lastFidgetT = 0;
+    bool m_fidgetActive = false;
+    int m_stepCount = 0;
+    int m_fidgetCount = 0;
+    int m_still = -1;                   // -1: aún sin publicar
+
+    SampleBatch m_rollOut, m_pitchOut, m_yawOut, m_activityOut, m_stepOut, m_fidgetOut, m_stillOut;
+};
+
+#endif // IMUENGINE_H
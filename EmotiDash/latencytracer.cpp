@@ -0,0 +1,215 @@
+/****************************************************************************
+ * LatencyTracer.cpp
+ *
+ * Descripción: Trazado de latencia por etapas (socket, decodificación,
+ * controlador, gráfica y pantalla) con histogramas logarítmicos.
+ *
+ * Fecha: 2025-06-05
+ ****************************************************************************/
+
+#include "latencytracer.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <chrono>
+
+// ---------------------------------------------------------------------------
+//      Histogram
+// ---------------------------------------------------------------------------
+
+void LatencyTracer::Histogram::add(qint64 us){
+    us = std::max<qint64>(0, us);
+    ++m_counts[bucketOf(us)];
+    ++m_count;
+    m_sumUs += double(us);
+    m_maxUs = std::max(m_maxUs, us);
+}
+
+
+
+void LatencyTracer::Histogram::clear(){
+    m_counts.fill(0);
+    m_count = 0;
+    m_sumUs = 0.0;
+    m_maxUs = 0;
+}
+
+
+
+/**
+ * @param p Percentil entre 0 y 1.
+ * @return Límite superior del cubo que contiene el percentil, en ms (error relativo < 25 %).
+ */
+double LatencyTracer::Histogram::percentileMs(double p) const {
+    if (m_count == 0) return 0.0;
+    const quint64 target = std::max<quint64>(1, quint64(std::clamp(p, 0.0, 1.0) * m_count + 0.5));
+    quint64 seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += m_counts[b];
+        if (seen >= target)
+            return std::min(upperBound(b), m_maxUs) / 1000.0;
+    }
+    return m_maxUs / 1000.0;
+}
+
+
+
+// Cubo = 4 × octava + los dos bits siguientes al más significativo
+int LatencyTracer::Histogram::bucketOf(qint64 us){
+    if (us < 1) return 0;
+    const int e = 63 - qCountLeadingZeroBits(quint64(us));
+    const int sub = e >= 2 ? int((us >> (e - 2)) & 3) : 0;
+    return std::min(kBuckets - 1, e * 4 + sub);
+}
+
+
+
+qint64 LatencyTracer::Histogram::upperBound(int bucket){
+    const int e = bucket / 4;
+    const int sub = bucket % 4;
+    return e < 2 ? (qint64(1) << (e + 1)) : (qint64(4 + sub + 1) << (e - 2));
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      LatencyTracer
+// ---------------------------------------------------------------------------
+
+qint64 LatencyTracer::nowNs(){
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+QString LatencyTracer::stageName(Stage stage){
+    switch (stage) {
+    case SocketToDecode:     return QStringLiteral("socket→decode");
+    case DecodeToController: return QStringLiteral("decode→controller");
+    case ControllerToPlot:   return QStringLiteral("controller→plot");
+    case PlotToPresent:      return QStringLiteral("plot→present");
+    case EndToEnd:           return QStringLiteral("end-to-end");
+    case DeviceLag:          return QStringLiteral("device lag");
+    default:                 return QString();
+    }
+}
+
+
+
+/**
+ * Registra las etapas del hilo de datos y el retraso del reloj del dispositivo de un paquete.
+ *
+ * @param rxNs Instante de lectura del datagrama.
+ * @param decodeNs Instante en que el paquete quedó separado y con la cabecera leída.
+ * @param deviceMs Marca de tiempo del dispositivo (ms desde su arranque).
+ */
+void LatencyTracer::packetReceived(qint64 rxNs, qint64 decodeNs, qint64 deviceMs){
+    const qint64 now = nowNs();
+    m_packetRxNs = rxNs;
+    m_hist[SocketToDecode].add((decodeNs - rxNs) / 1000);
+    m_hist[DecodeToController].add((now - decodeNs) / 1000);
+
+    const double offsetMs = rxNs / 1e6 - double(deviceMs);
+    if (!m_hasOffset || offsetMs < m_minOffsetMs) {
+        m_minOffsetMs = offsetMs;
+        m_hasOffset = true;
+    }
+    m_hist[DeviceLag].add(qint64((offsetMs - m_minOffsetMs) * 1000.0));
+}
+
+
+
+/**
+ * Deja una sonda del último paquete recibido en el canal.
+ *
+ * @param channelID Canal en el que se han guardado las muestras.
+ * @param epoch Época del anillo del canal tras guardarlas.
+ */
+void LatencyTracer::samplesStored(const QString &channelID, quint64 epoch){
+    auto &probes = m_pending[channelID];
+    if (int(probes.size()) >= kMaxProbes)
+        probes.pop_front();      // canal que ninguna gráfica muestra
+    Probe probe;
+    probe.epoch = epoch;
+    probe.rxNs = m_packetRxNs;
+    probe.storedNs = nowNs();
+    probes.push_back(probe);
+}
+
+
+
+/**
+ * Pasa al fotograma las sondas del canal cuya época ya está incluida en él.
+ *
+ * @param channelID Canal dibujado.
+ * @param epoch Época del anillo hasta la que llega el fotograma.
+ * @param frame Sondas del fotograma.
+ */
+void LatencyTracer::framePrepared(const QString &channelID, quint64 epoch, std::vector<Probe> &frame){
+    auto it = m_pending.find(channelID);
+    if (it == m_pending.end()) return;
+    auto &probes = it.value();
+    const qint64 now = nowNs();
+    while (!probes.empty() && probes.front().epoch <= epoch) {
+        Probe probe = probes.front();
+        probes.pop_front();
+        probe.plottedNs = now;
+        m_hist[ControllerToPlot].add((now - probe.storedNs) / 1000);
+        frame.push_back(probe);
+    }
+}
+
+
+
+/**
+ * Cierra las sondas de un fotograma recién pintado.
+ *
+ * @param frame Sondas del fotograma; se vacía.
+ */
+void LatencyTracer::framePresented(std::vector<Probe> &frame){
+    const qint64 now = nowNs();
+    for (const Probe &probe : frame) {
+        m_hist[PlotToPresent].add((now - probe.plottedNs) / 1000);
+        m_hist[EndToEnd].add((now - probe.rxNs) / 1000);
+    }
+    frame.clear();
+}
+
+
+
+/**
+ * @return Percentiles de cada etapa desde el último resetHistograms() y cumplimiento del objetivo.
+ */
+LatencyTracer::Report LatencyTracer::report() const {
+    Report r;
+    for (int s = 0; s < StageCount; ++s) {
+        const Histogram &h = m_hist[s];
+        StageSummary &out = r.stages[s];
+        out.count = h.count();
+        out.p50Ms = h.percentileMs(0.50);
+        out.p95Ms = h.percentileMs(0.95);
+        out.p99Ms = h.percentileMs(0.99);
+        out.maxMs = h.maxMs();
+    }
+    r.sloMs = m_sloMs;
+    r.sloMet = r.stages[EndToEnd].count == 0 || r.stages[EndToEnd].p95Ms <= m_sloMs;
+    return r;
+}
+
+
+
+void LatencyTracer::resetHistograms(){
+    for (Histogram &h : m_hist)
+        h.clear();
+}
+
+
+
+void LatencyTracer::clear(){
+    resetHistograms();
+    m_pending.clear();
+    m_hasOffset = false;
+    m_packetRxNs = 0;
+}
@@ -0,0 +1,140 @@
+/**
+*  file LatencyTracer.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QHash>
+#include <array>
+#include <deque>
+#include <vector>
+
+/*!
+ * \class LatencyTracer
+ * \brief Latencia de extremo a extremo de los datos en vivo, desde el datagrama hasta el píxel.
+ *
+ * Cada datagrama se marca con un reloj monotónico al leerlo del socket y cada paquete al
+ * terminar de separarlo y leer su cabecera (hilo de datos). El controlador registra cuándo lo
+ * procesa y, tras guardar las muestras en el anillo del canal, deja una sonda con la época del
+ * anillo. Cuando una gráfica lanza un fotograma que ya incluye esa época la sonda pasa al
+ * fotograma, y cuando ese fotograma se pinta se cierra. Así se obtienen las etapas:
+ * - SocketToDecode: lectura del datagrama → paquete separado;
+ * - DecodeToController: cola entre el hilo de datos y el controlador;
+ * - ControllerToPlot: muestras guardadas → fotograma que las incluye;
+ * - PlotToPresent: fotograma lanzado → pintado en pantalla;
+ * - EndToEnd: datagrama → pintado;
+ * - DeviceLag: retraso del reloj del dispositivo respecto al PC, relativo al mínimo observado
+ *   (los relojes no están sincronizados, así que solo se mide la variación).
+ *
+ * Cada etapa acumula un histograma logarítmico (4 cubos por octava, desde 1 µs) con coste
+ * constante por muestra. Todo se usa desde el hilo de la interfaz salvo nowNs(), que también
+ * se llama desde el hilo de datos.
+ *
+ * \see EmotiBitController, StripChart
+ * \author Enrique Fuentes
+ * \date 2025-06-05
+ */
+class LatencyTracer {
+public:
+    enum Stage {
+        SocketToDecode,
+        DecodeToController,
+        ControllerToPlot,
+        PlotToPresent,
+        EndToEnd,
+        DeviceLag,
+        StageCount
+    };
+
+    class Histogram {
+    public:
+        static constexpr int kBuckets = 4 * 40;   // hasta ~2^40 µs
+
+        void add(qint64 us);
+        void clear();
+        quint64 count() const { return m_count; }
+        double meanMs() const { return m_count ? m_sumUs / m_count / 1000.0 : 0.0; }
+        double maxMs() const { return m_maxUs / 1000.0; }
+        double percentileMs(double p) const;
+
+    private:
+        static int bucketOf(qint64 us);
+        static qint64 upperBound(int bucket);
+
+        std::array<quint32, kBuckets> m_counts {};
+        quint64 m_count = 0;
+        double m_sumUs = 0.0;
+        qint64 m_maxUs = 0;
+    };
+
+    /// Marca de un paquete en camino hacia la pantalla.
+    struct Probe {
+        quint64 epoch = 0;        // época del anillo tras guardar el paquete
+        qint64 rxNs = 0;
+        qint64 storedNs = 0;
+        qint64 plottedNs = 0;
+    };
+
+    struct StageSummary {
+        quint64 count = 0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    struct Report {
+        std::array<StageSummary, StageCount> stages;
+        double sloMs = 0.0;
+        bool sloMet = true;       // p95 de EndToEnd dentro del objetivo
+    };
+
+    // Reloj monotónico común a todos los hilos
+    static qint64 nowNs();
+    static QString stageName(Stage stage);
+
+    // Controlador
+    void packetReceived(qint64 rxNs, qint64 decodeNs, qint64 deviceMs);
+    void samplesStored(const QString &channelID, quint64 epoch);
+
+    // Gráficas: sondas incluidas en un fotograma y cierre al pintarlo
+    void framePrepared(const QString &channelID, quint64 epoch, std::vector<Probe> &frame);
+    void framePresented(std::vector<Probe> &frame);
+
+    // Objetivo de latencia de extremo a extremo (p95)
+    void setSlo(double endToEndMs) { m_sloMs = endToEndMs; }
+    double slo() const { return m_sloMs; }
+
+    const Histogram &histogram(Stage stage) const { return m_hist[stage]; }
+    Report report() const;
+    void resetHistograms();
+    void clear();
+
+private:
+    static constexpr int kMaxProbes = 64;   // sondas pendientes por canal
+
+    std::array<Histogram, StageCount> m_hist;
+    QHash<QString, std::deque<Probe>> m_pending;
+    qint64 m_packetRxNs = 0;
+    double m_minOffsetMs = 0.0;
+    bool m_hasOffset = false;
+    double m_sloMs = 100.0;
+};
+
+#endif // LATENCYTRACER_H
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * MinMaxPyramid.cpp
+ *
+ * Descripción: Pirámide incremental de resúmenes mínimo/máximo/media a
+ * resoluciones potencia de dos, para dibujar la sesión completa a
+ * cualquier zoom en un tiempo proporcional al número de píxeles.
+ *
+ * Fecha: 2025-06-02
+ ****************************************************************************/
+
+#include "minmaxpyramid.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @param leafSamples Muestras por intervalo del nivel 0. Por debajo de esa resolución se dibuja
+ *        desde las muestras en bruto.
+ */
+MinMaxPyramid::MinMaxPyramid(int leafSamples)
+    : m_leafSamples(std::max(2, leafSamples))
+{
+}
+
+
+
+void MinMaxPyramid::append(const qint64 *tUs, const float *values, int n){
+    for (int i = 0; i < n; ++i)
+        append(tUs[i], values[i]);
+}
+
+
+
+/**
+ * Añade una muestra al intervalo abierto del nivel 0; al completarlo lo sube por la pirámide.
+ *
+ * @param tUs Tiempo en microsegundos (no decreciente).
+ * @param value Valor de la muestra.
+ */
+void MinMaxPyramid::append(qint64 tUs, float value){
+    if (m_openCount == 0) {
+        m_open.tStart = tUs;
+        m_open.vMin = m_open.vMax = value;
+        m_openSum = 0.0;
+    } else {
+        m_open.vMin = std::min(m_open.vMin, value);
+        m_open.vMax = std::max(m_open.vMax, value);
+    }
+    m_open.tEnd = tUs;
+    m_openSum += value;
+
+    if (m_sampleCount == 0) m_firstT = tUs;
+    m_lastT = tUs;
+    ++m_sampleCount;
+
+    if (++m_openCount == m_leafSamples) {
+        m_open.mean = float(m_openSum / m_openCount);
+        push(0, m_open);
+        m_openCount = 0;
+    }
+}
+
+
+
+void MinMaxPyramid::clear(){
+    m_levels.clear();
+    m_openCount = 0;
+    m_openSum = 0.0;
+    m_sampleCount = 0;
+    m_firstT = m_lastT = 0;
+}
+
+
+
+/**
+ * @return Memoria ocupada por todos los niveles.
+ */
+size_t MinMaxPyramid::memoryBytes() const {
+    size_t bytes = m_levels.capacity() * sizeof(std::vector<Bin>);
+    for (const auto &level : m_levels)
+        bytes += level.capacity() * sizeof(Bin);
+    return bytes;
+}
+
+
+
+// Guarda un intervalo completo y, si cierra una pareja, sube la unión al nivel siguiente
+void MinMaxPyramid::push(int level, const Bin &bin){
+    if (level == int(m_levels.size()))
+        m_levels.emplace_back();
+
+    auto &bins = m_levels[level];
+    bins.push_back(bin);
+    if (bins.size() % 2 != 0) return;
+
+    const Bin &a = bins[bins.size() - 2];
+    Bin merged;
+    merged.tStart = a.tStart;
+    merged.tEnd = bin.tEnd;
+    merged.vMin = std::min(a.vMin, bin.vMin);
+    merged.vMax = std::max(a.vMax, bin.vMax);
+    merged.mean = 0.5f * (a.mean + bin.mean);      // ambos resumen el mismo número de muestras
+    push(level + 1, merged);
+}
+
+
+
+/**
+ * Elige el nivel más grueso cuyos intervalos no superan una columna, a partir de la densidad
+ * media de muestras de la sesión.
+ *
+ * @param t0Us Inicio de la vista.
+ * @param t1Us Fin de la vista.
+ * @param columns Columnas de píxel de la vista.
+ * @return Nivel de la pirámide, o -1 si cada columna tiene menos muestras que un intervalo del nivel 0.
+ */
+int MinMaxPyramid::levelFor(qint64 t0Us, qint64 t1Us, int columns) const {
+    if (m_levels.empty() || columns <= 0 || t1Us <= t0Us) return -1;
+
+    const double span = double(std::max<qint64>(1, m_lastT - m_firstT));
+    const double perColumn = double(m_sampleCount) / span * double(t1Us - t0Us) / columns;
+    if (perColumn < m_leafSamples) return -1;
+
+    int level = 0;
+    while (level + 1 < levelCount() && double(samplesPerBin(level + 1)) <= perColumn)
+        ++level;
+    return level;
+}
+
+
+
+/**
+ * Resume [t0Us, t1Us] en columnas de píxel usando el nivel adecuado. Se recorren los intervalos
+ * completos del nivel que tocan la vista y, al final, el único intervalo sin pareja de cada nivel
+ * inferior y el intervalo abierto, para que la vista llegue hasta la última muestra.
+ *
+ * @param t0Us Inicio de la vista.
+ * @param t1Us Fin de la vista.
+ * @param columns Columnas de píxel.
+ * @param out Resumen por columna (count == 0 en las columnas sin datos).
+ * @return false si la vista necesita las muestras en bruto (out queda vacío).
+ */
+bool MinMaxPyramid::render(qint64 t0Us, qint64 t1Us, int columns, std::vector<Column> &out) const {
+    out.assign(size_t(std::max(0, columns)), Column());
+    const int level = levelFor(t0Us, t1Us, columns);
+    if (level < 0) return false;
+
+    const double usPerColumn = double(t1Us - t0Us) / columns;
+    std::vector<double> sums(size_t(columns), 0.0);
+
+    auto add = [&](const Bin &b, int count) {
+        if (b.tEnd < t0Us || b.tStart > t1Us) return;
+        const qint64 mid = std::clamp(b.tStart + (b.tEnd - b.tStart) / 2, t0Us, t1Us);
+        const int c = std::min(columns - 1, int((mid - t0Us) / usPerColumn));
+        Column &col = out[c];
+        if (col.count == 0) {
+            col.vMin = b.vMin;
+            col.vMax = b.vMax;
+        } else {
+            col.vMin = std::min(col.vMin, b.vMin);
+            col.vMax = std::max(col.vMax, b.vMax);
+        }
+        col.count += count;
+        sums[c] += double(b.mean) * count;
+    };
+
+    const auto &bins = m_levels[level];
+    auto it = std::lower_bound(bins.begin(), bins.end(), t0Us,
+                               [](const Bin &b, qint64 t) { return b.tEnd < t; });
+    for (; it != bins.end() && it->tStart <= t1Us; ++it)
+        add(*it, samplesPerBin(level));
+
+    // Cola posterior al último intervalo completo del nivel elegido
+    qint64 covered = bins.empty() ? std::numeric_limits<qint64>::min() : bins.back().tEnd;
+    for (int l = level - 1; l >= 0; --l) {
+        const Bin &last = m_levels[l].back();
+        if (last.tStart > covered) {
+            add(last, samplesPerBin(l));
+            covered = last.tEnd;
+        }
+    }
+    if (m_openCount > 0) {
+        Bin open = m_open;
+        open.mean = float(m_openSum / m_openCount);
+        add(open, m_openCount);
+    }
+
+    for (int c = 0; c < columns; ++c)
+        if (out[c].count > 0)
+            out[c].mean = float(sums[c] / out[c].count);
+    return true;
+}
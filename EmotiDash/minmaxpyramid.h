@@ -0,0 +1,99 @@
+/**
+*  file MinMaxPyramid.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QtGlobal>
+#include <vector>
+#include <cstddef>
+
+/*!
+ * \class MinMaxPyramid
+ * \brief Resúmenes mínimo/máximo/media de un canal a resoluciones potencia de dos.
+ *
+ * El nivel 0 agrupa las muestras de leafSamples en leafSamples; cada nivel siguiente junta dos
+ * intervalos completos del anterior. La pirámide se construye a medida que llegan las muestras:
+ * cada intervalo que se cierra sube por los niveles mientras forme pareja, así que añadir una
+ * muestra cuesta O(1) amortizado y la memoria total es menos del doble del nivel 0.
+ *
+ * render() elige el nivel cuyos intervalos caben en una columna de píxel y recorre solo los
+ * intervalos de la vista, de modo que dibujar cualquier zoom cuesta un tiempo proporcional al
+ * número de columnas y no al de muestras. Por debajo del nivel 0 hay que leer las muestras en
+ * bruto (SessionStore), que en ese caso también son pocas por columna.
+ *
+ * \see SessionStore, StripChart
+ * \author Enrique Fuentes
+ * \date 2025-06-02
+ */
+class MinMaxPyramid {
+public:
+    struct Bin {
+        qint64 tStart = 0;
+        qint64 tEnd = 0;
+        float  vMin = 0.0f;
+        float  vMax = 0.0f;
+        float  mean = 0.0f;
+    };
+
+    /// Resumen de una columna de píxel de la vista.
+    struct Column {
+        float vMin = 0.0f;
+        float vMax = 0.0f;
+        float mean = 0.0f;
+        int   count = 0;      // muestras resumidas; 0 = columna vacía
+    };
+
+    explicit MinMaxPyramid(int leafSamples = 16);
+
+    void append(qint64 tUs, float value);
+    void append(const qint64 *tUs, const float *values, int n);
+    void clear();
+
+    int levelCount() const { return int(m_levels.size()); }
+    int binCount(int level) const { return int(m_levels[level].size()); }
+    const Bin &bin(int level, int i) const { return m_levels[level][i]; }
+    int samplesPerBin(int level) const { return m_leafSamples << level; }
+
+    quint64 sampleCount() const { return m_sampleCount; }
+    qint64 firstTime() const { return m_firstT; }
+    qint64 lastTime() const { return m_lastT; }
+    size_t memoryBytes() const;
+
+    // Nivel adecuado para dibujar [t0Us, t1Us] en 'columns' columnas; -1 si hacen falta las muestras
+    int levelFor(qint64 t0Us, qint64 t1Us, int columns) const;
+
+    // Resume [t0Us, t1Us] en 'columns' columnas; false si la vista pide más detalle que el nivel 0
+    bool render(qint64 t0Us, qint64 t1Us, int columns, std::vector<Column> &out) const;
+
+private:
+    void push(int level, const Bin &bin);
+
+    int m_leafSamples;
+    std::vector<std::vector<Bin>> m_levels;
+
+    // Intervalo del nivel 0 aún abierto
+    Bin m_open;
+    double m_openSum = 0.0;
+    int m_openCount = 0;
+
+    quint64 m_sampleCount = 0;
+    qint64 m_firstT = 0;
+    qint64 m_lastT = 0;
+};
+
+#endif // MINMAXPYRAMID_H
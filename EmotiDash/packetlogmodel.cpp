@@ -0,0 +1,153 @@
+/****************************************************************************
+ * PacketLogModel.cpp
+ *
+ * Descripción: Modelo de lista para el registro de paquetes recibidos.
+ * Anillo de capacidad fija, publicación agrupada una vez por fotograma y
+ * filtro por tipo de paquete.
+ *
+ * Fecha: 2025-06-04
+ ****************************************************************************/
+
+#include "packetlogmodel.h"
+#include <algorithm>
+
+/**
+ * @param capacity Número máximo de líneas guardadas.
+ * @param parent Objeto padre.
+ */
+PacketLogModel::PacketLogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent),
+    m_capacity(std::max(1, capacity)),
+    m_ring(size_t(m_capacity))
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFrameMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &PacketLogModel::flush);
+}
+
+
+
+int PacketLogModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+
+
+QVariant PacketLogModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= int(m_rows.size())) return QVariant();
+    const Entry &e = entryAt(m_rows[size_t(index.row())]);
+    switch (role) {
+    case Qt::DisplayRole:
+        return e.text;
+    case Qt::ToolTipRole:
+        return e.tag;
+    default:
+        return QVariant();
+    }
+}
+
+
+
+/**
+ * Deja la línea pendiente y arma la publicación del fotograma si no lo estaba.
+ *
+ * @param line Paquete o mensaje recibido.
+ */
+void PacketLogModel::append(const QString &line){
+    if (int(m_pending.size()) >= m_capacity) {
+        // Más líneas en un fotograma de las que caben: las antiguas nunca llegarían a verse
+        m_pending.pop_front();
+        ++m_dropped;
+    }
+    m_pending.push_back({ line, tagOf(line) });
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+
+
+void PacketLogModel::clear(){
+    beginResetModel();
+    m_rows.clear();
+    m_pending.clear();
+    m_nextSeq = 0;
+    std::fill(m_ring.begin(), m_ring.end(), Entry());
+    endResetModel();
+}
+
+
+
+/**
+ * Cambia las etiquetas visibles y reconstruye las filas a partir del anillo.
+ *
+ * @param tags Etiquetas a mostrar; vacío para mostrarlas todas.
+ */
+void PacketLogModel::setTagFilter(const QStringList &tags){
+    QSet<QString> filter;
+    for (const QString &tag : tags) {
+        const QString t = tag.trimmed().toUpper();
+        if (!t.isEmpty()) filter.insert(t);
+    }
+    if (filter == m_filter) return;
+
+    beginResetModel();
+    m_filter = filter;
+    m_rows.clear();
+    const quint64 oldest = m_nextSeq > quint64(m_capacity) ? m_nextSeq - m_capacity : 0;
+    for (quint64 seq = oldest; seq < m_nextSeq; ++seq)
+        if (accepts(entryAt(seq))) m_rows.push_back(seq);
+    endResetModel();
+}
+
+
+
+/**
+ * @param line Línea del registro.
+ * @return Cuarto campo de un paquete EmotiBit (tipo de dato), o "MSG" para el resto.
+ */
+QString PacketLogModel::tagOf(const QString &line){
+    int start = 0;
+    for (int field = 0; field < 3; ++field) {
+        start = line.indexOf(',', start);
+        if (start < 0) return QStringLiteral("MSG");
+        ++start;
+    }
+    const int end = line.indexOf(',', start);
+    if (end < 0 || end - start > 4) return QStringLiteral("MSG");
+    return line.mid(start, end - start);
+}
+
+
+
+// Publica de una vez las líneas del fotograma: quita las filas expulsadas del anillo y añade las nuevas
+void PacketLogModel::flush(){
+    if (m_pending.empty()) return;
+
+    std::vector<quint64> added;
+    added.reserve(m_pending.size());
+    for (Entry &e : m_pending) {
+        const bool visible = accepts(e);
+        m_ring[size_t(m_nextSeq % m_capacity)] = std::move(e);
+        if (visible) added.push_back(m_nextSeq);
+        ++m_nextSeq;
+    }
+    m_pending.clear();
+
+    // Filas cuya entrada ya se ha sobrescrito
+    const quint64 oldest = m_nextSeq > quint64(m_capacity) ? m_nextSeq - m_capacity : 0;
+    int expired = 0;
+    while (expired < int(m_rows.size()) && m_rows[size_t(expired)] < oldest) ++expired;
+    if (expired > 0) {
+        beginRemoveRows(QModelIndex(), 0, expired - 1);
+        m_rows.erase(m_rows.begin(), m_rows.begin() + expired);
+        endRemoveRows();
+    }
+
+    // Las nuevas que también se hayan sobrescrito en este mismo lote no se publican
+    auto first = std::lower_bound(added.begin(), added.end(), oldest);
+    if (first == added.end()) return;
+    const int row = int(m_rows.size());
+    beginInsertRows(QModelIndex(), row, row + int(added.end() - first) - 1);
+    m_rows.insert(m_rows.end(), first, added.end());
+    endInsertRows();
+}
@@ -0,0 +1,95 @@
+/**
+*  file PacketLogModel.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef PACKETLOGMODEL_H
+#define PACKETLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QTimer>
+#include <deque>
+#include <vector>
+
+/*!
+ * \class PacketLogModel
+ * \brief Registro de paquetes y mensajes de capacidad fija para mostrar en un QListView.
+ *
+ * Sustituye al QTextBrowser de paquetes recibidos, que rehacía la maquetación de un documento
+ * cada vez más grande. Las líneas se guardan en un anillo de 'capacity' entradas: al llenarse,
+ * cada línea nueva expulsa la más antigua, así que la memoria y el coste de añadir no dependen
+ * de la duración de la sesión.
+ *
+ * append() no toca la vista: deja la línea pendiente y el modelo las publica todas juntas una
+ * vez por fotograma (un único beginInsertRows). Si en un fotograma llegan más líneas de las que
+ * caben en el anillo, las sobrantes se descartan y se cuentan en droppedLines().
+ *
+ * Cada línea lleva una etiqueta (el tipo de paquete EmotiBit, o "MSG" para los mensajes de
+ * texto) y setTagFilter() limita las filas visibles a unas etiquetas concretas.
+ *
+ * \see FormVistaEmotiBit
+ * \author Enrique Fuentes
+ * \date 2025-06-04
+ */
+class PacketLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit PacketLogModel(int capacity = 2000, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Encola una línea; se muestra en el siguiente fotograma
+    void append(const QString &line);
+    void clear();
+
+    // Etiquetas visibles (vacío = todas)
+    void setTagFilter(const QStringList &tags);
+    QStringList tagFilter() const { return m_filter.values(); }
+
+    int capacity() const { return m_capacity; }
+    quint64 droppedLines() const { return m_dropped; }
+
+    // Tipo de paquete EmotiBit (cuarto campo) o "MSG" si la línea no es un paquete
+    static QString tagOf(const QString &line);
+
+    static constexpr int kFrameMs = 16;
+
+private:
+    struct Entry {
+        QString text;
+        QString tag;
+    };
+
+    void flush();
+    bool accepts(const Entry &e) const { return m_filter.isEmpty() || m_filter.contains(e.tag); }
+    const Entry &entryAt(quint64 seq) const { return m_ring[size_t(seq % m_capacity)]; }
+
+    int m_capacity;
+    std::vector<Entry> m_ring;          // todas las líneas, indexadas por número de secuencia
+    quint64 m_nextSeq = 0;              // secuencia de la próxima línea publicada
+    std::deque<quint64> m_rows;         // secuencias visibles, en orden
+    std::deque<Entry> m_pending;        // líneas aún no publicadas
+    QSet<QString> m_filter;
+    QTimer m_flushTimer;
+    quint64 m_dropped = 0;
+};
+
+#endif // PACKETLOGMODEL_H
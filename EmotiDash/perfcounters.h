@@ -0,0 +1,75 @@
+/**
+*  file PerfCounters.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/*!
+ * \struct PerfCounters
+ * \brief Contadores de rendimiento sin bloqueos, escritos por cada etapa y leídos por PerfHud.
+ *
+ * Cada contador lo escribe un único hilo (el de datos, el del controlador o el de la interfaz)
+ * con operaciones atómicas relajadas, así que escribir no cuesta más que un incremento y leer
+ * desde el panel no detiene a nadie. Los acumulados solo crecen: el panel calcula las tasas por
+ * diferencia entre dos lecturas. Los indicadores (gauges) guardan el último valor medido.
+ *
+ * \see PerfHud, EmotiBitWiFiRoboTEA, EmotiBitController, FormPlot
+ * \author Enrique Fuentes
+ * \date 2025-06-06
+ */
+struct PerfCounters {
+    // Hilo de datos
+    std::atomic<quint64> datagrams {0};       // datagramas leídos del socket
+    std::atomic<quint64> packets {0};         // paquetes enviados al controlador
+    std::atomic<quint64> duplicates {0};      // datagramas repetidos por el envío múltiple (descartados)
+    std::atomic<quint64> dropped {0};         // paquetes perdidos según los huecos del número de paquete
+
+    // Controlador
+    std::atomic<quint64> handled {0};         // paquetes procesados
+    std::atomic<quint64> samples {0};         // muestras de sensor guardadas
+    std::atomic<qint64> recorderQueuedBytes {0};
+
+    // Gráficas
+    std::atomic<quint64> frames {0};          // fotogramas entregados por FrameScheduler
+    std::atomic<quint64> pointsDrawn {0};
+    std::atomic<quint64> skippedFrames {0};
+    std::atomic<int> renderJobs {0};          // rasterizados en curso en el pool
+
+    static void bump(std::atomic<quint64> &counter, quint64 n = 1) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+    template <typename T>
+    static void set(std::atomic<T> &gauge, T value) {
+        gauge.store(value, std::memory_order_relaxed);
+    }
+    template <typename T>
+    static T read(const std::atomic<T> &counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    // Paquetes emitidos por el hilo de datos que el controlador aún no ha procesado
+    quint64 queuedPackets() const {
+        const quint64 h = read(handled);
+        const quint64 p = read(packets);
+        return p > h ? p - h : 0;
+    }
+};
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,187 @@
+/****************************************************************************
+ * PerfHud.cpp
+ *
+ * Descripción: Panel superpuesto de rendimiento (fotogramas, puntos,
+ * muestras, colas, pérdidas, latencia y retraso del bucle de eventos).
+ *
+ * Fecha: 2025-06-06
+ ****************************************************************************/
+
+#include "perfhud.h"
+#include "framescheduler.h"
+#include <QPainter>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QEvent>
+#include <algorithm>
+
+namespace {
+constexpr int kMargin = 6;      // separación respecto al borde del padre
+constexpr int kPadding = 6;     // separación del texto al borde del panel
+}
+
+
+
+/**
+ * @param parent Widget sobre el que se superpone el panel.
+ */
+PerfHud::PerfHud(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    m_heartbeat.setTimerType(Qt::PreciseTimer);
+    m_heartbeat.setInterval(kHeartbeatMs);
+    connect(&m_heartbeat, &QTimer::timeout, this, &PerfHud::onHeartbeat);
+    m_refresh.setInterval(kRefreshMs);
+    connect(&m_refresh, &QTimer::timeout, this, &PerfHud::refresh);
+
+    parent->installEventFilter(this);
+    hide();
+}
+
+
+
+void PerfHud::setLatency(const LatencyTracer::Report &report){
+    m_latency = report;
+    m_hasLatency = true;
+}
+
+
+
+void PerfHud::showEvent(QShowEvent *event){
+    QWidget::showEvent(event);
+    // las tasas del primer periodo salen de los acumulados actuales
+    m_refreshClock.start();
+    m_beatClock.start();
+    if (m_counters) {
+        m_prevFrames = PerfCounters::read(m_counters->frames);
+        m_prevPoints = PerfCounters::read(m_counters->pointsDrawn);
+        m_prevSamples = PerfCounters::read(m_counters->samples);
+        m_prevPackets = PerfCounters::read(m_counters->packets);
+        m_prevDatagrams = PerfCounters::read(m_counters->datagrams);
+    }
+    m_lagMaxMs = m_lagSumMs = 0.0;
+    m_beats = 0;
+    m_heartbeat.start();
+    m_refresh.start();
+    raise();
+    refresh();
+}
+
+
+
+void PerfHud::hideEvent(QHideEvent *event){
+    m_heartbeat.stop();
+    m_refresh.stop();
+    QWidget::hideEvent(event);
+}
+
+
+
+// Sigue la esquina superior derecha del padre
+bool PerfHud::eventFilter(QObject *watched, QEvent *event){
+    if (watched == parent() && event->type() == QEvent::Resize)
+        reposition();
+    return QWidget::eventFilter(watched, event);
+}
+
+
+
+// Lo que tarda de más cada latido es tiempo en que el bucle de eventos estaba ocupado
+void PerfHud::onHeartbeat(){
+    const double elapsedMs = m_beatClock.nsecsElapsed() / 1e6;
+    m_beatClock.restart();
+    const double lagMs = std::max(0.0, elapsedMs - kHeartbeatMs);
+    m_lagMaxMs = std::max(m_lagMaxMs, lagMs);
+    m_lagSumMs += lagMs;
+    ++m_beats;
+}
+
+
+
+// Lee los contadores, calcula las tasas del periodo y rehace el texto
+void PerfHud::refresh(){
+    const double dt = std::max(1e-3, m_refreshClock.nsecsElapsed() / 1e9);
+    m_refreshClock.restart();
+    auto rate = [dt](quint64 now, quint64 &prev) {
+        const double r = (now - prev) / dt;
+        prev = now;
+        return r;
+    };
+
+    m_lines.clear();
+    if (m_counters) {
+        const PerfCounters &c = *m_counters;
+        const double fps = rate(PerfCounters::read(c.frames), m_prevFrames);
+        QString frameLine = QString("FPS %1").arg(fps, 0, 'f', 1);
+        if (m_scheduler) {
+            frameLine += QString(" / %1 Hz   fotograma %2 ms de %3")
+                             .arg(m_scheduler->refreshRate(), 0, 'f', 0)
+                             .arg(m_scheduler->averageWorkMs(), 0, 'f', 2)
+                             .arg(m_scheduler->frameBudgetMs(), 0, 'f', 1);
+        }
+        m_lines << frameLine;
+        m_lines << QString("Puntos/s %1   saltados %2   render %3")
+                       .arg(qRound64(rate(PerfCounters::read(c.pointsDrawn), m_prevPoints)))
+                       .arg(PerfCounters::read(c.skippedFrames))
+                       .arg(PerfCounters::read(c.renderJobs));
+        m_lines << QString("Muestras/s %1   paquetes/s %2   datagramas/s %3")
+                       .arg(qRound64(rate(PerfCounters::read(c.samples), m_prevSamples)))
+                       .arg(qRound64(rate(PerfCounters::read(c.packets), m_prevPackets)))
+                       .arg(qRound64(rate(PerfCounters::read(c.datagrams), m_prevDatagrams)));
+        m_lines << QString("Colas: red→ctrl %1   grabación %2 KiB")
+                       .arg(c.queuedPackets())
+                       .arg(PerfCounters::read(c.recorderQueuedBytes) / 1024);
+        m_lines << QString("Duplicados %1   perdidos %2")
+                       .arg(PerfCounters::read(c.duplicates))
+                       .arg(PerfCounters::read(c.dropped));
+    }
+
+    const auto &e2e = m_latency.stages[LatencyTracer::EndToEnd];
+    if (m_hasLatency && e2e.count > 0) {
+        m_lines << QString("Latencia p50 %1  p95 %2  p99 %3 ms%4")
+                       .arg(e2e.p50Ms, 0, 'f', 1).arg(e2e.p95Ms, 0, 'f', 1).arg(e2e.p99Ms, 0, 'f', 1)
+                       .arg(m_latency.sloMet ? QString() : QString("  > %1").arg(m_latency.sloMs, 0, 'f', 0));
+    } else {
+        m_lines << QString("Latencia: sin datos");
+    }
+
+    m_lines << QString("Bucle GUI: retraso medio %1 ms, máx %2 ms")
+                   .arg(m_beats ? m_lagSumMs / m_beats : 0.0, 0, 'f', 2)
+                   .arg(m_lagMaxMs, 0, 'f', 1);
+    m_lagMaxMs = m_lagSumMs = 0.0;
+    m_beats = 0;
+
+    const QFontMetrics fm(font());
+    int w = 0;
+    for (const QString &line : std::as_const(m_lines))
+        w = std::max(w, fm.horizontalAdvance(line));
+    resize(w + 2 * kPadding, int(m_lines.size()) * fm.lineSpacing() + 2 * kPadding);
+    reposition();
+    update();
+}
+
+
+
+void PerfHud::reposition(){
+    const QWidget *host = parentWidget();
+    if (!host) return;
+    move(std::max(0, host->width() - width() - kMargin), kMargin);
+}
+
+
+
+void PerfHud::paintEvent(QPaintEvent *){
+    QPainter p(this);
+    p.fillRect(rect(), QColor(0, 0, 0, 170));
+    p.setPen(Qt::white);
+    const QFontMetrics fm(font());
+    int y = kPadding + fm.ascent();
+    for (const QString &line : std::as_const(m_lines)) {
+        p.drawText(kPadding, y, line);
+        y += fm.lineSpacing();
+    }
+}
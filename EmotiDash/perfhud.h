@@ -0,0 +1,100 @@
+/**
+*  file PerfHud.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include "perfcounters.h"
+#include "latencytracer.h"
+
+class FrameScheduler;
+
+/*!
+ * \class PerfHud
+ * \brief Panel superpuesto con el rendimiento del tablero, para diagnosticar "gráficas lentas" sin perfilador.
+ *
+ * Se dibuja sobre la esquina superior derecha de su widget padre, no recibe el ratón y está
+ * oculto por defecto. Dos veces por segundo lee PerfCounters (sin bloqueos) y muestra:
+ * - fotogramas por segundo, trabajo medio por fotograma y presupuesto (FrameScheduler);
+ * - puntos dibujados por segundo, fotogramas saltados y rasterizados en curso;
+ * - muestras, paquetes y datagramas por segundo del dispositivo;
+ * - colas: paquetes pendientes entre el hilo de datos y el controlador y bytes por grabar;
+ * - datagramas duplicados y paquetes perdidos;
+ * - percentiles de latencia de extremo a extremo (último informe del controlador);
+ * - retraso del bucle de eventos de la interfaz.
+ *
+ * El retraso del bucle se mide con un temporizador de latido de 5 ms: lo que tarda de más
+ * cada latido es tiempo en que la interfaz no ha podido atender eventos. El latido solo
+ * funciona mientras el panel está visible.
+ *
+ * \see FormPlot, PerfCounters, LatencyTracer
+ * \author Enrique Fuentes
+ * \date 2025-06-06
+ */
+class PerfHud : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerfHud(QWidget *parent);
+
+    void setCounters(const PerfCounters *counters) { m_counters = counters; }
+    void setFrameScheduler(const FrameScheduler *scheduler) { m_scheduler = scheduler; }
+    void setLatency(const LatencyTracer::Report &report);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void onHeartbeat();
+    void refresh();
+    void reposition();
+
+    static constexpr int kHeartbeatMs = 5;
+    static constexpr int kRefreshMs = 500;
+
+    const PerfCounters *m_counters = nullptr;
+    const FrameScheduler *m_scheduler = nullptr;
+    LatencyTracer::Report m_latency;
+    bool m_hasLatency = false;
+
+    QTimer m_heartbeat;
+    QTimer m_refresh;
+    QElapsedTimer m_beatClock;
+    QElapsedTimer m_refreshClock;
+    double m_lagMaxMs = 0.0;      // retraso del bucle en el periodo actual
+    double m_lagSumMs = 0.0;
+    int m_beats = 0;
+
+    // Acumulados de la lectura anterior, para las tasas
+    quint64 m_prevFrames = 0;
+    quint64 m_prevPoints = 0;
+    quint64 m_prevSamples = 0;
+    quint64 m_prevPackets = 0;
+    quint64 m_prevDatagrams = 0;
+
+    QStringList m_lines;
+};
+
+#endif // PERFHUD_H
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * PlotDecimator.cpp
+ *
+ * Descripción: Diezmado de series para dibujar con mínimo/máximo por píxel
+ * o con LTTB, recalculado solo cuando cambia el rango o el ancho visible.
+ *
+ * Fecha: 2025-05-30
+ ****************************************************************************/
+
+#include "plotdecimator.h"
+#include <algorithm>
+#include <cmath>
+
+void PlotDecimator::setData(std::vector<double> x, std::vector<double> y){
+    const size_t n = std::min(x.size(), y.size());
+    x.resize(n);
+    y.resize(n);
+    m_x = std::move(x);
+    m_y = std::move(y);
+    m_valid = false;
+}
+
+
+
+void PlotDecimator::setMode(Mode mode){
+    if (mode == m_mode) return;
+    m_mode = mode;
+    m_valid = false;
+}
+
+
+
+/**
+ * Calcula los puntos a dibujar para el rango visible.
+ *
+ * @param x0 Inicio del rango visible.
+ * @param x1 Fin del rango visible.
+ * @param pixelWidth Ancho en píxeles del área de dibujo.
+ * @return true si los puntos han cambiado y hay que volver a cargarlos en la serie.
+ */
+bool PlotDecimator::update(double x0, double x1, int pixelWidth){
+    pixelWidth = std::max(1, pixelWidth);
+    if (x1 < x0) std::swap(x0, x1);
+    if (m_valid && x0 == m_x0 && x1 == m_x1 && pixelWidth == m_width)
+        return false;
+
+    m_valid = true;
+    m_x0 = x0;
+    m_x1 = x1;
+    m_width = pixelWidth;
+    m_points.clear();
+    if (m_x.empty()) return true;
+
+    // índices del rango visible más un punto a cada lado
+    int i0 = int(std::lower_bound(m_x.begin(), m_x.end(), x0) - m_x.begin());
+    int i1 = int(std::upper_bound(m_x.begin(), m_x.end(), x1) - m_x.begin());
+    i0 = std::max(0, i0 - 1);
+    i1 = std::min(int(m_x.size()), i1 + 1);
+    const int n = i1 - i0;
+
+    if (n <= 2 * pixelWidth || x1 <= x0) {
+        m_points.reserve(n);
+        for (int i = i0; i < i1; ++i)
+            m_points.append({m_x[size_t(i)], m_y[size_t(i)]});
+    } else if (m_mode == Mode::Lttb) {
+        lttb(m_x.data() + i0, m_y.data() + i0, n, 2 * pixelWidth, m_points);
+    } else {
+        minMax(m_x.data() + i0, m_y.data() + i0, n, x0, x1, pixelWidth, m_points);
+    }
+    return true;
+}
+
+
+
+/**
+ * Mínimo y máximo por columna. Los puntos fuera de [x0, x1] van a la primera o a la última
+ * columna, de modo que los puntos de borde se conservan.
+ */
+void PlotDecimator::minMax(const double *x, const double *y, int n, double x0, double x1,
+                           int buckets, QList<QPointF> &out){
+    out.clear();
+    if (n <= 0) return;
+    out.reserve(2 * buckets + 2);
+
+    const double scale = x1 > x0 ? buckets / (x1 - x0) : 0.0;
+    int current = -1;
+    int minIdx = 0, maxIdx = 0;
+
+    auto flush = [&]() {
+        if (current < 0) return;
+        const int a = std::min(minIdx, maxIdx);
+        const int b = std::max(minIdx, maxIdx);
+        out.append({x[a], y[a]});
+        if (b != a) out.append({x[b], y[b]});
+    };
+
+    for (int i = 0; i < n; ++i) {
+        const int bucket = std::clamp(int((x[i] - x0) * scale), 0, buckets - 1);
+        if (bucket != current) {
+            flush();
+            current = bucket;
+            minIdx = maxIdx = i;
+            continue;
+        }
+        if (y[i] < y[minIdx]) minIdx = i;
+        if (y[i] > y[maxIdx]) maxIdx = i;
+    }
+    flush();
+}
+
+
+
+/**
+ * Largest-Triangle-Three-Buckets: conserva el primer y el último punto y, en cada cubo
+ * intermedio, el que forma el triángulo de mayor área con el elegido en el cubo anterior y la
+ * media del siguiente.
+ */
+void PlotDecimator::lttb(const double *x, const double *y, int n, int threshold, QList<QPointF> &out){
+    out.clear();
+    if (n <= 0) return;
+    if (threshold >= n || threshold < 3) {
+        out.reserve(n);
+        for (int i = 0; i < n; ++i) out.append({x[i], y[i]});
+        return;
+    }
+
+    out.reserve(threshold);
+    const double every = double(n - 2) / double(threshold - 2);
+    int a = 0;
+    out.append({x[0], y[0]});
+
+    for (int i = 0; i < threshold - 2; ++i) {
+        // media del cubo siguiente
+        const int nextStart = int(std::floor((i + 1) * every)) + 1;
+        const int nextEnd = std::min(n, int(std::floor((i + 2) * every)) + 1);
+        double avgX = 0.0, avgY = 0.0;
+        for (int j = nextStart; j < nextEnd; ++j) { avgX += x[j]; avgY += y[j]; }
+        const int count = std::max(1, nextEnd - nextStart);
+        avgX /= count;
+        avgY /= count;
+
+        // punto del cubo actual con el triángulo más grande
+        const int start = int(std::floor(i * every)) + 1;
+        const int end = int(std::floor((i + 1) * every)) + 1;
+        double bestArea = -1.0;
+        int best = start;
+        for (int j = start; j < end; ++j) {
+            const double area = std::fabs((x[a] - avgX) * (y[j] - y[a]) - (x[a] - x[j]) * (avgY - y[a]));
+            if (area > bestArea) { bestArea = area; best = j; }
+        }
+        out.append({x[best], y[best]});
+        a = best;
+    }
+
+    out.append({x[n - 1], y[n - 1]});
+}
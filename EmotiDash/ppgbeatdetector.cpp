@@ -0,0 +1,184 @@
+/****************************************************************************
+ * PpgBeatDetector.cpp
+ *
+ * Descripción: Detector de latidos en línea sobre la señal PPG con filtro
+ * paso banda, umbral adaptativo por envolvente y métricas de HRV (RMSSD,
+ * SDNN, pNN50) calculadas de forma incremental en ventana deslizante.
+ *
+ * Fecha: 2025-05-25
+ ****************************************************************************/
+
+#include "ppgbeatdetector.h"
+#include <algorithm>
+#include <cmath>
+
+PpgBeatDetector::PpgBeatDetector()
+    : PpgBeatDetector(Settings())
+{
+}
+
+PpgBeatDetector::PpgBeatDetector(const Settings &settings)
+{
+    setSettings(settings);
+}
+
+
+
+/**
+ * Cambia la configuración del detector y reinicia su estado.
+ *
+ * @param settings Nueva configuración.
+ */
+void PpgBeatDetector::setSettings(const Settings &settings){
+    m_settings = settings;
+    m_highPass = Biquad::highPass(settings.lowCutHz, settings.sampleHz);
+    m_lowPass  = Biquad::lowPass(settings.highCutHz, settings.sampleHz);
+    m_envelopeDecay = settings.envelopeDecaySeconds > 0.0
+                          ? std::exp(-1.0 / (settings.envelopeDecaySeconds * settings.sampleHz))
+                          : 0.0;
+    reset();
+}
+
+
+
+void PpgBeatDetector::reset(){
+    m_highPass.reset();
+    m_lowPass.reset();
+    m_envelope = 0.0;
+    m_seen = 0;
+    m_hasPeak = false;
+    m_hasAccepted = false;
+    m_meanIbi = 0.0;
+    m_beats = 0;
+    m_ibis.clear();
+    m_diffs.clear();
+    m_sumIbi = m_sumIbi2 = m_sumDiff2 = 0.0;
+    m_over50 = 0;
+}
+
+
+
+/**
+ * Procesa un lote de muestras PPG. Los resultados anteriores se descartan.
+ *
+ * @param tUs Tiempos en microsegundos.
+ * @param values Valores PPG en bruto.
+ * @param n Número de muestras.
+ */
+void PpgBeatDetector::process(const qint64 *tUs, const float *values, int n){
+    m_hrOut.clear();
+    m_ibiOut.clear();
+    m_rmssdOut.clear();
+    m_sdnnOut.clear();
+    m_pnn50Out.clear();
+
+    for (int i = 0; i < n; ++i)
+        processSample(tUs[i], values[i]);
+}
+
+
+
+void PpgBeatDetector::processSample(qint64 tUs, double x){
+    if (m_seen == 0) {
+        // El paso alto parte de la componente continua para no generar un escalón
+        m_highPass.reset(x);
+    } else if (tUs - m_t1 > qint64(2.5e6 / m_settings.sampleHz)) {
+        // Hueco en la señal: el intervalo que lo cruza no es un IBI medido
+        m_hasPeak = false;
+    }
+
+    double y = m_lowPass.process(m_highPass.process(x));
+    if (m_settings.invert) y = -y;
+
+    m_envelope = std::max(std::abs(y), m_envelope * m_envelopeDecay);
+
+    // Máximo local en la muestra central (m_t1, m_y1)
+    if (m_seen >= 2 && m_y1 > m_y2 && m_y1 >= y && m_y1 > m_settings.thresholdRatio * m_envelope) {
+        // Interpolación parabólica del vértice con las tres muestras
+        const double den = m_y2 - 2.0 * m_y1 + y;
+        double offset = den != 0.0 ? 0.5 * (m_y2 - y) / den : 0.0;
+        offset = std::clamp(offset, -0.5, 0.5);
+        const double stepUs = offset >= 0.0 ? double(tUs - m_t1) : double(m_t1 - m_t2);
+        onPeak(m_t1 + qint64(std::llround(offset * stepUs)));
+    }
+
+    m_t2 = m_t1; m_y2 = m_y1;
+    m_t1 = tUs;  m_y1 = y;
+    if (m_seen < 2) ++m_seen;
+}
+
+
+
+void PpgBeatDetector::onPeak(qint64 tUs){
+    if (!m_hasPeak) {
+        m_lastPeakT = tUs;
+        m_hasPeak = true;
+        return;
+    }
+
+    const double ibiMs = (tUs - m_lastPeakT) / 1000.0;
+    if (ibiMs < m_settings.refractorySeconds * 1000.0) return;   // mismo latido
+
+    const bool adjacent = m_hasAccepted && m_lastAcceptedT == m_lastPeakT;
+    m_lastPeakT = tUs;
+    if (ibiMs < m_settings.minIbiMs || ibiMs > m_settings.maxIbiMs) return;
+
+    // Un latido perdido o un artefacto desvían mucho el IBI: se descarta sin perder la referencia
+    if (m_meanIbi > 0.0 && std::abs(ibiMs - m_meanIbi) > m_settings.maxIbiDeviation * m_meanIbi) {
+        m_meanIbi += 0.1 * (ibiMs - m_meanIbi);
+        return;
+    }
+    m_meanIbi = m_meanIbi > 0.0 ? m_meanIbi + 0.2 * (ibiMs - m_meanIbi) : ibiMs;
+
+    m_lastAcceptedT = tUs;
+    m_hasAccepted = true;
+    ++m_beats;
+    m_hrOut.push(tUs, float(60000.0 / ibiMs));
+    m_ibiOut.push(tUs, float(ibiMs));
+    addInterval(tUs, ibiMs, adjacent);
+}
+
+
+
+// Añade un IBI a la ventana de HRV y publica las métricas; la diferencia sucesiva solo si es contiguo al anterior
+void PpgBeatDetector::addInterval(qint64 tUs, double ibiMs, bool adjacent){
+    if (adjacent && !m_ibis.empty()) {
+        const double diff = std::abs(ibiMs - m_ibis.back().ms);
+        m_diffs.push_back({ tUs, diff });
+        m_sumDiff2 += diff * diff;
+        if (diff > 50.0) ++m_over50;
+    }
+    m_ibis.push_back({ tUs, ibiMs });
+    m_sumIbi += ibiMs;
+    m_sumIbi2 += ibiMs * ibiMs;
+
+    expireWindow(tUs);
+
+    const int n = int(m_ibis.size());
+    const int nd = int(m_diffs.size());
+    if (n < m_settings.minHrvBeats || nd == 0) return;
+
+    const double mean = m_sumIbi / n;
+    const double var = std::max(0.0, (m_sumIbi2 - n * mean * mean) / std::max(1, n - 1));
+    m_sdnnOut.push(tUs, float(std::sqrt(var)));
+    m_rmssdOut.push(tUs, float(std::sqrt(std::max(0.0, m_sumDiff2) / nd)));
+    m_pnn50Out.push(tUs, float(100.0 * m_over50 / nd));
+}
+
+
+
+void PpgBeatDetector::expireWindow(qint64 tUs){
+    const qint64 windowUs = qint64(m_settings.hrvWindowSeconds * 1e6);
+    while (!m_ibis.empty() && tUs - m_ibis.front().t > windowUs) {
+        const double ms = m_ibis.front().ms;
+        m_sumIbi -= ms;
+        m_sumIbi2 -= ms * ms;
+        m_ibis.pop_front();
+    }
+    while (!m_diffs.empty() && tUs - m_diffs.front().t > windowUs) {
+        const double d = m_diffs.front().ms;
+        m_sumDiff2 -= d * d;
+        if (d > 50.0) --m_over50;
+        m_diffs.pop_front();
+    }
+}
@@ -0,0 +1,124 @@
+/**
+*  file PpgBeatDetector.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef PPGBEATDETECTOR_H
+#define PPGBEATDETECTOR_H
+
+#include <QtGlobal>
+#include <QString>
+#include <deque>
+#include "dspfilters.h"
+#include "timeseriesstore.h"
+
+/*!
+ * \class PpgBeatDetector
+ * \brief Detección de latidos en PPG, frecuencia cardiaca y HRV en línea con coste constante.
+ *
+ * Sobre un canal PPG de 25 Hz (PG por defecto, configurable a PI o PR):
+ * 1. Paso banda 0,5–4 Hz con dos secciones bicuadráticas.
+ * 2. Envolvente de amplitud con decaimiento exponencial; un máximo local es latido si supera
+ *    thresholdRatio·envolvente y ha pasado el periodo refractario desde el anterior. El instante
+ *    del pico se afina con interpolación parabólica para no quedar limitado a los 40 ms de muestreo.
+ * 3. Intervalo entre latidos (IBI) validado por rango fisiológico y por desviación respecto al
+ *    IBI medio reciente, para descartar latidos perdidos o artefactos.
+ * 4. HRV en ventana deslizante (hrvWindowSeconds) con sumas incrementales: SDNN a partir de la
+ *    suma y la suma de cuadrados de los IBI, RMSSD y pNN50 a partir de las diferencias sucesivas.
+ *    Solo cuenta la diferencia entre dos IBI contiguos (el anterior acaba en el pico en que empieza
+ *    el actual): un IBI descartado o un hueco en la señal rompen la cadena.
+ *
+ * Resultados por latido, publicados como canales del PC: H_HR (lpm), H_BI (ms) y, cuando la
+ * ventana tiene latidos suficientes, H_RMSSD, H_SDNN (ms) y H_PNN50 (%).
+ *
+ * \see EmotiBitController, Biquad
+ * \author Enrique Fuentes
+ * \date 2025-05-25
+ */
+class PpgBeatDetector {
+public:
+    struct Settings {
+        QString sourceChannel   = "PG";   // canal PPG analizado (PG, PI o PR)
+        double sampleHz         = 25.0;
+        double lowCutHz         = 0.5;
+        double highCutHz        = 4.0;
+        bool   invert           = false;  // invierte la señal si los latidos aparecen como valles
+        double thresholdRatio   = 0.5;    // fracción de la envolvente para aceptar un pico
+        double envelopeDecaySeconds = 2.0;
+        double refractorySeconds = 0.3;   // 200 lpm como máximo
+        double minIbiMs         = 300.0;
+        double maxIbiMs         = 2000.0;
+        double maxIbiDeviation  = 0.3;    // desviación admitida respecto al IBI medio
+        double hrvWindowSeconds = 60.0;
+        int    minHrvBeats      = 10;     // latidos mínimos en la ventana para publicar HRV
+    };
+
+    PpgBeatDetector();
+    explicit PpgBeatDetector(const Settings &settings);
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+    void reset();
+
+    void process(const qint64 *tUs, const float *values, int n);
+
+    // Resultados del último process(), uno por latido aceptado
+    const SampleBatch &heartRate() const { return m_hrOut; }
+    const SampleBatch &interBeat() const { return m_ibiOut; }
+    const SampleBatch &rmssd() const     { return m_rmssdOut; }
+    const SampleBatch &sdnn() const      { return m_sdnnOut; }
+    const SampleBatch &pnn50() const     { return m_pnn50Out; }
+
+    quint64 beatCount() const { return m_beats; }
+
+private:
+    struct Interval {
+        qint64 t;
+        double ms;
+    };
+
+    void processSample(qint64 tUs, double x);
+    void onPeak(qint64 tUs);
+    void addInterval(qint64 tUs, double ibiMs, bool adjacent);
+    void expireWindow(qint64 tUs);
+
+    Settings m_settings;
+    Biquad m_highPass, m_lowPass;
+    double m_envelopeDecay = 1.0;
+    double m_envelope = 0.0;
+
+    // Últimas tres muestras filtradas para localizar máximos locales
+    int m_seen = 0;
+    qint64 m_t1 = 0, m_t2 = 0;
+    double m_y1 = 0.0, m_y2 = 0.0;
+
+    qint64 m_lastPeakT = 0;
+    bool m_hasPeak = false;
+    qint64 m_lastAcceptedT = 0;   // pico final del último IBI aceptado
+    bool m_hasAccepted = false;
+    double m_meanIbi = 0.0;       // IBI medio reciente (0: aún sin referencia)
+    quint64 m_beats = 0;
+
+    // Ventana de HRV con sumas incrementales
+    std::deque<Interval> m_ibis;
+    std::deque<Interval> m_diffs;  // diferencias sucesivas en valor absoluto
+    double m_sumIbi = 0.0, m_sumIbi2 = 0.0;
+    double m_sumDiff2 = 0.0;
+    int m_over50 = 0;
+
+    SampleBatch m_hrOut, m_ibiOut, m_rmssdOut, m_sdnnOut, m_pnn50Out;
+};
+
+#endif // PPGBEATDETECTOR_H
@@ -0,0 +1,84 @@
+/**
+*  file RateEstimator.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef RATEESTIMATOR_H
+#define RATEESTIMATOR_H
+
+#include <QtGlobal>
+#include <deque>
+
+/*!
+ * \class RateEstimator
+ * \brief Estima en línea la frecuencia real de muestreo de un canal a partir de sus paquetes.
+ *
+ * Por cada paquete se añade el punto (timestamp del dispositivo, muestras acumuladas) y se ajusta
+ * una recta por mínimos cuadrados sobre los últimos windowSeconds; la pendiente es la frecuencia
+ * real. Las sumas del ajuste se actualizan de forma incremental al entrar y salir puntos de la
+ * ventana. Mientras no hay datos suficientes, o si la estimación se aleja demasiado de la nominal,
+ * se usa la frecuencia de ChannelFrequencies.
+ *
+ * Los canales de eventos (HR, BI, SA, SF, SR...) no tienen frecuencia fija: sus muestras se
+ * reparten en el intervalo transcurrido desde el paquete anterior del mismo canal.
+ *
+ * update() devuelve el intervalo entre muestras que se usa para reconstruir los tiempos con
+ * la misma fórmula de siempre: t_i = timestamp - (numSamples - 1 - i) * dt.
+ *
+ * \see ChannelFrequencies, EmotiBitController
+ * \author Enrique Fuentes
+ * \date 2025-05-23
+ */
+class RateEstimator {
+public:
+    explicit RateEstimator(double nominalHz = 0.0, bool eventChannel = false, double windowSeconds = 20.0);
+
+    // Registra un paquete y devuelve el intervalo entre sus muestras en segundos
+    double update(qint64 timestampMs, int numSamples);
+    void reset();
+
+    double nominalRate() const { return m_nominalHz; }
+    double rate() const;                    // frecuencia estimada (o nominal si aún no converge)
+    bool isConverged() const { return m_fitHz > 0.0; }
+    bool isEventChannel() const { return m_event; }
+
+private:
+    struct Point {
+        double x;   // segundos desde el origen del ajuste
+        double y;   // muestras acumuladas desde el origen
+    };
+
+    void addPoint(const Point &p);
+    void removeFront();
+    void rebase();
+    void fit();
+
+    double m_nominalHz;
+    bool m_event;
+    double m_windowSeconds;
+
+    qint64 m_lastTimestampMs = 0;
+    bool m_hasLast = false;
+
+    // Ventana del ajuste y sumas incrementales
+    std::deque<Point> m_points;
+    qint64 m_originMs = 0;
+    double m_count = 0.0;                   // muestras acumuladas desde el origen
+    double m_sx = 0.0, m_sy = 0.0, m_sxx = 0.0, m_sxy = 0.0;
+    int m_removedSinceRebase = 0;
+    double m_fitHz = 0.0;                   // 0: sin ajuste válido
+};
+
+#endif // RATEESTIMATOR_H
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * RealFft.cpp
+ *
+ * Descripción: Transformada rápida de Fourier radix-2 para señales reales,
+ * implementada como FFT compleja de la mitad de tamaño más un paso de
+ * separación de los espectros par e impar.
+ *
+ * Fecha: 2025-05-28
+ ****************************************************************************/
+
+#include "realfft.h"
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+
+// Producto complejo sin las comprobaciones de NaN/Inf del operador estándar
+inline std::complex<float> mul(std::complex<float> a, std::complex<float> b){
+    return { a.real() * b.real() - a.imag() * b.imag(),
+             a.real() * b.imag() + a.imag() * b.real() };
+}
+}
+
+
+
+/**
+ * @param size Número de muestras; debe ser potencia de dos y al menos 4.
+ */
+RealFft::RealFft(int size)
+    : m_n(size), m_half(size / 2)
+{
+    Q_ASSERT_X(size >= 4 && (size & (size - 1)) == 0, "RealFft", "el tamaño debe ser potencia de dos");
+
+    int bits = 0;
+    while ((1 << bits) < m_half) ++bits;
+    m_bitReverse.resize(m_half);
+    for (int i = 0; i < m_half; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        m_bitReverse[i] = r;
+    }
+
+    m_twiddle.resize(std::max(1, m_half / 2));
+    for (int j = 0; j < int(m_twiddle.size()); ++j)
+        m_twiddle[j] = std::polar(1.0f, float(-2.0 * kPi * j / m_half));
+
+    m_split.resize(m_half + 1);
+    for (int k = 0; k <= m_half; ++k)
+        m_split[k] = std::polar(1.0f, float(-2.0 * kPi * k / m_n));
+
+    m_work.resize(m_half);
+    m_spectrum.resize(m_half + 1);
+}
+
+
+
+/**
+ * Calcula el espectro de una señal real.
+ *
+ * @param in N muestras de entrada.
+ * @param out N/2 + 1 coeficientes (de 0 a la frecuencia de Nyquist).
+ */
+void RealFft::forward(const float *in, std::complex<float> *out){
+    // Empaquetado: z[k] = x[2k] + i·x[2k+1], ya en orden de bits invertidos
+    for (int k = 0; k < m_half; ++k)
+        m_work[m_bitReverse[k]] = { in[2 * k], in[2 * k + 1] };
+    complexFft(m_work.data());
+
+    // Separación: X[k] = E[k] + e^{-2πik/N}·O[k]
+    const std::complex<float> z0 = m_work[0];
+    out[0]      = { z0.real() + z0.imag(), 0.0f };
+    out[m_half] = { z0.real() - z0.imag(), 0.0f };
+    for (int k = 1; k < m_half; ++k) {
+        const std::complex<float> a = m_work[k];
+        const std::complex<float> b = std::conj(m_work[m_half - k]);
+        const std::complex<float> even = 0.5f * (a + b);
+        const std::complex<float> d = a - b;
+        const std::complex<float> odd(0.5f * d.imag(), -0.5f * d.real());   // (a - b) / 2i
+        out[k] = even + mul(m_split[k], odd);
+    }
+}
+
+
+
+/**
+ * Calcula la potencia |X[k]|² de cada coeficiente.
+ *
+ * @param in N muestras de entrada.
+ * @param power N/2 + 1 valores de salida.
+ */
+void RealFft::power(const float *in, float *power){
+    forward(in, m_spectrum.data());
+    for (int k = 0; k <= m_half; ++k)
+        power[k] = m_spectrum[k].real() * m_spectrum[k].real() + m_spectrum[k].imag() * m_spectrum[k].imag();
+}
+
+
+
+// FFT compleja iterativa (decimación en el tiempo) sobre datos ya permutados
+void RealFft::complexFft(std::complex<float> *data) const {
+    for (int len = 2; len <= m_half; len <<= 1) {
+        const int halfLen = len / 2;
+        const int stride = m_half / len;
+        for (int start = 0; start < m_half; start += len) {
+            for (int j = 0; j < halfLen; ++j) {
+                const std::complex<float> w = m_twiddle[j * stride];
+                const std::complex<float> u = data[start + j];
+                const std::complex<float> v = mul(w, data[start + j + halfLen]);
+                data[start + j] = u + v;
+                data[start + j + halfLen] = u - v;
+            }
+        }
+    }
+}
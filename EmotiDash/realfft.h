@@ -0,0 +1,62 @@
+/**
+*  file RealFft.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef REALFFT_H
+#define REALFFT_H
+
+#include <complex>
+#include <vector>
+
+/*!
+ * \class RealFft
+ * \brief FFT radix-2 de señales reales, sin dependencias externas.
+ *
+ * Una señal real de N muestras se empaqueta como N/2 complejos (pares en la parte real, impares
+ * en la imaginaria), se transforma con una FFT compleja iterativa de N/2 puntos y se separa en
+ * los N/2 + 1 coeficientes del espectro. Las tablas de giros y de inversión de bits se calculan
+ * una vez en el constructor, de modo que forward() no reserva memoria.
+ *
+ * \see WelchPsd
+ * \author Enrique Fuentes
+ * \date 2025-05-28
+ */
+class RealFft {
+public:
+    explicit RealFft(int size);
+
+    int size() const { return m_n; }
+    int bins() const { return m_n / 2 + 1; }
+
+    // Espectro de in[0..N) en out[0..N/2]
+    void forward(const float *in, std::complex<float> *out);
+
+    // |X[k]|² de in[0..N) en power[0..N/2]
+    void power(const float *in, float *power);
+
+private:
+    void complexFft(std::complex<float> *data) const;
+
+    int m_n;
+    int m_half;
+    std::vector<int> m_bitReverse;                 // permutación de la FFT de N/2 puntos
+    std::vector<std::complex<float>> m_twiddle;    // e^{-2πij/(N/2)}, j < N/4
+    std::vector<std::complex<float>> m_split;      // e^{-2πik/N},     k <= N/2
+    std::vector<std::complex<float>> m_work;
+    std::vector<std::complex<float>> m_spectrum;
+};
+
+#endif // REALFFT_H
@@ -0,0 +1,341 @@
+/****************************************************************************
+ * RecordingWriter.cpp
+ *
+ * Descripción: Escritor asíncrono para la grabación local en el PC. Recibe
+ * lotes de paquetes desde el controlador y los escribe en disco desde su
+ * propio hilo, en bloques grandes, con fsync periódico y rotación de
+ * archivos por tamaño o duración.
+ *
+ * Fecha: 2025-05-21
+ ****************************************************************************/
+
+#include "recordingwriter.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+const qint64 kFirstRetryMs = 500;     // espera inicial para reintentar abrir el archivo
+const qint64 kMaxRetryMs = 30000;
+}
+
+RecordingWriter::RecordingWriter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    stop();
+}
+
+
+
+/**
+ * Abre el primer archivo y arranca el hilo escritor.
+ *
+ * @param settings Configuración de la grabación.
+ * @return true si el archivo se ha podido abrir.
+ */
+bool RecordingWriter::start(const Settings &settings){
+    if (m_running) return false;
+
+    m_settings = settings;
+    m_settings.blockSize = std::max(4096, m_settings.blockSize);
+    m_block.assign(m_settings.blockSize, 0);
+    m_blockFill = 0;
+    m_fileIndex = 0;
+    m_stopRequested = false;
+    m_queue.clear();
+    m_queuedBytes = 0;
+    m_writtenBytes = 0;
+    m_droppedBytes = 0;
+    m_backpressure = false;
+    m_openFailed = false;
+
+    if (!openFile(0)) return false;
+
+    m_running = true;
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+
+
+/**
+ * Vacía la cola, escribe el último bloque parcial, fuerza a disco y cierra el archivo.
+ * Bloquea hasta que el hilo escritor termina.
+ */
+void RecordingWriter::stop(){
+    if (!m_running) return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_wake.wakeOne();
+    }
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_running = false;
+}
+
+
+
+/**
+ * Encola un lote de líneas completas (UTF-8, terminadas en '\n') para escribirlo.
+ * No bloquea: si el lote no cabe en el presupuesto de memoria se descarta y se
+ * activa la contrapresión.
+ *
+ * @param batch Lote de paquetes.
+ * @return true si se ha encolado, false si se ha descartado.
+ */
+bool RecordingWriter::submit(QByteArray batch){
+    if (!m_running || batch.isEmpty()) return false;
+
+    const qint64 size = batch.size();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_queuedBytes.load(std::memory_order_relaxed) + size > m_settings.memoryBudget) {
+            m_droppedBytes.fetch_add(size, std::memory_order_relaxed);
+            locker.unlock();
+            if (!m_backpressure.exchange(true))
+                emit backpressureChanged(true);
+            return false;
+        }
+        m_queue.push_back(std::move(batch));
+        m_queuedBytes.fetch_add(size, std::memory_order_relaxed);
+        m_wake.wakeOne();
+    }
+    return true;
+}
+
+
+
+/**
+ * @return Ruta del archivo que se está escribiendo.
+ */
+QString RecordingWriter::currentFile() const {
+    QMutexLocker locker(&m_mutex);
+    return m_currentPath;
+}
+
+
+
+// Bucle del hilo escritor: espera lotes, los agrupa en bloques y aplica la cadencia de fsync
+void RecordingWriter::run(){
+    m_sinceSync.start();
+    std::deque<QByteArray> pending;
+
+    forever {
+        bool stopping;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.empty() && !m_stopRequested) {
+                const int interval = m_settings.fsyncIntervalMs > 0 ? m_settings.fsyncIntervalMs : 1000;
+                const qint64 remaining = std::max<qint64>(1, interval - m_sinceSync.elapsed());
+                m_wake.wait(&m_mutex, QDeadlineTimer(remaining));
+            }
+            pending.swap(m_queue);
+            stopping = m_stopRequested && pending.empty() && m_queue.empty();
+        }
+
+        for (const QByteArray &batch : pending) {
+            appendToBlock(batch);
+            m_queuedBytes.fetch_sub(batch.size(), std::memory_order_relaxed);
+        }
+        pending.clear();
+
+        // Se libera la contrapresión con histéresis, cuando la cola baja a la mitad
+        if (m_backpressure.load(std::memory_order_relaxed)
+            && m_queuedBytes.load(std::memory_order_relaxed) < m_settings.memoryBudget / 2) {
+            m_backpressure = false;
+            emit backpressureChanged(false);
+        }
+
+        if (m_settings.fsyncIntervalMs > 0 && m_sinceSync.elapsed() >= m_settings.fsyncIntervalMs) {
+            flushTail();
+            syncToDisk();
+        }
+
+        if (m_openFailed)
+            retryOpen();
+        else if (m_settings.maxFileSeconds > 0 && m_fileAge.elapsed() >= qint64(m_settings.maxFileSeconds) * 1000)
+            rotate();
+
+        if (stopping) break;
+    }
+
+    flushTail();
+    syncToDisk();
+    closeFile();
+}
+
+
+
+// Abre el archivo de índice dado y escribe la cabecera en el bloque
+bool RecordingWriter::openFile(int index, bool reportError){
+    const QString path = fileNameFor(index);
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        if (reportError)
+            emit writeError("Error al abrir archivo: " + path);
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_currentPath = path;
+    }
+    m_fileIndex = index;
+    m_fileBytes = 0;
+    m_fileAge.start();
+
+    if (!m_settings.header.isEmpty())
+        appendToBlock(m_settings.header);
+    return true;
+}
+
+
+
+void RecordingWriter::closeFile(){
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+
+
+// Cierra el archivo actual y pasa al siguiente; si no se puede abrir, empieza a reintentar
+void RecordingWriter::rotate(){
+    flushTail();
+    syncToDisk();
+    closeFile();
+    if (openFile(m_fileIndex + 1)) {
+        emit fileRotated(m_currentPath);
+        return;
+    }
+    m_openFailed = true;
+    m_retryDelayMs = kFirstRetryMs;
+    m_retryClock.start();
+    emit writeError("La grabación se descarta hasta poder abrir " + fileNameFor(m_fileIndex + 1)
+                    + "; se reintentará.");
+}
+
+
+
+// Reintenta abrir el archivo siguiente, con espera doble tras cada fallo (sin repetir el aviso)
+void RecordingWriter::retryOpen(){
+    if (m_retryClock.elapsed() < m_retryDelayMs) return;
+    if (openFile(m_fileIndex + 1, false)) {
+        m_openFailed = false;
+        emit fileRotated(m_currentPath);
+        return;
+    }
+    m_retryDelayMs = std::min(kMaxRetryMs, m_retryDelayMs * 2);
+    m_retryClock.restart();
+}
+
+
+
+// Copia un lote en el bloque y escribe cada bloque completo con una sola llamada
+void RecordingWriter::appendToBlock(const QByteArray &batch){
+    if (!m_openFailed && needsRotation(batch.size()))
+        rotate();
+    if (m_openFailed) {
+        m_droppedBytes.fetch_add(batch.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    const char *src = batch.constData();
+    qint64 remaining = batch.size();
+    while (remaining > 0) {
+        // Sin datos parciales y con al menos un bloque completo: se escribe directamente
+        if (m_blockFill == 0 && remaining >= m_settings.blockSize) {
+            const qint64 whole = remaining - remaining % m_settings.blockSize;
+            writeBlock(src, whole);
+            src += whole;
+            remaining -= whole;
+            continue;
+        }
+        const int n = int(std::min<qint64>(remaining, m_settings.blockSize - m_blockFill));
+        std::memcpy(m_block.data() + m_blockFill, src, n);
+        m_blockFill += n;
+        src += n;
+        remaining -= n;
+        if (m_blockFill == m_settings.blockSize) {
+            writeBlock(m_block.data(), m_blockFill);
+            m_blockFill = 0;
+        }
+    }
+}
+
+
+
+void RecordingWriter::writeBlock(const char *data, qint64 size){
+    if (size <= 0) return;
+    if (!m_file.isOpen()) {
+        m_droppedBytes.fetch_add(size, std::memory_order_relaxed);
+        return;
+    }
+    const qint64 written = m_file.write(data, size);
+    if (written != size)
+        emit writeError("Error de escritura en " + m_currentPath + ": " + m_file.errorString());
+    if (written > 0) {
+        m_fileBytes += written;
+        m_writtenBytes.fetch_add(written, std::memory_order_relaxed);
+    }
+}
+
+
+
+// Escribe el bloque parcial (se usa antes de cada fsync, al rotar y al parar)
+void RecordingWriter::flushTail(){
+    if (m_blockFill > 0) {
+        writeBlock(m_block.data(), m_blockFill);
+        m_blockFill = 0;
+    }
+}
+
+
+
+// Fuerza los datos escritos al disco físico
+void RecordingWriter::syncToDisk(){
+    m_sinceSync.restart();
+    if (!m_file.isOpen()) return;
+    m_file.flush();
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    ::fsync(m_file.handle());
+#endif
+}
+
+
+
+// La rotación por tamaño solo se decide entre lotes para no partir ningún paquete
+bool RecordingWriter::needsRotation(qint64 incoming) const {
+    if (m_settings.maxFileBytes <= 0) return false;
+    const qint64 current = m_fileBytes + m_blockFill;
+    return current > m_settings.header.size() && current + incoming > m_settings.maxFileBytes;
+}
+
+
+
+// archivo.csv, archivo_001.csv, archivo_002.csv...
+QString RecordingWriter::fileNameFor(int index) const {
+    if (index == 0) return m_settings.filePath;
+    QFileInfo fi(m_settings.filePath);
+    const QString suffix = fi.suffix().isEmpty() ? QString() : "." + fi.suffix();
+    return fi.dir().filePath(QString("%1_%2%3").arg(fi.completeBaseName())
+                                 .arg(index, 3, 10, QChar('0'))
+                                 .arg(suffix));
+}
@@ -0,0 +1,133 @@
+/**
+*  file RecordingWriter.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef RECORDINGWRITER_H
+#define RECORDINGWRITER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QDeadlineTimer>
+#include <QThread>
+#include <deque>
+#include <atomic>
+#include <vector>
+
+/*!
+ * \class RecordingWriter
+ * \brief Escritor asíncrono de grabaciones locales con bloques grandes, fsync periódico y rotación.
+ *
+ * El hilo de captura entrega lotes de paquetes ya codificados en UTF-8 con submit(). Un hilo propio
+ * los agrupa en bloques de tamaño fijo y los escribe con una sola llamada por bloque. Cada
+ * fsyncIntervalMs se vuelca también el bloque parcial y se fuerza a disco, de forma que un cierre
+ * inesperado pierde como mucho ese intervalo. Los archivos rotan por tamaño o por duración, siempre
+ * en frontera de lote para no partir paquetes.
+ *
+ * La memoria en cola está limitada por memoryBudget: si se supera, submit() descarta el lote,
+ * lo contabiliza y se emite backpressureChanged(true).
+ *
+ * Si al rotar no se puede abrir el archivo siguiente, se avisa una vez con writeError(), los
+ * lotes que llegan se cuentan como descartados y se reintenta la apertura con espera creciente
+ * (de 0,5 s a 30 s).
+ *
+ * \see EmotiBitController
+ * \author Enrique Fuentes
+ * \date 2025-05-21
+ */
+class RecordingWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Settings {
+        QString filePath;                       // primer archivo; los siguientes añaden _001, _002...
+        QByteArray header;                      // cabecera escrita al inicio de cada archivo
+        int     blockSize        = 64 * 1024;   // bytes por escritura
+        qint64  memoryBudget     = 8 * 1024 * 1024;  // bytes máximos en cola
+        int     fsyncIntervalMs  = 1000;        // cadencia de volcado a disco (0 = solo al parar)
+        qint64  maxFileBytes     = 0;           // rotación por tamaño (0 = sin límite)
+        int     maxFileSeconds   = 0;           // rotación por duración (0 = sin límite)
+    };
+
+    explicit RecordingWriter(QObject *parent = nullptr);
+    ~RecordingWriter();
+
+    bool start(const Settings &settings);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Encola un lote de líneas completas; false si se ha descartado por falta de memoria
+    bool submit(QByteArray batch);
+
+    qint64 queuedBytes()  const { return m_queuedBytes.load(std::memory_order_relaxed); }
+    qint64 writtenBytes() const { return m_writtenBytes.load(std::memory_order_relaxed); }
+    qint64 droppedBytes() const { return m_droppedBytes.load(std::memory_order_relaxed); }
+    bool   isBackpressured() const { return m_backpressure.load(std::memory_order_relaxed); }
+    QString currentFile() const;
+
+signals:
+    void backpressureChanged(bool active);
+    void fileRotated(const QString &filePath);
+    void writeError(const QString &message);
+
+private:
+    void run();
+    bool openFile(int index, bool reportError = true);
+    void closeFile();
+    void rotate();
+    void retryOpen();
+    void appendToBlock(const QByteArray &batch);
+    void writeBlock(const char *data, qint64 size);
+    void flushTail();
+    void syncToDisk();
+    bool needsRotation(qint64 incoming) const;
+    QString fileNameFor(int index) const;
+
+    Settings m_settings;
+    QThread *m_thread = nullptr;
+    bool m_running = false;
+
+    // Cola compartida entre productor y escritor
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    std::deque<QByteArray> m_queue;
+    bool m_stopRequested = false;
+
+    // Estado del hilo escritor
+    QFile m_file;
+    QString m_currentPath;
+    int m_fileIndex = 0;
+    qint64 m_fileBytes = 0;
+    QElapsedTimer m_fileAge;
+    bool m_openFailed = false;          // sin archivo tras una rotación fallida: se descarta
+    qint64 m_retryDelayMs = 0;
+    QElapsedTimer m_retryClock;
+    QElapsedTimer m_sinceSync;
+    std::vector<char> m_block;
+    int m_blockFill = 0;
+
+    std::atomic<qint64> m_queuedBytes {0};
+    std::atomic<qint64> m_writtenBytes {0};
+    std::atomic<qint64> m_droppedBytes {0};
+    std::atomic<bool>   m_backpressure {false};
+};
+
+#endif // RECORDINGWRITER_H
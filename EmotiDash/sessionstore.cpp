@@ -0,0 +1,89 @@
+/****************************************************************************
+ * SessionStore.cpp
+ *
+ * Descripción: Sesión completa comprimida en memoria, con una serie
+ * CompressedSeries por canal.
+ *
+ * Fecha: 2025-05-22
+ ****************************************************************************/
+
+#include "sessionstore.h"
+
+SessionStore::SessionStore(int samplesPerBlock)
+    : m_samplesPerBlock(samplesPerBlock)
+{
+}
+
+
+
+/**
+ * Añade un lote de muestras a la serie del canal y a su pirámide, creándolas si no existen.
+ *
+ * @param channelID Identificador del canal.
+ * @param tUs Tiempos en microsegundos.
+ * @param values Valores.
+ * @param n Número de muestras.
+ */
+void SessionStore::append(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    if (n <= 0) return;
+    auto it = m_series.find(channelID);
+    if (it == m_series.end())
+        it = m_series.insert(channelID, CompressedSeries(m_samplesPerBlock));
+    it.value().append(tUs, values, n);
+    m_pyramids[channelID].append(tUs, values, n);
+}
+
+
+
+void SessionStore::clear(){
+    m_series.clear();
+    m_pyramids.clear();
+}
+
+
+
+/**
+ * @param channelID Identificador del canal.
+ * @return Serie comprimida del canal, o nullptr si no hay muestras.
+ */
+const CompressedSeries *SessionStore::find(const QString &channelID) const {
+    auto it = m_series.constFind(channelID);
+    return it != m_series.constEnd() ? &it.value() : nullptr;
+}
+
+
+
+/**
+ * @param channelID Identificador del canal.
+ * @return Pirámide de resúmenes del canal, o nullptr si no hay muestras.
+ */
+const MinMaxPyramid *SessionStore::pyramid(const QString &channelID) const {
+    auto it = m_pyramids.constFind(channelID);
+    return it != m_pyramids.constEnd() ? &it.value() : nullptr;
+}
+
+
+
+/**
+ * @return Número total de muestras de la sesión.
+ */
+quint64 SessionStore::sampleCount() const {
+    quint64 n = 0;
+    for (const auto &series : m_series)
+        n += series.sampleCount();
+    return n;
+}
+
+
+
+/**
+ * @return Memoria ocupada por todas las series comprimidas y sus pirámides.
+ */
+size_t SessionStore::memoryBytes() const {
+    size_t bytes = 0;
+    for (const auto &series : m_series)
+        bytes += series.memoryBytes();
+    for (const auto &pyramid : m_pyramids)
+        bytes += pyramid.memoryBytes();
+    return bytes;
+}
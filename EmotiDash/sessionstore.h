@@ -0,0 +1,61 @@
+/**
+*  file SessionStore.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include "compressedseries.h"
+#include "minmaxpyramid.h"
+
+/*!
+ * \class SessionStore
+ * \brief Sesión completa de un dispositivo comprimida en memoria, un CompressedSeries por canal.
+ *
+ * Mientras TimeSeriesStore guarda solo la ventana reciente en anillos, SessionStore conserva
+ * todas las muestras desde la conexión para poder desplazarse por la sesión entera o volver a
+ * analizarla sin leer el archivo de disco. Junto a cada serie se mantiene una MinMaxPyramid para
+ * dibujar cualquier zoom de la sesión sin descomprimirla. Se escribe y se lee desde el hilo del
+ * controlador.
+ *
+ * \see CompressedSeries, MinMaxPyramid, TimeSeriesStore, EmotiBitController
+ * \author Enrique Fuentes
+ * \date 2025-05-22
+ */
+class SessionStore {
+public:
+    explicit SessionStore(int samplesPerBlock = 4096);
+
+    void append(const QString &channelID, const qint64 *tUs, const float *values, int n);
+    void clear();
+
+    const CompressedSeries *find(const QString &channelID) const;
+    const MinMaxPyramid *pyramid(const QString &channelID) const;
+    QStringList channelIds() const { return m_series.keys(); }
+
+    quint64 sampleCount() const;
+    size_t memoryBytes() const;
+
+private:
+    int m_samplesPerBlock;
+    QHash<QString, CompressedSeries> m_series;
+    QHash<QString, MinMaxPyramid> m_pyramids;
+};
+
+#endif // SESSIONSTORE_H
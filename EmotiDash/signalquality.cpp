@@ -0,0 +1,216 @@
+/****************************************************************************
+ * SignalQuality.cpp
+ *
+ * Descripción: Indicadores de calidad por canal calculados de forma
+ * incremental (saturación, línea plana, varianza y eventos DC/DO) y
+ * resumidos en una puntuación por segundo.
+ *
+ * Fecha: 2025-05-27
+ ****************************************************************************/
+
+#include "signalquality.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const qint64 kSecondUs = 1000000;
+
+// Penalizaciones de la puntuación (sobre 100)
+const double kClipWeight = 100.0;       // por fracción de muestras saturadas
+const double kFlatWeight = 80.0;        // por fracción de muestras en línea plana
+const double kStdPenalty = 30.0;        // desviación fuera de límites
+const double kClipEventPenalty = 10.0;  // por evento DC, hasta kMaxEventPenalty
+const double kOverflowEventPenalty = 20.0;
+const double kMaxEventPenalty = 50.0;
+
+// Margen para los paquetes de otro canal que aún traen muestras del segundo que se cierra
+const qint64 kLateUs = 500000;
+
+// Fin del segundo que contiene t (también para t negativo)
+qint64 secondEndOf(qint64 t)
+{
+    qint64 q = t / kSecondUs;
+    if (t % kSecondUs < 0) --q;
+    return (q + 1) * kSecondUs;
+}
+}
+
+
+
+// Rangos por defecto de los sensores del EmotiBit
+SignalQuality::SignalQuality()
+{
+    Limits acc;  acc.low = -8.0f;     acc.high = 8.0f;         // g
+    Limits gyro; gyro.low = -1000.0f; gyro.high = 1000.0f;     // º/s
+    Limits ppg;  ppg.low = 0.0f;      ppg.high = 262143.0f;    // ADC de 18 bits
+    ppg.minStd = 1.0;                                          // señal sin pulso
+    Limits eda;  eda.low = 0.0f;      eda.maxStd = 2.0;        // µS; saltos bruscos = artefacto
+
+    for (const char *c : { "AX", "AY", "AZ" }) m_limits.insert(c, acc);
+    for (const char *c : { "GX", "GY", "GZ" }) m_limits.insert(c, gyro);
+    for (const char *c : { "PI", "PR", "PG" }) m_limits.insert(c, ppg);
+    for (const char *c : { "EA", "EL" })       m_limits.insert(c, eda);
+}
+
+
+
+void SignalQuality::reset(){
+    m_states.clear();
+    m_reports.clear();
+    m_newestUs = std::numeric_limits<qint64>::min();
+}
+
+
+
+/**
+ * Acumula las muestras de un canal y cierra los segundos que terminan.
+ *
+ * @param channelID Canal de las muestras.
+ * @param tUs Tiempos en microsegundos.
+ * @param values Valores.
+ * @param n Número de muestras.
+ */
+void SignalQuality::addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    if (n <= 0) return;
+    State &s = m_states[channelID];
+    const auto found = m_limits.constFind(channelID);
+    const bool monitored = found != m_limits.constEnd();
+    const Limits limits = monitored ? found.value() : Limits();
+    const qint64 flatUs = qint64(m_flatlineSeconds * 1e6);
+
+    for (int i = 0; i < n; ++i) {
+        const qint64 t = tUs[i];
+        const float v = values[i];
+
+        if (!s.started) {
+            s.started = true;
+            s.secondEnd = secondEndOf(t);
+        }
+        closeThrough(channelID, s, limits, monitored, t);
+        m_newestUs = std::max(m_newestUs, t);
+
+        ++s.samples;
+        if (v <= limits.low || v >= limits.high || !std::isfinite(v))
+            ++s.clipped;
+
+        // Racha de valores idénticos: al superar flatlineSeconds se cuenta entera
+        if (s.runLength > 0 && v == s.lastValue) {
+            ++s.runLength;
+            if (t - s.runStartT >= flatUs) {
+                s.flat += s.runCounted ? 1 : std::min(s.runLength, s.samples);
+                s.runCounted = true;
+            }
+        } else {
+            s.runLength = 1;
+            s.runStartT = t;
+            s.runCounted = false;
+        }
+        s.lastValue = v;
+
+        // Welford
+        const double delta = v - s.mean;
+        s.mean += delta / s.samples;
+        s.m2 += delta * (v - s.mean);
+    }
+}
+
+
+
+/**
+ * Registra eventos de saturación notificados por el dispositivo (paquete DC).
+ */
+void SignalQuality::addClipEvent(const QString &channelID, int count){
+    m_states[channelID].clipEvents += count;
+}
+
+
+
+/**
+ * Registra eventos de desbordamiento notificados por el dispositivo (paquete DO).
+ */
+void SignalQuality::addOverflowEvent(const QString &channelID, int count){
+    m_states[channelID].overflowEvents += count;
+}
+
+
+
+/**
+ * Cierra los segundos que el tiempo de muestra más reciente (de cualquier canal, menos un
+ * margen para los paquetes rezagados) ya ha dejado atrás. El controlador la llama
+ * periódicamente para que un canal que deja de llegar no se quede con su última puntuación.
+ * Solo afecta a los canales con límites: los demás pueden pasar segundos sin muestras.
+ */
+void SignalQuality::closeDue(){
+    if (m_newestUs == std::numeric_limits<qint64>::min()) return;
+    const qint64 untilUs = m_newestUs - kLateUs;
+    for (auto it = m_states.begin(); it != m_states.end(); ++it) {
+        const auto found = m_limits.constFind(it.key());
+        if (it.value().started && found != m_limits.constEnd())
+            closeThrough(it.key(), it.value(), found.value(), true, untilUs);
+    }
+}
+
+
+
+/**
+ * @return Informes cerrados desde la última llamada.
+ */
+QVector<SignalQuality::Report> SignalQuality::takeReports(){
+    QVector<Report> reports;
+    reports.swap(m_reports);
+    return reports;
+}
+
+
+
+/**
+ * Cierra el segundo en curso si untilUs ya está fuera de él. Si además quedan segundos
+ * enteros sin muestras hasta untilUs, en un canal con límites se da un único informe a 0
+ * (con el último de ellos) y los demás se saltan; en el resto de canales el hueco no se informa.
+ */
+void SignalQuality::closeThrough(const QString &channelID, State &s, const Limits &limits, bool monitored, qint64 untilUs){
+    if (untilUs < s.secondEnd) return;
+    if (monitored || s.samples > 0)
+        closeSecond(channelID, s, limits, monitored);
+    s.secondEnd += kSecondUs;
+    if (untilUs < s.secondEnd) return;
+
+    s.secondEnd = secondEndOf(untilUs) - kSecondUs;
+    if (monitored)
+        closeSecond(channelID, s, limits, monitored);
+    s.secondEnd += kSecondUs;
+}
+
+
+
+// Calcula la puntuación del segundo y deja el estado listo para el siguiente
+void SignalQuality::closeSecond(const QString &channelID, State &s, const Limits &limits, bool monitored){
+    Report r;
+    r.channelID = channelID;
+    r.tUs = s.secondEnd;
+    r.samples = s.samples;
+    r.clipEvents = s.clipEvents;
+    r.overflowEvents = s.overflowEvents;
+
+    double score = 100.0;
+    if (s.samples > 0) {
+        r.clipRate = float(double(s.clipped) / s.samples);
+        r.flatFraction = float(std::min(1.0, double(s.flat) / s.samples));
+        r.stddev = float(s.samples > 1 ? std::sqrt(s.m2 / (s.samples - 1)) : 0.0);
+
+        score -= kClipWeight * r.clipRate;
+        if (monitored)
+            score -= kFlatWeight * r.flatFraction;
+        if (s.samples > 1 && (r.stddev < limits.minStd || r.stddev > limits.maxStd))
+            score -= kStdPenalty;
+    } else {
+        score = 0.0;     // el canal ha dejado de llegar
+    }
+    score -= std::min(kMaxEventPenalty, kClipEventPenalty * s.clipEvents + kOverflowEventPenalty * s.overflowEvents);
+    r.score = float(std::clamp(score, 0.0, 100.0));
+    m_reports.append(r);
+
+    s.samples = s.clipped = s.flat = 0;
+    s.mean = s.m2 = 0.0;
+    s.clipEvents = s.overflowEvents = 0;
+}
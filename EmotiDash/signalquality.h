@@ -0,0 +1,118 @@
+/**
+*  file SignalQuality.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef SIGNALQUALITY_H
+#define SIGNALQUALITY_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <limits>
+
+/*!
+ * \class SignalQuality
+ * \brief Índice de calidad por canal y por segundo calculado en línea.
+ *
+ * Para cada canal se acumulan durante un segundo (en tiempo de muestra):
+ * - saturación: muestras en los límites del rango del sensor o fuera de él;
+ * - línea plana: muestras dentro de una racha de valores idénticos más larga que flatlineSeconds;
+ * - desviación típica del segundo (Welford), comparada con los límites configurados;
+ * - eventos DC (data clipping) y DO (data overflow) que el dispositivo notifica por paquete.
+ *
+ * Al cerrar cada segundo se genera un Report con un valor compacto de 0 a 100 que la interfaz
+ * muestra y que el controlador añade a la grabación como línea QS.
+ *
+ * Un segundo se cierra al llegar una muestra posterior del mismo canal o, con closeDue(),
+ * cuando el tiempo de muestra más reciente de todos los canales lo ha dejado atrás: así un
+ * canal que deja de llegar baja a 0 mientras los demás siguen. Si faltan varios segundos
+ * seguidos se da un único informe a 0 y se saltan los demás.
+ *
+ * La línea plana y los segundos vacíos solo penalizan a los canales con límites configurados
+ * (acelerómetro, giroscopio, PPG y EDA); los canales lentos o cuantizados, como la
+ * temperatura, se puntúan sin ellas. Los canales de eventos (HR, BI, SCR...) no se puntúan:
+ * el controlador no los pasa a addSamples().
+ *
+ * \see EmotiBitController, FormPlot
+ * \author Enrique Fuentes
+ * \date 2025-05-27
+ */
+class SignalQuality {
+public:
+    /// Límites de un canal; los valores por defecto desactivan cada comprobación.
+    struct Limits {
+        float  low     = -std::numeric_limits<float>::infinity();
+        float  high    =  std::numeric_limits<float>::infinity();
+        double minStd  = 0.0;
+        double maxStd  = std::numeric_limits<double>::infinity();
+    };
+
+    struct Report {
+        QString channelID;
+        qint64  tUs = 0;              // fin del segundo evaluado
+        float   score = 100.0f;       // 0 (inutilizable) .. 100 (correcta)
+        float   clipRate = 0.0f;      // fracción de muestras saturadas
+        float   flatFraction = 0.0f;  // fracción de muestras en línea plana
+        float   stddev = 0.0f;
+        int     samples = 0;
+        int     clipEvents = 0;       // DC
+        int     overflowEvents = 0;   // DO
+    };
+
+    SignalQuality();
+
+    void setLimits(const QString &channelID, const Limits &limits) { m_limits.insert(channelID, limits); }
+    void setFlatlineSeconds(double seconds) { m_flatlineSeconds = seconds; }
+    void reset();
+
+    void addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n);
+    void addClipEvent(const QString &channelID, int count = 1);
+    void addOverflowEvent(const QString &channelID, int count = 1);
+
+    // Cierra en todos los canales los segundos que el tiempo más reciente ya ha dejado atrás
+    void closeDue();
+
+    // Informes de los segundos cerrados desde la última llamada
+    QVector<Report> takeReports();
+
+private:
+    struct State {
+        bool   started = false;      // ya ha llegado alguna muestra
+        qint64 secondEnd = 0;
+        int    samples = 0;
+        int    clipped = 0;
+        int    flat = 0;
+        double mean = 0.0, m2 = 0.0;
+        int    clipEvents = 0;
+        int    overflowEvents = 0;
+        float  lastValue = 0.0f;
+        qint64 runStartT = 0;        // inicio de la racha de valores idénticos
+        int    runLength = 0;
+        bool   runCounted = false;   // la racha ya se ha contado como línea plana
+    };
+
+    void closeSecond(const QString &channelID, State &s, const Limits &limits, bool monitored);
+    void closeThrough(const QString &channelID, State &s, const Limits &limits, bool monitored, qint64 untilUs);
+
+    QHash<QString, Limits> m_limits;
+    QHash<QString, State> m_states;
+    QVector<Report> m_reports;
+    double m_flatlineSeconds = 1.0;
+    qint64 m_newestUs = std::numeric_limits<qint64>::min();   // tiempo de muestra más reciente
+};
+
+#endif // SIGNALQUALITY_H
@@ -0,0 +1,419 @@
+/****************************************************************************
+ * StreamPipeline.cpp
+ *
+ * Descripción: Cadenas de procesado por canal (IIR, FIR, media móvil,
+ * diezmado, recorte y escala) que se aplican a cada lote de muestras antes
+ * de publicarlo. Las cadenas se describen con texto y se pueden cambiar en
+ * caliente sin detener la captura.
+ *
+ * Fecha: 2025-05-29
+ ****************************************************************************/
+
+#include "streampipeline.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Q de cada sección de un Butterworth de orden par
+std::vector<double> butterworthQ(int order){
+    std::vector<double> q;
+    for (int k = 0; k < order / 2; ++k)
+        q.push_back(1.0 / (2.0 * std::cos(kPi * (2 * k + 1) / (2.0 * order))));
+    return q;
+}
+
+bool parseArgs(const QString &text, std::vector<double> &args){
+    args.clear();
+    if (text.trimmed().isEmpty()) return true;
+    for (const QString &part : text.split(',')) {
+        bool ok = false;
+        const double value = part.trimmed().toDouble(&ok);
+        if (!ok) return false;
+        args.push_back(value);
+    }
+    return true;
+}
+
+void setError(QString *error, const QString &message){
+    if (error) *error = message;
+}
+
+}
+
+
+
+// ---------------------------------------------------------------------------
+//      Etapas
+// ---------------------------------------------------------------------------
+
+BiquadCascadeStage::BiquadCascadeStage(std::vector<Biquad> sections, const QString &description)
+    : m_sections(std::move(sections)), m_initial(m_sections), m_description(description)
+{
+}
+
+
+
+// Las secciones se recorren muestra a muestra: la recursión IIR no admite vectorización directa
+void BiquadCascadeStage::process(SampleBatch &batch){
+    if (batch.isEmpty()) return;
+    float *v = batch.v.data();
+    const int n = batch.size();
+
+    if (!m_primed) {
+        // Estado en régimen permanente para el primer valor, sin transitorio de arranque
+        double x = v[0];
+        for (Biquad &s : m_sections) {
+            s.reset(x);
+            x *= s.dcGain();
+        }
+        m_primed = true;
+    }
+
+    for (Biquad &s : m_sections)
+        for (int i = 0; i < n; ++i)
+            v[i] = float(s.process(v[i]));
+}
+
+
+
+void BiquadCascadeStage::reset(){
+    m_sections = m_initial;
+    m_primed = false;
+}
+
+
+
+/**
+ * @param taps Coeficientes h[0..N−1]; y[n] = Σ h[k]·x[n−k].
+ */
+FirStage::FirStage(std::vector<float> taps)
+    : m_reversed(taps.rbegin(), taps.rend())
+{
+    if (m_reversed.empty()) m_reversed.push_back(1.0f);
+}
+
+
+
+/**
+ * La historia y el lote se copian a un búfer contiguo para que cada salida sea un producto
+ * escalar hacia delante entre dos vectores, que el compilador vectoriza.
+ */
+void FirStage::process(SampleBatch &batch){
+    if (batch.isEmpty()) return;
+    const int taps = int(m_reversed.size());
+    const int history = taps - 1;
+    const int n = batch.size();
+
+    if (!m_primed) {
+        m_buffer.assign(size_t(history), batch.v[0]);   // se arranca con la señal constante
+        m_primed = true;
+    }
+    m_buffer.resize(size_t(history));
+    m_buffer.insert(m_buffer.end(), batch.v.begin(), batch.v.end());
+    m_out.resize(size_t(n));
+
+    const float *h = m_reversed.data();
+    const float *x = m_buffer.data();
+    for (int i = 0; i < n; ++i) {
+        const float *xi = x + i;
+        float acc = 0.0f;
+        for (int k = 0; k < taps; ++k)
+            acc += h[k] * xi[k];
+        m_out[size_t(i)] = acc;
+    }
+    batch.v.swap(m_out);
+
+    // Se conservan las últimas (taps − 1) muestras al principio del búfer
+    std::copy(m_buffer.end() - history, m_buffer.end(), m_buffer.begin());
+}
+
+
+
+void FirStage::reset(){
+    m_buffer.clear();
+    m_primed = false;
+}
+
+
+
+QString FirStage::describe() const {
+    QStringList coeffs;
+    for (auto it = m_reversed.rbegin(); it != m_reversed.rend(); ++it)
+        coeffs << QString::number(*it);
+    return "fir:" + coeffs.join(',');
+}
+
+
+
+MovingAverageStage::MovingAverageStage(int length)
+    : m_ring(size_t(std::max(1, length)), 0.0f)
+{
+}
+
+
+
+void MovingAverageStage::process(SampleBatch &batch){
+    const int len = int(m_ring.size());
+    for (float &x : batch.v) {
+        if (m_filled == len) m_sum -= m_ring[size_t(m_pos)];
+        else ++m_filled;
+        m_ring[size_t(m_pos)] = x;
+        m_sum += x;
+        m_pos = (m_pos + 1) % len;
+        x = float(m_sum / m_filled);
+    }
+}
+
+
+
+void MovingAverageStage::reset(){
+    std::fill(m_ring.begin(), m_ring.end(), 0.0f);
+    m_pos = 0;
+    m_filled = 0;
+    m_sum = 0.0;
+}
+
+
+
+DecimatorStage::DecimatorStage(int factor)
+    : m_factor(std::max(1, factor))
+{
+}
+
+
+
+/**
+ * Cada grupo de m muestras produce una con su media y el tiempo de la última. Los grupos
+ * pueden repartirse entre lotes: la fase y el acumulado se conservan.
+ */
+void DecimatorStage::process(SampleBatch &batch){
+    if (m_factor == 1) return;
+    int out = 0;
+    const int n = batch.size();
+    for (int i = 0; i < n; ++i) {
+        m_acc += batch.v[size_t(i)];
+        if (++m_phase == m_factor) {
+            batch.t[size_t(out)] = batch.t[size_t(i)];
+            batch.v[size_t(out)] = float(m_acc / m_factor);
+            ++out;
+            m_phase = 0;
+            m_acc = 0.0;
+        }
+    }
+    batch.t.resize(size_t(out));
+    batch.v.resize(size_t(out));
+}
+
+
+
+void DecimatorStage::reset(){
+    m_phase = 0;
+    m_acc = 0.0;
+}
+
+
+
+void ClampStage::process(SampleBatch &batch){
+    float *v = batch.v.data();
+    const int n = batch.size();
+    const float lo = m_low, hi = m_high;
+    for (int i = 0; i < n; ++i)
+        v[i] = std::min(hi, std::max(lo, v[i]));
+}
+
+
+
+void ScaleStage::process(SampleBatch &batch){
+    float *v = batch.v.data();
+    const int n = batch.size();
+    const float g = m_gain, o = m_offset;
+    for (int i = 0; i < n; ++i)
+        v[i] = v[i] * g + o;
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      StreamPipeline
+// ---------------------------------------------------------------------------
+
+/**
+ * Crea una etapa a partir de su descripción "nombre:arg1,arg2".
+ *
+ * @param spec Descripción de la etapa.
+ * @param sampleHz Frecuencia de muestreo a la entrada de la etapa (para los filtros IIR).
+ * @param error Mensaje de error opcional.
+ * @return La etapa, o nullptr si la descripción no es válida.
+ */
+StreamPipeline::StagePtr StreamPipeline::createStage(const QString &spec, double sampleHz, QString *error){
+    const int colon = spec.indexOf(':');
+    const QString name = (colon < 0 ? spec : spec.left(colon)).trimmed().toLower();
+    std::vector<double> a;
+    if (!parseArgs(colon < 0 ? QString() : spec.mid(colon + 1), a)) {
+        setError(error, "Argumentos no numéricos en '" + spec + "'");
+        return nullptr;
+    }
+
+    const double nyquist = sampleHz / 2.0;
+    auto cutoffOk = [&](double f) { return f > 0.0 && f < nyquist; };
+
+    if (name == "lowpass" || name == "highpass") {
+        if (a.empty() || !cutoffOk(a[0])) {
+            setError(error, QString("Frecuencia de corte fuera de (0, %1) Hz en '%2'").arg(nyquist).arg(spec));
+            return nullptr;
+        }
+        int order = a.size() > 1 ? int(a[1]) : 2;
+        order = std::clamp(order + (order & 1), 2, 8);
+        std::vector<Biquad> sections;
+        for (double q : butterworthQ(order))
+            sections.push_back(name == "lowpass" ? Biquad::lowPass(a[0], sampleHz, q)
+                                                 : Biquad::highPass(a[0], sampleHz, q));
+        return std::make_unique<BiquadCascadeStage>(std::move(sections),
+                                                    QString("%1:%2,%3").arg(name).arg(a[0]).arg(order));
+    }
+    if (name == "bandpass") {
+        if (a.size() < 2 || !cutoffOk(a[0]) || !cutoffOk(a[1]) || a[0] >= a[1]) {
+            setError(error, "Banda no válida en '" + spec + "'");
+            return nullptr;
+        }
+        std::vector<Biquad> sections { Biquad::highPass(a[0], sampleHz), Biquad::lowPass(a[1], sampleHz) };
+        return std::make_unique<BiquadCascadeStage>(std::move(sections),
+                                                    QString("bandpass:%1,%2").arg(a[0]).arg(a[1]));
+    }
+    if (name == "fir") {
+        if (a.empty()) {
+            setError(error, "FIR sin coeficientes");
+            return nullptr;
+        }
+        return std::make_unique<FirStage>(std::vector<float>(a.begin(), a.end()));
+    }
+    if (name == "mavg" && a.size() == 1 && a[0] >= 1)
+        return std::make_unique<MovingAverageStage>(int(a[0]));
+    if (name == "decimate" && a.size() == 1 && a[0] >= 1)
+        return std::make_unique<DecimatorStage>(int(a[0]));
+    if (name == "clamp" && a.size() == 2 && a[0] <= a[1])
+        return std::make_unique<ClampStage>(float(a[0]), float(a[1]));
+    if (name == "scale" && !a.empty())
+        return std::make_unique<ScaleStage>(float(a[0]), a.size() > 1 ? float(a[1]) : 0.0f);
+
+    setError(error, "Etapa no reconocida: '" + spec + "'");
+    return nullptr;
+}
+
+
+
+/**
+ * Prepara una nueva cadena para el canal. Se instala al comienzo del siguiente lote de ese
+ * canal; hasta entonces sigue activa la anterior. Si alguna etapa no es válida no se cambia nada.
+ *
+ * @param channelID Canal al que se aplica.
+ * @param spec Etapas separadas por ';' (vacío = sin procesado).
+ * @param sampleHz Frecuencia nominal del canal; los diezmados la dividen para las etapas siguientes.
+ * @param error Mensaje de error opcional.
+ * @return true si la cadena es válida.
+ */
+bool StreamPipeline::configure(const QString &channelID, const QString &spec, double sampleHz, QString *error){
+    auto chain = std::make_shared<Chain>();
+    double hz = sampleHz;
+
+    for (const QString &part : spec.split(';', Qt::SkipEmptyParts)) {
+        StagePtr stage = createStage(part, hz, error);
+        if (!stage) return false;
+        if (auto *dec = dynamic_cast<DecimatorStage *>(stage.get())) {
+            hz /= dec->factor();
+            chain->decimation *= dec->factor();
+        }
+        chain->stages.push_back(std::move(stage));
+    }
+
+    QMutexLocker locker(&m_pendingMutex);
+    m_pending.insert(channelID, chain->stages.empty() ? nullptr : chain);
+    m_hasPending.store(true, std::memory_order_release);
+    return true;
+}
+
+
+
+void StreamPipeline::clear(const QString &channelID){
+    QMutexLocker locker(&m_pendingMutex);
+    m_pending.insert(channelID, nullptr);
+    m_hasPending.store(true, std::memory_order_release);
+}
+
+
+
+/**
+ * @return Descripción de la cadena que se aplicará al canal (incluida la pendiente).
+ */
+QString StreamPipeline::describe(const QString &channelID) const {
+    std::shared_ptr<Chain> chain;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        auto it = m_pending.constFind(channelID);
+        chain = it != m_pending.constEnd() ? it.value() : m_chains.value(channelID);
+    }
+    if (!chain) return QString();
+
+    QStringList parts;
+    for (const StagePtr &stage : chain->stages)
+        parts << stage->describe();
+    return parts.join(';');
+}
+
+
+
+/**
+ * @return Factor por el que la cadena instalada divide la frecuencia del canal (1 sin diezmado).
+ */
+int StreamPipeline::decimation(const QString &channelID) const {
+    auto it = m_chains.constFind(channelID);
+    return it != m_chains.constEnd() ? it.value()->decimation : 1;
+}
+
+
+
+/**
+ * Aplica la cadena del canal al lote, en el sitio. Los canales sin cadena no se tocan.
+ */
+void StreamPipeline::process(const QString &channelID, SampleBatch &batch){
+    if (m_hasPending.load(std::memory_order_acquire))
+        installPending();
+
+    auto it = m_chains.constFind(channelID);
+    if (it == m_chains.constEnd()) return;
+
+    for (const StagePtr &stage : it.value()->stages) {
+        if (batch.isEmpty()) break;
+        stage->process(batch);
+    }
+}
+
+
+
+// Reinicia el estado de todas las etapas (al reiniciar el tiempo de la sesión)
+void StreamPipeline::reset(){
+    if (m_hasPending.load(std::memory_order_acquire))
+        installPending();
+    for (const auto &chain : std::as_const(m_chains))
+        for (const StagePtr &stage : chain->stages)
+            stage->reset();
+}
+
+
+
+void StreamPipeline::installPending(){
+    QMutexLocker locker(&m_pendingMutex);
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (it.value()) m_chains.insert(it.key(), it.value());
+        else            m_chains.remove(it.key());
+    }
+    m_pending.clear();
+    m_hasPending.store(false, std::memory_order_release);
+}
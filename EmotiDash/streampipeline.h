@@ -0,0 +1,193 @@
+/**
+*  file StreamPipeline.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef STREAMPIPELINE_H
+#define STREAMPIPELINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "dspfilters.h"
+#include "timeseriesstore.h"
+
+/*!
+ * \class PipelineStage
+ * \brief Etapa de procesado que transforma un lote SoA de muestras en el sitio.
+ *
+ * Cada etapa guarda su propio estado entre lotes, de modo que partir la señal en paquetes
+ * no cambia el resultado. Las etapas sin recursión (FIR, escala, recorte) recorren vectores
+ * contiguos sin dependencias entre muestras para que el compilador las vectorice.
+ */
+class PipelineStage {
+public:
+    virtual ~PipelineStage() = default;
+    virtual void process(SampleBatch &batch) = 0;
+    virtual void reset() = 0;
+    virtual QString describe() const = 0;
+};
+
+
+
+/// Cascada de secciones bicuadráticas (paso bajo, paso alto o paso banda).
+class BiquadCascadeStage : public PipelineStage {
+public:
+    explicit BiquadCascadeStage(std::vector<Biquad> sections, const QString &description);
+    void process(SampleBatch &batch) override;
+    void reset() override;
+    QString describe() const override { return m_description; }
+
+private:
+    std::vector<Biquad> m_sections;
+    std::vector<Biquad> m_initial;
+    QString m_description;
+    bool m_primed = false;
+};
+
+/// Filtro FIR con coeficientes arbitrarios.
+class FirStage : public PipelineStage {
+public:
+    explicit FirStage(std::vector<float> taps);
+    void process(SampleBatch &batch) override;
+    void reset() override;
+    QString describe() const override;
+
+private:
+    std::vector<float> m_reversed;   // coeficientes invertidos: producto escalar hacia delante
+    std::vector<float> m_buffer;     // historia (taps − 1) + lote actual
+    std::vector<float> m_out;
+    bool m_primed = false;
+};
+
+/// Media móvil de N muestras con suma corriente.
+class MovingAverageStage : public PipelineStage {
+public:
+    explicit MovingAverageStage(int length);
+    void process(SampleBatch &batch) override;
+    void reset() override;
+    QString describe() const override { return QString("mavg:%1").arg(m_ring.size()); }
+
+private:
+    std::vector<float> m_ring;
+    int m_pos = 0;
+    int m_filled = 0;
+    double m_sum = 0.0;
+};
+
+/// Diezmado por un factor entero, promediando cada grupo (antialias de caja).
+class DecimatorStage : public PipelineStage {
+public:
+    explicit DecimatorStage(int factor);
+    void process(SampleBatch &batch) override;
+    void reset() override;
+    QString describe() const override { return QString("decimate:%1").arg(m_factor); }
+    int factor() const { return m_factor; }
+
+private:
+    int m_factor;
+    int m_phase = 0;
+    double m_acc = 0.0;
+};
+
+/// Recorte a [low, high].
+class ClampStage : public PipelineStage {
+public:
+    ClampStage(float low, float high) : m_low(low), m_high(high) {}
+    void process(SampleBatch &batch) override;
+    void reset() override {}
+    QString describe() const override { return QString("clamp:%1,%2").arg(m_low).arg(m_high); }
+
+private:
+    float m_low, m_high;
+};
+
+/// Conversión de unidades: v·gain + offset.
+class ScaleStage : public PipelineStage {
+public:
+    ScaleStage(float gain, float offset) : m_gain(gain), m_offset(offset) {}
+    void process(SampleBatch &batch) override;
+    void reset() override {}
+    QString describe() const override { return QString("scale:%1,%2").arg(m_gain).arg(m_offset); }
+
+private:
+    float m_gain, m_offset;
+};
+
+
+
+/*!
+ * \class StreamPipeline
+ * \brief Cadenas de etapas por canal, reconfigurables en caliente.
+ *
+ * Cada canal tiene una cadena de etapas que se aplica a cada lote antes de publicarlo, de modo
+ * que todos los consumidores (gráficas, analíticas, sesión) ven la señal ya acondicionada. Los
+ * canales sin cadena pasan sin coste.
+ *
+ * Las cadenas se describen con texto, por ejemplo "lowpass:5;decimate:2;clamp:0,30":
+ * - lowpass:fc[,orden]  highpass:fc[,orden]  bandpass:f0,f1  (Butterworth de orden par en biquads)
+ * - fir:c0,c1,...   mavg:n   decimate:m   clamp:lo,hi   scale:gain[,offset]
+ *
+ * configure() puede llamarse desde cualquier hilo: la nueva cadena queda pendiente y se instala
+ * al inicio del siguiente lote de ese canal, sin parar el flujo ni perder muestras.
+ *
+ * Los diezmados cambian la frecuencia real del canal: decimation() y outputHz() dan la de la
+ * cadena instalada, que es la que deben usar los consumidores (PSD, analíticas, alineado).
+ *
+ * \see PipelineStage, EmotiBitController
+ * \author Enrique Fuentes
+ * \date 2025-05-29
+ */
+class StreamPipeline {
+public:
+    using StagePtr = std::unique_ptr<PipelineStage>;
+
+    // Crea una etapa a partir de su descripción; nullptr si no es válida
+    static StagePtr createStage(const QString &spec, double sampleHz, QString *error = nullptr);
+
+    // Sustituye la cadena de un canal (cadena vacía = sin procesado)
+    bool configure(const QString &channelID, const QString &spec, double sampleHz, QString *error = nullptr);
+    void clear(const QString &channelID);
+
+    QString describe(const QString &channelID) const;
+
+    // Factor de diezmado total de la cadena instalada y frecuencia a su salida (solo el hilo de procesado)
+    int decimation(const QString &channelID) const;
+    double outputHz(const QString &channelID, double inputHz) const { return inputHz / decimation(channelID); }
+
+    // Aplica la cadena del canal al lote (solo el hilo de procesado)
+    void process(const QString &channelID, SampleBatch &batch);
+    void reset();
+
+private:
+    struct Chain {
+        std::vector<StagePtr> stages;
+        int decimation = 1;        // producto de los factores de los diezmados
+    };
+
+    void installPending();
+
+    QHash<QString, std::shared_ptr<Chain>> m_chains;
+
+    mutable QMutex m_pendingMutex;
+    QHash<QString, std::shared_ptr<Chain>> m_pending;   // nullptr = eliminar la cadena
+    std::atomic<bool> m_hasPending {false};
+};
+
+#endif // STREAMPIPELINE_H
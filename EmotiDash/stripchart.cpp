@@ -0,0 +1,563 @@
+/****************************************************************************
+ * StripChart.cpp
+ *
+ * Descripción: Gráfica de desplazamiento con QPainter. Prepara cada
+ * fotograma en el hilo de la interfaz, lo rasteriza en un hilo del pool
+ * con StripChartRenderer y solo copia la imagen terminada.
+ *
+ * Fecha: 2025-05-31
+ ****************************************************************************/
+
+#include "stripchart.h"
+#include <QPainter>
+#include <QThread>
+#include <QThreadPool>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kLegendHeight = 12;   // franja superior con los nombres de los canales
+constexpr int kAxisWidth    = 46;   // franja derecha con las etiquetas del eje Y
+constexpr float kBadQuality = 50.0f;
+constexpr double kZoomStep  = 1.25;      // factor de zoom por paso de la rueda
+constexpr qint64 kMinViewUs = 100000;    // vista mínima de la sesión: 100 ms
+
+QFont chartFont(){
+    return QFont("Arial", 6);
+}
+
+}
+
+
+
+StripChart::StripChart(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAutoFillBackground(false);
+    setFont(chartFont());
+}
+
+
+
+StripChart::~StripChart()
+{
+    // el trabajo en curso usa m_renderer y m_frame: se espera a que termine
+    while (m_rendering.load(std::memory_order_acquire))
+        QThread::yieldCurrentThread();
+}
+
+
+
+void StripChart::setStore(const TimeSeriesStore *store){
+    m_store = store;
+    while (m_rendering.load(std::memory_order_acquire))
+        QThread::yieldCurrentThread();
+    m_renderer.setStore(store);
+    reset();
+}
+
+
+
+void StripChart::setStats(const ChannelStats *stats){
+    m_stats = stats;
+    m_hasRange = false;
+    m_needsFull = true;
+}
+
+
+
+void StripChart::setSession(const SessionStore *session){
+    m_session = session;
+    if (!m_live) m_needsFull = true;
+}
+
+
+
+void StripChart::setWindowSeconds(double seconds){
+    m_windowSeconds = std::max(0.1, seconds);
+    m_needsFull = true;
+}
+
+
+
+void StripChart::addChannel(const QString &channelID, const QColor &color, const QString &label){
+    if (hasChannel(channelID)) return;
+    Channel c;
+    c.id = channelID;
+    c.label = label;
+    c.color = color;
+    m_channels.push_back(c);
+    m_needsFull = true;
+    update(m_legendRect);
+}
+
+
+
+bool StripChart::hasChannel(const QString &channelID) const {
+    return std::any_of(m_channels.begin(), m_channels.end(),
+                       [&](const Channel &c) { return c.id == channelID; });
+}
+
+
+
+/**
+ * Guarda la calidad del canal. El nombre de la leyenda pasa a "ID Qnn" y, si el estilo del
+ * trazo cambia (bueno ↔ malo), se rehace el trazado en el siguiente fotograma.
+ */
+void StripChart::setChannelQuality(const QString &channelID, float score){
+    for (Channel &c : m_channels) {
+        if (c.id != channelID) continue;
+        const bool wasBad = c.quality >= 0.0f && c.quality < kBadQuality;
+        const bool isBad = score < kBadQuality;
+        c.quality = score;
+        if (wasBad != isBad) m_needsFull = true;
+        update(m_legendRect);
+        return;
+    }
+}
+
+
+
+void StripChart::reset(){
+    for (Channel &c : m_channels)
+        c.seenEpoch = 0;
+    m_hasRange = false;
+    m_needsFull = true;
+    m_resetPending = true;       // el renderizador olvida sus cursores en el siguiente fotograma
+    m_live = true;
+    m_dragging = false;
+    m_shownEndUs = -1;
+    m_front = QImage();
+    m_traceFrame.clear();
+    m_tracePresent.clear();
+    update();
+}
+
+
+
+/**
+ * Un fotograma: copia el resultado del anterior y, si hay datos nuevos o hay que redibujar,
+ * prepara la entrada del siguiente y lo lanza en el pool. Si el anterior todavía se está
+ * dibujando, este fotograma se salta.
+ *
+ * @return Instante de la última muestra en segundos, o -1 si aún no hay datos.
+ */
+double StripChart::advance(){
+    if (m_plotRect.isEmpty()) return -1.0;
+    if (m_rendering.load(std::memory_order_acquire)) {
+        ++m_skippedFrames;
+        return m_shownEndUs >= 0 ? m_shownEndUs / 1e6 : -1.0;
+    }
+    blit();
+
+    if (!m_live) {
+        // la vista de la sesión es fija: solo se rehace si ha cambiado la vista o el tamaño
+        if (m_needsFull) {
+            prepareHistory();
+            dispatch();
+        }
+        return -1.0;
+    }
+    if (!m_store) return -1.0;
+
+    qint64 tEnd = -1;
+    bool fresh = false;
+    for (Channel &c : m_channels) {
+        const ChannelRing *ring = m_store->find(c.id);
+        if (!ring || ring->epoch() == 0) continue;
+        tEnd = std::max(tEnd, ring->lastTime());
+        if (ring->epoch() != c.seenEpoch) fresh = true;
+        c.seenEpoch = ring->epoch();
+    }
+    if (tEnd < 0) return -1.0;
+    if (m_renderer.wantsFull()) m_needsFull = true;
+    if (!fresh && !m_needsFull) return tEnd / 1e6;
+
+    if (updateRange()) m_needsFull = true;
+    prepareFrame();
+    m_frame.live = true;
+    m_frame.tEndUs = tEnd;
+    m_frame.windowSeconds = m_windowSeconds;
+    m_frame.columns.clear();
+    if (m_tracer) {
+        // las sondas de latencia cuyas muestras entran en este fotograma viajan con él
+        for (const Channel &c : m_channels)
+            m_tracer->framePrepared(c.id, c.seenEpoch, m_traceFrame);
+    }
+    dispatch();
+    return tEnd / 1e6;
+}
+
+
+
+/**
+ * Muestra un tramo fijo de la sesión. La gráfica deja de seguir los datos en vivo hasta setLive().
+ *
+ * @param t0Us Inicio de la vista en µs.
+ * @param t1Us Fin de la vista en µs.
+ */
+void StripChart::setView(qint64 t0Us, qint64 t1Us){
+    m_live = false;
+    m_viewT0Us = t0Us;
+    m_viewT1Us = std::max(t1Us, t0Us + kMinViewUs);
+    m_needsFull = true;          // se dibuja en el siguiente fotograma
+}
+
+
+
+void StripChart::setLive(){
+    if (m_live) return;
+    m_live = true;
+    m_hasRange = false;
+    m_needsFull = true;
+}
+
+
+
+void StripChart::paintEvent(QPaintEvent *event){
+    QPainter p(this);
+    const QRect dirty = event->rect();
+
+    if (dirty.intersects(m_plotRect)) {
+        // tras un cambio de tamaño se escala el último fotograma hasta que llega el nuevo
+        if (m_front.isNull()) p.fillRect(m_plotRect, palette().color(QPalette::Base));
+        else p.drawImage(QRectF(m_plotRect), m_front);
+        if (m_tracer && !m_tracePresent.empty())
+            m_tracer->framePresented(m_tracePresent);
+    }
+
+    if (dirty.intersects(m_legendRect)) {
+        p.fillRect(m_legendRect, palette().color(QPalette::Window));
+        int x = m_legendRect.left() + 2;
+        const QFontMetrics fm(font());
+        for (const Channel &c : m_channels) {
+            const QString name = c.quality >= 0.0f
+                                     ? QString("%1 Q%2").arg(c.id).arg(qRound(c.quality))
+                                     : c.id;
+            p.fillRect(QRect(x, m_legendRect.center().y() - 2, 6, 5), c.color);
+            x += 8;
+            p.setPen(palette().color(QPalette::WindowText));
+            p.drawText(QRect(x, m_legendRect.top(), fm.horizontalAdvance(name) + 2, m_legendRect.height()),
+                       Qt::AlignLeft | Qt::AlignVCenter, name);
+            x += fm.horizontalAdvance(name) + 8;
+        }
+    }
+
+    if (dirty.intersects(m_axisRect)) {
+        p.fillRect(m_axisRect, palette().color(QPalette::Window));
+        p.setPen(palette().color(QPalette::Mid));
+        p.drawLine(m_axisRect.topLeft(), m_axisRect.bottomLeft());
+        p.setPen(palette().color(QPalette::WindowText));
+        const int h = m_axisRect.height();
+        for (int i = 0; i < m_axisLabels.size(); ++i) {
+            const int y = m_axisRect.top() + i * (h - 1) / std::max(1, int(m_axisLabels.size()) - 1);
+            const Qt::Alignment va = i == 0 ? Qt::AlignTop : (i == m_axisLabels.size() - 1 ? Qt::AlignBottom : Qt::AlignVCenter);
+            const QRect box(m_axisRect.left() + 3, va == Qt::AlignTop ? y : (va == Qt::AlignBottom ? y - 10 : y - 5),
+                            m_axisRect.width() - 3, 10);
+            p.drawText(box, Qt::AlignLeft | va, m_axisLabels[i]);
+        }
+    }
+}
+
+
+
+void StripChart::resizeEvent(QResizeEvent *event){
+    QWidget::resizeEvent(event);
+    layoutRects();
+    m_dpr = devicePixelRatioF();
+    m_needsFull = true;
+}
+
+
+
+// Rueda: zoom alrededor del instante bajo el cursor, desde la ventana en vivo hasta la sesión entera
+void StripChart::wheelEvent(QWheelEvent *event){
+    const double steps = event->angleDelta().y() / 120.0;
+    if (steps == 0.0 || m_plotRect.width() <= 0) {
+        event->ignore();
+        return;
+    }
+    beginHistory();
+
+    qint64 sessionUs = qint64(m_windowSeconds * 1e6);
+    if (m_session) {
+        for (const Channel &c : m_channels)
+            if (const MinMaxPyramid *pyramid = m_session->pyramid(c.id))
+                sessionUs = std::max(sessionUs, pyramid->lastTime() - pyramid->firstTime());
+    }
+
+    const double span = double(m_viewT1Us - m_viewT0Us);
+    const double frac = std::clamp((event->position().x() - m_plotRect.left()) / m_plotRect.width(), 0.0, 1.0);
+    const double anchor = m_viewT0Us + frac * span;
+    const double newSpan = std::clamp(span * std::pow(kZoomStep, -steps),
+                                      double(kMinViewUs), 1.1 * double(sessionUs));
+    const qint64 t0 = qint64(anchor - frac * newSpan);
+    setView(t0, t0 + qint64(newSpan));
+    emit viewChanged(m_viewT0Us, m_viewT1Us);
+    event->accept();
+}
+
+
+
+void StripChart::mousePressEvent(QMouseEvent *event){
+    if (event->button() != Qt::LeftButton || !m_plotRect.contains(event->position().toPoint())) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    m_dragging = true;
+    m_dragX = event->position().toPoint().x();
+    m_dragT0Us = m_live ? qint64(m_rightUs - m_windowSeconds * 1e6) : m_viewT0Us;
+    setCursor(Qt::ClosedHandCursor);
+}
+
+
+
+// Arrastrar desplaza la vista por la sesión; en vivo hace falta un pequeño umbral para salir
+void StripChart::mouseMoveEvent(QMouseEvent *event){
+    if (!m_dragging || m_plotRect.width() <= 0) return;
+    const int dx = event->position().toPoint().x() - m_dragX;
+    if (m_live && std::abs(dx) < 3) return;
+
+    beginHistory();
+    const qint64 span = m_viewT1Us - m_viewT0Us;
+    const qint64 t0 = m_dragT0Us - qint64(double(dx) * span / m_plotRect.width());
+    setView(t0, t0 + span);
+    emit viewChanged(m_viewT0Us, m_viewT1Us);
+}
+
+
+
+void StripChart::mouseReleaseEvent(QMouseEvent *event){
+    if (event->button() == Qt::LeftButton && m_dragging) {
+        m_dragging = false;
+        unsetCursor();
+    }
+}
+
+
+
+void StripChart::mouseDoubleClickEvent(QMouseEvent *event){
+    if (event->button() != Qt::LeftButton) return;
+    setLive();
+    emit liveRequested();
+}
+
+
+
+// Al salir del modo en vivo la vista parte de la ventana que se estaba mostrando
+void StripChart::beginHistory(){
+    if (!m_live) return;
+    m_viewT1Us = qint64(m_rightUs);
+    m_viewT0Us = m_viewT1Us - qint64(m_windowSeconds * 1e6);
+    m_live = false;
+}
+
+
+
+void StripChart::layoutRects(){
+    const QRect r = rect();
+    m_legendRect = QRect(r.left(), r.top(), r.width(), kLegendHeight);
+    m_axisRect = QRect(r.right() - kAxisWidth + 1, r.top() + kLegendHeight, kAxisWidth, r.height() - kLegendHeight);
+    m_plotRect = QRect(r.left(), r.top() + kLegendHeight, r.width() - kAxisWidth, r.height() - kLegendHeight);
+}
+
+
+
+/**
+ * Ajusta el rango Y a partir de las estadísticas de ventana de los canales. Se amplía cuando
+ * los datos se salen y se reduce cuando ocupan menos del 40 %, dejando holgura para no
+ * redibujar en cada fotograma.
+ *
+ * @return true si el rango ha cambiado.
+ */
+bool StripChart::updateRange(){
+    if (!m_stats) return false;
+
+    double lo = 0.0, hi = 0.0;
+    bool any = false;
+    for (const Channel &c : m_channels) {
+        const WindowedStats *ws = m_stats->find(c.id);
+        if (!ws || ws->isEmpty()) continue;
+        lo = any ? std::min(lo, double(ws->min())) : ws->min();
+        hi = any ? std::max(hi, double(ws->max())) : ws->max();
+        any = true;
+    }
+    if (!any) return false;
+
+    double span = hi - lo;
+    if (span <= 0.0) span = std::max(1e-3, std::fabs(hi) * 0.1);
+
+    const bool outside = lo < m_yMin || hi > m_yMax;
+    const bool tooWide = span < 0.4 * (m_yMax - m_yMin);
+    if (m_hasRange && !outside && !tooWide) return false;
+
+    m_yMin = lo - 0.25 * span;
+    m_yMax = hi + 0.25 * span;
+    m_hasRange = true;
+    updateAxisLabels();
+    return true;
+}
+
+
+
+// Etiquetas máximo / medio / mínimo con los decimales según la magnitud
+void StripChart::updateAxisLabels(){
+    const double absMax = std::max(std::fabs(m_yMin), std::fabs(m_yMax));
+    int decimals;
+    if (absMax < 100.0)
+        decimals = 4;
+    else if (absMax < 1000.0)
+        decimals = 3;
+    else if (absMax < 10000.0)
+        decimals = 1;
+    else
+        decimals = 0;
+
+    m_axisLabels = { QString::number(m_yMax, 'f', decimals),
+                     QString::number(0.5 * (m_yMin + m_yMax), 'f', decimals),
+                     QString::number(m_yMin, 'f', decimals) };
+    update(m_axisRect);
+}
+
+
+
+// Entrada común a los dos modos; se hace con el renderizador parado
+void StripChart::prepareFrame(){
+    m_frame.size = deviceSize();
+    m_frame.background = palette().color(QPalette::Base);
+    m_frame.grid = palette().color(QPalette::Midlight);
+    m_frame.traces.resize(m_channels.size());
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        m_frame.traces[i].id = m_channels[i].id;
+        m_frame.traces[i].pen = penFor(m_channels[i]);
+    }
+    m_frame.yMin = m_yMin;
+    m_frame.yMax = m_yMax;
+    m_frame.full = m_needsFull;
+    m_frame.reset = m_resetPending;
+    m_needsFull = false;
+    m_resetPending = false;
+}
+
+
+
+// Vista de la sesión: las pirámides no admiten lectores concurrentes, así que las columnas se
+// resumen aquí (tiempo proporcional al ancho) y el renderizador solo las dibuja
+void StripChart::prepareHistory(){
+    const int w = deviceSize().width();
+    m_frame.columns.resize(m_channels.size());
+
+    double lo = 0.0, hi = 0.0;
+    bool any = false;
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        historyColumns(m_channels[i], w, m_frame.columns[i]);
+        for (const auto &col : m_frame.columns[i]) {
+            if (col.count == 0) continue;
+            lo = any ? std::min(lo, double(col.vMin)) : col.vMin;
+            hi = any ? std::max(hi, double(col.vMax)) : col.vMax;
+            any = true;
+        }
+    }
+    if (any) {
+        double span = hi - lo;
+        if (span <= 0.0) span = std::max(1e-3, std::fabs(hi) * 0.1);
+        m_yMin = lo - 0.1 * span;
+        m_yMax = hi + 0.1 * span;
+        updateAxisLabels();
+    }
+    m_hasRange = false;     // al volver al modo en vivo se recalcula desde las estadísticas
+
+    prepareFrame();
+    m_frame.live = false;
+    m_frame.viewT0Us = m_viewT0Us;
+    m_frame.viewT1Us = m_viewT1Us;
+}
+
+
+
+// Resumen por columna de un canal: desde la pirámide, o desde las muestras si el zoom es muy fino
+void StripChart::historyColumns(const Channel &c, int width, std::vector<MinMaxPyramid::Column> &out) const {
+    out.assign(size_t(width), MinMaxPyramid::Column());
+    if (!m_session) return;
+
+    const MinMaxPyramid *pyramid = m_session->pyramid(c.id);
+    if (pyramid && pyramid->render(m_viewT0Us, m_viewT1Us, width, out)) return;
+
+    // Menos muestras por columna que un intervalo del nivel 0: se leen de la serie comprimida
+    const CompressedSeries *series = m_session->find(c.id);
+    if (!series) return;
+    out.assign(size_t(width), MinMaxPyramid::Column());
+    const double usPerPx = double(m_viewT1Us - m_viewT0Us) / std::max(1, width);
+    series->forEachInRange(m_viewT0Us, m_viewT1Us, [&](qint64 t, float v) {
+        const int x = std::min(width - 1, int((t - m_viewT0Us) / usPerPx));
+        MinMaxPyramid::Column &col = out[x];
+        if (col.count == 0) {
+            col.vMin = col.vMax = col.mean = v;
+        } else {
+            col.vMin = std::min(col.vMin, v);
+            col.vMax = std::max(col.vMax, v);
+            col.mean += (v - col.mean) / float(col.count + 1);
+        }
+        ++col.count;
+    });
+}
+
+
+
+// Lanza el rasterizado del fotograma preparado; sin pool se hace aquí mismo
+void StripChart::dispatch(){
+    m_unblitted = true;
+    if (!m_pool) {
+        m_renderer.render(m_frame);
+        blit();
+        return;
+    }
+
+    m_rendering.store(true, std::memory_order_release);
+    m_pool->start([this]() {
+        m_renderer.render(m_frame);
+        // se avisa antes de liberar: el destructor espera a m_rendering y el objeto sigue vivo
+        QMetaObject::invokeMethod(this, &StripChart::blit, Qt::QueuedConnection);
+        m_rendering.store(false, std::memory_order_release);
+    });
+}
+
+
+
+// Copia el fotograma terminado (copia implícita del QImage) y repinta solo el área de dibujo
+void StripChart::blit(){
+    if (!m_unblitted || m_rendering.load(std::memory_order_acquire)) return;
+    m_unblitted = false;
+    m_front = m_renderer.image();
+    m_rightUs = m_renderer.rightUs();
+    m_pointsDrawn += quint64(m_renderer.pointsDrawn());
+    if (m_frame.live) m_shownEndUs = m_frame.tEndUs;
+    m_tracePresent.insert(m_tracePresent.end(), m_traceFrame.begin(), m_traceFrame.end());
+    m_traceFrame.clear();
+    update(m_plotRect);
+}
+
+
+
+QPen StripChart::penFor(const Channel &c) const {
+    QPen pen(c.color);
+    pen.setWidthF(m_dpr);
+    if (c.quality >= 0.0f && c.quality < kBadQuality)
+        pen.setStyle(Qt::DashLine);
+    return pen;
+}
+
+
+
+// Tamaño del área de dibujo en píxeles físicos
+QSize StripChart::deviceSize() const {
+    return QSize(std::max(1, qRound(m_plotRect.width() * m_dpr)),
+                 std::max(1, qRound(m_plotRect.height() * m_dpr)));
+}
@@ -0,0 +1,184 @@
+/**
+*  file StripChart.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <QWidget>
+#include <QImage>
+#include <QColor>
+#include <QPen>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include <atomic>
+#include "timeseriesstore.h"
+#include "windowedstats.h"
+#include "sessionstore.h"
+#include "stripchartrenderer.h"
+#include "latencytracer.h"
+
+class QThreadPool;
+
+/*!
+ * \class StripChart
+ * \brief Gráfica de desplazamiento ligera que dibuja con QPainter directamente desde el almacén.
+ *
+ * Sustituye a QChart/QChartView en el panel de gráficas. El trazado se guarda en una imagen del
+ * tamaño del área de dibujo (en píxeles físicos):
+ * - en cada fotograma la imagen se desplaza a la izquierda tantos píxeles como haya avanzado el
+ *   tiempo y solo se dibujan las muestras nuevas de cada canal (cursor en su anillo), en la
+ *   franja que queda libre a la derecha;
+ * - el trazado completo solo se rehace al cambiar el rango Y, el tamaño o tras un reinicio, y
+ *   en ese caso se reduce a mínimo/máximo por píxel con PlotDecimator;
+ * - el eje Y (tres etiquetas) y la leyenda se calculan una vez y quedan fuera del área que se
+ *   repinta en cada fotograma.
+ *
+ * El rango Y sale de ChannelStats en tiempo constante y solo cambia cuando los datos se salen
+ * del rango o ocupan menos de la mitad, para que los redibujados completos sean raros.
+ *
+ * El rasterizado lo hace un StripChartRenderer en un hilo del pool asignado con setRenderPool():
+ * en el hilo de la interfaz solo se prepara la entrada del fotograma y se copia la imagen
+ * terminada. Si al llegar el siguiente fotograma el anterior aún no ha terminado, se salta en
+ * lugar de encolarse; los cursores por canal hacen que no se pierda ninguna muestra.
+ *
+ * Con la rueda del ratón (zoom) o arrastrando (desplazamiento) la gráfica deja de seguir los
+ * datos en vivo y pasa a mostrar cualquier tramo de la sesión desde las pirámides de
+ * SessionStore; doble clic vuelve al modo en vivo.
+ *
+ * \see FormPlot, StripChartRenderer, TimeSeriesStore, ChannelStats, MinMaxPyramid
+ * \author Enrique Fuentes
+ * \date 2025-05-31
+ */
+class StripChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StripChart(QWidget *parent = nullptr);
+    ~StripChart();
+
+    // Pool en el que se rasteriza; sin pool se dibuja en el hilo de la interfaz
+    void setRenderPool(QThreadPool *pool) { m_pool = pool; }
+
+    // Trazador de latencia: cada fotograma en vivo se lleva las sondas de sus canales y las cierra al pintarse
+    void setLatencyTracer(LatencyTracer *tracer) { m_tracer = tracer; }
+
+    void setStore(const TimeSeriesStore *store);
+    void setStats(const ChannelStats *stats);
+    void setSession(const SessionStore *session);
+    void setWindowSeconds(double seconds);
+
+    void addChannel(const QString &channelID, const QColor &color, const QString &label);
+    bool hasChannel(const QString &channelID) const;
+
+    // Puntuación 0..100: se muestra en la leyenda y el trazo pasa a discontinuo si es mala
+    void setChannelQuality(const QString &channelID, float score);
+
+    // Borra el trazado y vuelve a leer desde el principio del almacén
+    void reset();
+
+    // Copia el último fotograma terminado y lanza el siguiente; devuelve el instante final en segundos o -1
+    double advance();
+    int skippedFrames() const { return m_skippedFrames; }
+    quint64 pointsDrawn() const { return m_pointsDrawn; }   // vértices dibujados desde que se creó
+
+    // Vista fija de la sesión [t0Us, t1Us] o vuelta al modo en vivo (no emiten señales)
+    void setView(qint64 t0Us, qint64 t1Us);
+    void setLive();
+    bool isLive() const { return m_live; }
+
+    QSize sizeHint() const override { return QSize(400, 80); }
+    QSize minimumSizeHint() const override { return QSize(120, 40); }
+
+signals:
+    // El usuario ha cambiado la vista con el ratón
+    void viewChanged(qint64 t0Us, qint64 t1Us);
+    void liveRequested();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    struct Channel {
+        QString id;
+        QString label;
+        QColor color;
+        float quality = -1.0f;
+        quint64 seenEpoch = 0;     // época del anillo al lanzar el último fotograma
+    };
+
+    bool updateRange();
+    void prepareFrame();
+    void prepareHistory();
+    void historyColumns(const Channel &c, int width, std::vector<MinMaxPyramid::Column> &out) const;
+    void dispatch();
+    void blit();
+    void beginHistory();
+    QPen penFor(const Channel &c) const;
+    QSize deviceSize() const;
+    void layoutRects();
+    void updateAxisLabels();
+
+    const TimeSeriesStore *m_store = nullptr;
+    const ChannelStats *m_stats = nullptr;
+    const SessionStore *m_session = nullptr;
+    std::vector<Channel> m_channels;
+    double m_windowSeconds = 10.0;
+
+    QRect m_plotRect, m_legendRect, m_axisRect;
+    qreal m_dpr = 1.0;
+
+    double m_yMin = -1.0, m_yMax = 1.0;
+    bool m_hasRange = false;
+    bool m_needsFull = true;
+    bool m_resetPending = true;
+    QStringList m_axisLabels;
+
+    // Rasterizado: m_renderer y m_frame solo se tocan aquí mientras m_rendering es false
+    QThreadPool *m_pool = nullptr;
+    StripChartRenderer m_renderer;
+    StripChartRenderer::Frame m_frame;
+    std::atomic<bool> m_rendering {false};
+    bool m_unblitted = false;
+    QImage m_front;              // último fotograma terminado, el que se pinta
+    double m_rightUs = 0.0;      // instante del borde derecho de m_front
+    qint64 m_shownEndUs = -1;
+    int m_skippedFrames = 0;
+    quint64 m_pointsDrawn = 0;
+
+    // Latencia: sondas del fotograma en curso y del ya copiado, pendiente de pintar
+    LatencyTracer *m_tracer = nullptr;
+    std::vector<LatencyTracer::Probe> m_traceFrame;
+    std::vector<LatencyTracer::Probe> m_tracePresent;
+
+    // Vista de la sesión
+    bool m_live = true;
+    qint64 m_viewT0Us = 0;
+    qint64 m_viewT1Us = 0;
+    bool m_dragging = false;
+    int m_dragX = 0;
+    qint64 m_dragT0Us = 0;
+};
+
+#endif // STRIPCHART_H
@@ -0,0 +1,231 @@
+/****************************************************************************
+ * StripChartRenderer.cpp
+ *
+ * Descripción: Rasterizado de una StripChart en un QImage. Se ejecuta en
+ * un hilo del pool de FormPlot y solo lee por su cuenta los anillos del
+ * almacén; el resto de la entrada llega preparada en el Frame.
+ *
+ * Fecha: 2025-06-03
+ ****************************************************************************/
+
+#include "stripchartrenderer.h"
+#include "plotdecimator.h"
+#include <QPainter>
+#include <QPolygonF>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/**
+ * Dibuja un fotograma. Puede llamarse desde cualquier hilo, pero nunca dos a la vez.
+ *
+ * @param frame Entrada preparada en el hilo de la interfaz.
+ */
+void StripChartRenderer::render(const Frame &frame){
+    const QSize size = frame.size.expandedTo(QSize(1, 1));
+    bool full = frame.full || m_torn || m_cursors.size() != frame.traces.size();
+
+    if (m_canvas.size() != size) {
+        m_canvas = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        full = true;
+    }
+    if (frame.reset) {
+        m_cursors.assign(frame.traces.size(), Cursor());
+        m_lastEndUs = -1;
+        full = true;
+    }
+    m_cursors.resize(frame.traces.size());
+    m_yMin = frame.yMin;
+    m_yMax = frame.yMax;
+    m_torn = false;
+    m_points = 0;
+
+    if (!frame.live) {
+        drawHistory(frame);
+        return;
+    }
+
+    if (frame.tEndUs < m_lastEndUs) full = true;          // el tiempo ha vuelto a empezar
+    m_lastEndUs = frame.tEndUs;
+
+    if (!full && frame.tEndUs > m_rightUs) {
+        const int dx = int(std::ceil((frame.tEndUs - m_rightUs) / m_usPerPx));
+        if (dx >= m_canvas.width()) full = true;
+        else scrollBy(dx, frame);
+    }
+
+    if (full) redrawAll(frame);
+    else drawNew(frame);
+}
+
+
+
+// Desplaza el trazado dx píxeles físicos a la izquierda y limpia la franja nueva
+void StripChartRenderer::scrollBy(int dx, const Frame &frame){
+    if (dx <= 0) return;
+    const int w = m_canvas.width();
+    const size_t bpp = size_t(m_canvas.depth() / 8);
+    for (int y = 0; y < m_canvas.height(); ++y) {
+        uchar *line = m_canvas.scanLine(y);
+        std::memmove(line, line + dx * bpp, size_t(w - dx) * bpp);
+    }
+
+    QPainter p(&m_canvas);
+    const int x0 = w - dx;
+    p.fillRect(QRect(x0, 0, dx, m_canvas.height()), frame.background);
+    drawGrid(p, frame, x0, dx);
+    m_rightUs += dx * m_usPerPx;
+}
+
+
+
+// Rehace todo el trazado de la ventana terminada en frame.tEndUs
+void StripChartRenderer::redrawAll(const Frame &frame){
+    const int w = m_canvas.width();
+    m_usPerPx = frame.windowSeconds * 1e6 / std::max(1, w);
+    m_rightUs = double(frame.tEndUs);
+
+    QPainter p(&m_canvas);
+    p.fillRect(m_canvas.rect(), frame.background);
+    drawGrid(p, frame, 0, w);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    const qint64 t0 = qint64(m_rightUs - w * m_usPerPx - m_usPerPx);
+    std::vector<double> xs, ys;
+    QList<QPointF> reduced;
+
+    for (size_t i = 0; i < frame.traces.size(); ++i) {
+        Cursor &c = m_cursors[i];
+        const ChannelRing *ring = m_store ? m_store->find(frame.traces[i].id) : nullptr;
+        c.hasLast = false;
+        if (!ring) { c.epoch = 0; continue; }
+
+        const ChannelRing::Slice slice = ring->range(t0, frame.tEndUs);
+        xs.clear();
+        ys.clear();
+        xs.reserve(slice.size());
+        ys.reserve(slice.size());
+        slice.forEach([&](qint64 t, float v) {
+            const QPointF pt = map(t, v);
+            xs.push_back(pt.x());
+            ys.push_back(pt.y());
+        });
+        if (!ring->isValid(slice)) { m_torn = true; continue; }
+
+        c.epoch = slice.end;
+        if (slice.isEmpty()) continue;
+        c.hasLast = true;
+        c.lastT = slice.timeAt(slice.size() - 1);
+        c.lastV = slice.valueAt(slice.size() - 1);
+
+        // más de 2 puntos por píxel: mínimo y máximo de cada columna
+        PlotDecimator::minMax(xs.data(), ys.data(), int(xs.size()), 0.0, double(w), w, reduced);
+        QPolygonF line;
+        line.reserve(reduced.size());
+        for (const QPointF &pt : std::as_const(reduced)) line << pt;
+        p.setPen(frame.traces[i].pen);
+        p.drawPolyline(line);
+        m_points += int(line.size());
+    }
+}
+
+
+
+// Dibuja las muestras publicadas desde el último fotograma, continuando cada línea
+void StripChartRenderer::drawNew(const Frame &frame){
+    QPainter p(&m_canvas);
+    p.setRenderHint(QPainter::Antialiasing);
+    QPolygonF line;
+
+    for (size_t i = 0; i < frame.traces.size(); ++i) {
+        Cursor &c = m_cursors[i];
+        const ChannelRing *ring = m_store ? m_store->find(frame.traces[i].id) : nullptr;
+        if (!ring || ring->epoch() == c.epoch) continue;
+
+        quint64 cursor = c.epoch;
+        const ChannelRing::Slice slice = ring->since(cursor);
+        line.clear();
+        if (c.hasLast) line << map(c.lastT, c.lastV);
+        slice.forEach([&](qint64 t, float v) { line << map(t, v); });
+        if (!ring->isValid(slice)) { m_torn = true; continue; }
+
+        c.epoch = cursor;
+        if (slice.isEmpty()) continue;
+        c.hasLast = true;
+        c.lastT = slice.timeAt(slice.size() - 1);
+        c.lastV = slice.valueAt(slice.size() - 1);
+
+        p.setPen(frame.traces[i].pen);
+        if (line.size() == 1) p.drawPoint(line.first());
+        else p.drawPolyline(line);
+        m_points += int(line.size());
+    }
+}
+
+
+
+// Dibuja el tramo de la sesión a partir de las columnas ya resumidas por la gráfica
+void StripChartRenderer::drawHistory(const Frame &frame){
+    const int w = m_canvas.width();
+    m_usPerPx = double(frame.viewT1Us - frame.viewT0Us) / std::max(1, w);
+    m_rightUs = double(frame.viewT1Us);
+    for (Cursor &c : m_cursors)
+        c.hasLast = false;
+
+    QPainter p(&m_canvas);
+    p.fillRect(m_canvas.rect(), frame.background);
+    drawGrid(p, frame, 0, w);
+    p.setRenderHint(QPainter::Antialiasing);
+
+    QPolygonF line;
+    const size_t n = std::min(frame.traces.size(), frame.columns.size());
+    for (size_t i = 0; i < n; ++i) {
+        line.clear();
+        const auto &columns = frame.columns[i];
+        for (int x = 0; x < int(columns.size()); ++x) {
+            const MinMaxPyramid::Column &col = columns[x];
+            if (col.count == 0) continue;
+            const double yLo = mapY(col.vMin);
+            const double yHi = mapY(col.vMax);
+            // se entra por el extremo más cercano al punto anterior para no cruzar la columna dos veces
+            if (!line.isEmpty() && std::fabs(line.last().y() - yHi) < std::fabs(line.last().y() - yLo))
+                line << QPointF(x + 0.5, yHi) << QPointF(x + 0.5, yLo);
+            else
+                line << QPointF(x + 0.5, yLo) << QPointF(x + 0.5, yHi);
+        }
+        if (line.isEmpty()) continue;
+        p.setPen(frame.traces[i].pen);
+        p.drawPolyline(line);
+        m_points += int(line.size());
+    }
+}
+
+
+
+// Líneas guía horizontales en las posiciones de las etiquetas, solo en la franja [x0, x0 + width)
+void StripChartRenderer::drawGrid(QPainter &p, const Frame &frame, int x0, int width) const {
+    QPen pen(frame.grid);
+    pen.setWidthF(1.0);
+    p.setPen(pen);
+    const int h = m_canvas.height();
+    for (int y : { 0, h / 2, h - 1 })
+        p.drawLine(x0, y, x0 + width - 1, y);
+}
+
+
+
+// Tiempo/valor → píxel físico de la imagen
+QPointF StripChartRenderer::map(qint64 tUs, float v) const {
+    const double w = m_canvas.width();
+    const double x = w - (m_rightUs - double(tUs)) / m_usPerPx;
+    return QPointF(x, mapY(v));
+}
+
+
+
+// Valor → fila de la imagen
+double StripChartRenderer::mapY(double v) const {
+    const double h = m_canvas.height();
+    const double span = m_yMax - m_yMin;
+    return span > 0.0 ? (h - 1) - (v - m_yMin) / span * (h - 1) : h / 2;
+}
@@ -0,0 +1,118 @@
+/**
+*  file StripChartRenderer.h
+* @author Enrique
+* @date Junio 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef STRIPCHARTRENDERER_H
+#define STRIPCHARTRENDERER_H
+
+#include <QImage>
+#include <QColor>
+#include <QPen>
+#include <QSize>
+#include <QString>
+#include <vector>
+#include "timeseriesstore.h"
+#include "minmaxpyramid.h"
+
+class QPainter;
+
+/*!
+ * \class StripChartRenderer
+ * \brief Rasterizador de una StripChart en un QImage, pensado para ejecutarse fuera del hilo de la interfaz.
+ *
+ * La gráfica prepara en el hilo de la interfaz un Frame con todo lo que no es seguro leer desde
+ * otro hilo (rango Y, trazos, resúmenes de la sesión) y lanza render() en un hilo del pool. El
+ * renderizador solo lee por su cuenta los anillos de TimeSeriesStore, que admiten lectores
+ * concurrentes, y conserva entre fotogramas el trazado y los cursores por canal:
+ * - desplaza la imagen tantos píxeles como haya avanzado el tiempo y dibuja solo las muestras
+ *   nuevas en la franja libre;
+ * - rehace todo el trazado, reducido a mínimo/máximo por columna, cuando el Frame lo pide o
+ *   cuando el escritor ha pisado una lectura;
+ * - en la vista de la sesión dibuja las columnas ya resumidas que trae el Frame.
+ *
+ * Entre que empieza render() y termina, el hilo de la interfaz no toca el renderizador ni el
+ * Frame; después puede leer image() y rightUs().
+ *
+ * \see StripChart
+ * \author Enrique Fuentes
+ * \date 2025-06-03
+ */
+class StripChartRenderer {
+public:
+    struct Trace {
+        QString id;
+        QPen pen;
+    };
+
+    /// Entrada de un fotograma, preparada en el hilo de la interfaz.
+    struct Frame {
+        QSize size;                   // píxeles físicos del área de dibujo
+        QColor background;
+        QColor grid;
+        std::vector<Trace> traces;
+        double yMin = -1.0;
+        double yMax = 1.0;
+        bool full = false;            // rehacer todo el trazado
+        bool reset = false;           // olvidar los cursores y volver a leer desde el principio
+
+        // Modo en vivo
+        bool live = true;
+        qint64 tEndUs = -1;
+        double windowSeconds = 10.0;
+
+        // Vista de la sesión: una columna resumida por píxel y canal
+        qint64 viewT0Us = 0;
+        qint64 viewT1Us = 0;
+        std::vector<std::vector<MinMaxPyramid::Column>> columns;
+    };
+
+    void setStore(const TimeSeriesStore *store) { m_store = store; }
+
+    void render(const Frame &frame);
+
+    const QImage &image() const { return m_canvas; }
+    double rightUs() const { return m_rightUs; }
+    bool wantsFull() const { return m_torn; }
+    int pointsDrawn() const { return m_points; }   // vértices dibujados en el último render()
+
+private:
+    struct Cursor {
+        quint64 epoch = 0;        // época del anillo ya dibujada
+        bool hasLast = false;     // último punto dibujado, para continuar la línea
+        qint64 lastT = 0;
+        float lastV = 0.0f;
+    };
+
+    void scrollBy(int dx, const Frame &frame);
+    void redrawAll(const Frame &frame);
+    void drawNew(const Frame &frame);
+    void drawHistory(const Frame &frame);
+    void drawGrid(QPainter &p, const Frame &frame, int x0, int width) const;
+    QPointF map(qint64 tUs, float v) const;
+    double mapY(double v) const;
+
+    const TimeSeriesStore *m_store = nullptr;
+    QImage m_canvas;
+    std::vector<Cursor> m_cursors;
+    double m_rightUs = 0.0;      // instante del borde derecho de la imagen
+    double m_usPerPx = 1.0;      // µs por píxel físico
+    qint64 m_lastEndUs = -1;
+    double m_yMin = -1.0, m_yMax = 1.0;
+    bool m_torn = false;         // una lectura se ha invalidado: el siguiente fotograma es completo
+    int m_points = 0;
+};
+
+#endif // STRIPCHARTRENDERER_H
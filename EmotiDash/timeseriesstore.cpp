@@ -0,0 +1,287 @@
+/****************************************************************************
+ * TimeSeriesStore.cpp
+ *
+ * Descripción: Almacén de series temporales por canal. Cada canal es un
+ * anillo de capacidad fija con tiempos (qint64, µs) y valores (float) en
+ * vectores separados. Un único escritor publica lotes de muestras y los
+ * lectores las consultan por referencia validando la época.
+ *
+ * Fecha: 2025-05-20
+ ****************************************************************************/
+
+#include "timeseriesstore.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Redondea a la siguiente potencia de dos para poder indexar con máscara
+int nextPowerOfTwo(int n){
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+}
+
+// Constructor: reserva el anillo completo para no reasignar memoria durante la captura
+ChannelRing::ChannelRing(int capacity)
+    : m_capacity(nextPowerOfTwo(std::max(capacity, 2))),
+    m_mask(quint64(m_capacity) - 1),
+    m_t(m_capacity, 0),
+    m_v(m_capacity, 0.0f)
+{
+}
+
+
+
+/**
+ * Añade una muestra al anillo (solo escritor).
+ *
+ * @param tUs Tiempo de la muestra en microsegundos.
+ * @param value Valor de la muestra.
+ */
+void ChannelRing::append(qint64 tUs, float value){
+    append(&tUs, &value, 1);
+}
+
+
+
+/**
+ * Añade un lote de muestras al anillo (solo escritor).
+ * Primero reserva la época final para que los lectores detecten la sobrescritura,
+ * después escribe los datos y por último publica la nueva época.
+ *
+ * @param tUs Tiempos en microsegundos.
+ * @param values Valores de las muestras.
+ * @param n Número de muestras del lote.
+ */
+void ChannelRing::append(const qint64 *tUs, const float *values, int n){
+    if (n <= 0) return;
+
+    const quint64 w = m_written.load(std::memory_order_relaxed);
+    m_reserved.store(w + n, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Si el lote es mayor que el anillo solo sobreviven las últimas muestras
+    const int skip = std::max(0, n - m_capacity);
+    for (int i = skip; i < n; ++i) {
+        const quint64 slot = (w + i) & m_mask;
+        m_t[slot] = tUs[i];
+        m_v[slot] = values[i];
+    }
+
+    m_written.store(w + n, std::memory_order_release);
+}
+
+
+
+/**
+ * Vacía el canal (solo escritor). La época no vuelve a cero: se desplaza el origen
+ * de las muestras válidas, así las porciones antiguas dejan de ser válidas y los
+ * cursores de los lectores se recolocan en la siguiente llamada a since().
+ */
+void ChannelRing::clear(){
+    const quint64 w = m_written.load(std::memory_order_relaxed);
+    m_base.store(w, std::memory_order_release);
+}
+
+
+
+/**
+ * @return Tiempo de la última muestra publicada, o 0 si el canal está vacío.
+ */
+qint64 ChannelRing::lastTime() const {
+    const quint64 w = epoch();
+    if (w <= oldest(w)) return 0;
+    return m_t[(w - 1) & m_mask];
+}
+
+
+
+/**
+ * Devuelve las últimas n muestras publicadas.
+ *
+ * @param n Número de muestras solicitadas (se limita a las disponibles).
+ * @return Porción con las muestras, sin copiar.
+ */
+ChannelRing::Slice ChannelRing::lastN(int n) const {
+    const quint64 w = epoch();
+    const quint64 lo = oldest(w);
+    const quint64 begin = (n <= 0) ? w : std::max(lo, w > quint64(n) ? w - n : 0);
+    return makeSlice(begin, w);
+}
+
+
+
+/**
+ * Devuelve las muestras con tiempo dentro de [t0Us, t1Us].
+ * Se asume que los tiempos son crecientes dentro del canal (búsqueda binaria).
+ *
+ * @param t0Us Inicio del intervalo en microsegundos.
+ * @param t1Us Fin del intervalo en microsegundos (incluido).
+ * @return Porción con las muestras, sin copiar.
+ */
+ChannelRing::Slice ChannelRing::range(qint64 t0Us, qint64 t1Us) const {
+    const quint64 w = epoch();
+    const quint64 lo = oldest(w);
+
+    auto timeAt = [this](quint64 i) { return m_t[i & m_mask]; };
+
+    // primera muestra con t >= t0
+    quint64 a = lo, b = w;
+    while (a < b) {
+        const quint64 mid = a + (b - a) / 2;
+        if (timeAt(mid) < t0Us) a = mid + 1; else b = mid;
+    }
+    const quint64 begin = a;
+
+    // primera muestra con t > t1
+    b = w;
+    while (a < b) {
+        const quint64 mid = a + (b - a) / 2;
+        if (timeAt(mid) <= t1Us) a = mid + 1; else b = mid;
+    }
+    return makeSlice(begin, a);
+}
+
+
+
+/**
+ * Devuelve las muestras publicadas desde la última llamada con el mismo cursor y lo avanza.
+ * Si el lector se ha quedado atrás más de lo que cabe en el anillo (o el canal se ha vaciado),
+ * el cursor salta a la muestra válida más antigua.
+ *
+ * @param cursor Época hasta la que el lector ya ha consumido; se actualiza.
+ * @return Porción con las muestras nuevas, sin copiar.
+ */
+ChannelRing::Slice ChannelRing::since(quint64 &cursor) const {
+    const quint64 w = epoch();
+    const quint64 lo = oldest(w);
+    if (cursor < lo) cursor = lo;
+    if (cursor > w)  cursor = w;
+    Slice s = makeSlice(cursor, w);
+    cursor = w;
+    return s;
+}
+
+
+
+/**
+ * Comprueba, después de haber leído una porción, que el escritor no ha sobrescrito
+ * ninguna de sus muestras mientras tanto.
+ *
+ * @param slice Porción obtenida con lastN(), range() o since().
+ * @return true si los datos leídos son coherentes.
+ */
+bool ChannelRing::isValid(const Slice &slice) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const quint64 reserved = m_reserved.load(std::memory_order_relaxed);
+    const quint64 base = m_base.load(std::memory_order_acquire);
+    return slice.begin >= base && slice.begin + quint64(m_capacity) >= reserved;
+}
+
+
+
+// Construye la porción [begin, end) partida en los dos tramos contiguos del anillo
+ChannelRing::Slice ChannelRing::makeSlice(quint64 begin, quint64 end) const {
+    Slice s;
+    s.begin = begin;
+    s.end = end;
+    if (end <= begin) return s;
+
+    const int n = int(end - begin);
+    const int start = int(begin & m_mask);
+    const int firstN = std::min(n, m_capacity - start);
+
+    s.first  = { m_t.data() + start, m_v.data() + start, firstN };
+    s.second = { m_t.data(), m_v.data(), n - firstN };
+    return s;
+}
+
+
+
+// Primera época válida: la mayor entre el último clear() y lo que cabe en el anillo
+quint64 ChannelRing::oldest(quint64 written) const {
+    const quint64 base = m_base.load(std::memory_order_acquire);
+    const quint64 byCapacity = written > quint64(m_capacity) ? written - m_capacity : 0;
+    return std::max(base, byCapacity);
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      TimeSeriesStore
+// ---------------------------------------------------------------------------
+
+/**
+ * @param retentionSeconds Segundos de historia que debe poder guardar cada canal.
+ */
+TimeSeriesStore::TimeSeriesStore(double retentionSeconds)
+    : m_retentionSeconds(retentionSeconds)
+{
+}
+
+
+
+/**
+ * Devuelve el anillo de un canal, creándolo con capacidad para la retención configurada
+ * a la frecuencia nominal indicada. Solo debe llamarlo el escritor.
+ *
+ * @param channelID Identificador del canal (ej. "AX", "EA").
+ * @param nominalHz Frecuencia nominal del canal; los canales por eventos pueden pasar 1.
+ * @return Puntero estable al anillo del canal.
+ */
+ChannelRing *TimeSeriesStore::channel(const QString &channelID, double nominalHz){
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_channels.constFind(channelID);
+        if (it != m_channels.constEnd())
+            return it.value().get();
+    }
+
+    const int capacity = std::max(64, int(std::ceil(std::max(nominalHz, 1.0) * m_retentionSeconds)));
+    auto ring = std::make_shared<ChannelRing>(capacity);
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_channels.constFind(channelID);
+    if (it != m_channels.constEnd())
+        return it.value().get();
+    m_channels.insert(channelID, ring);
+    return ring.get();
+}
+
+
+
+/**
+ * @param channelID Identificador del canal.
+ * @return Anillo del canal para lectura, o nullptr si todavía no ha llegado ninguna muestra.
+ */
+const ChannelRing *TimeSeriesStore::find(const QString &channelID) const {
+    QReadLocker locker(&m_lock);
+    auto it = m_channels.constFind(channelID);
+    return it != m_channels.constEnd() ? it.value().get() : nullptr;
+}
+
+
+
+/**
+ * @return Lista con los identificadores de todos los canales creados.
+ */
+QStringList TimeSeriesStore::channelIds() const {
+    QReadLocker locker(&m_lock);
+    return m_channels.keys();
+}
+
+
+
+/**
+ * Vacía todos los canales manteniendo los anillos (los punteros de los lectores siguen siendo válidos).
+ */
+void TimeSeriesStore::clear(){
+    QReadLocker locker(&m_lock);
+    for (const auto &ring : std::as_const(m_channels))
+        ring->clear();
+}
@@ -0,0 +1,152 @@
+/**
+*  file TimeSeriesStore.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef TIMESERIESSTORE_H
+#define TIMESERIESSTORE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QReadWriteLock>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// Lote de muestras (tiempos en µs y valores) que se publica de una vez en un canal.
+struct SampleBatch {
+    std::vector<qint64> t;
+    std::vector<float>  v;
+
+    void clear() { t.clear(); v.clear(); }
+    void push(qint64 tUs, float value) { t.push_back(tUs); v.push_back(value); }
+    int size() const { return int(v.size()); }
+    bool isEmpty() const { return v.empty(); }
+};
+
+
+
+/*!
+ * \class ChannelRing
+ * \brief Anillo de capacidad fija con las muestras de un canal (tiempos y valores en SoA).
+ *
+ * Los tiempos se guardan como qint64 en microsegundos y los valores como float, cada uno en su
+ * propio vector contiguo. Hay un único escritor (el controlador) y cualquier número de lectores.
+ *
+ * La sincronización se basa en épocas: la época es el número total de muestras escritas en el
+ * canal y nunca retrocede (clear() solo desplaza el origen de las válidas). El escritor reserva la época final antes de escribir y la publica al terminar,
+ * de modo que un lector puede comprobar con isValid() si las muestras que acaba de leer han sido
+ * sobrescritas mientras las usaba. Los lectores nunca copian: reciben punteros al propio anillo.
+ *
+ * \see TimeSeriesStore
+ */
+class ChannelRing {
+public:
+    /// Tramo contiguo dentro del anillo.
+    struct Span {
+        const qint64 *t = nullptr;
+        const float  *v = nullptr;
+        int n = 0;
+    };
+
+    /// Rango de muestras [begin, end) en índices absolutos, partido en dos tramos por el giro del anillo.
+    struct Slice {
+        Span first, second;
+        quint64 begin = 0;
+        quint64 end = 0;
+
+        int size() const { return first.n + second.n; }
+        bool isEmpty() const { return size() == 0; }
+        qint64 timeAt(int i) const  { return i < first.n ? first.t[i] : second.t[i - first.n]; }
+        float  valueAt(int i) const { return i < first.n ? first.v[i] : second.v[i - first.n]; }
+
+        // Recorre las muestras en orden sin copiarlas: f(qint64 tUs, float v)
+        template <typename F>
+        void forEach(F &&f) const {
+            for (int i = 0; i < first.n; ++i)  f(first.t[i], first.v[i]);
+            for (int i = 0; i < second.n; ++i) f(second.t[i], second.v[i]);
+        }
+    };
+
+    explicit ChannelRing(int capacity);
+
+    int capacity() const { return m_capacity; }
+
+    // Escritor (un único hilo)
+    void append(qint64 tUs, float value);
+    void append(const qint64 *tUs, const float *values, int n);
+    void clear();
+
+    // Lectores
+    quint64 epoch() const { return m_written.load(std::memory_order_acquire); }
+    qint64 lastTime() const;
+    Slice lastN(int n) const;
+    Slice range(qint64 t0Us, qint64 t1Us) const;
+    Slice since(quint64 &cursor) const;
+    bool isValid(const Slice &slice) const;
+
+private:
+    Slice makeSlice(quint64 begin, quint64 end) const;
+    quint64 oldest(quint64 written) const;
+
+    int m_capacity;
+    quint64 m_mask;
+    std::vector<qint64> m_t;
+    std::vector<float>  m_v;
+    std::atomic<quint64> m_written {0};   // época publicada
+    std::atomic<quint64> m_reserved {0};  // época que alcanzará la escritura en curso
+    std::atomic<quint64> m_base {0};      // época del último clear()
+};
+
+
+
+/*!
+ * \class TimeSeriesStore
+ * \brief Almacén único de series temporales por canal compartido por el controlador y la interfaz.
+ *
+ * Sustituye a las copias de muestras repartidas entre paquetes en bruto, señales por muestra y los
+ * buffers de FormPlot. El controlador escribe cada paquete como un lote y los consumidores
+ * (FormPlot, analíticas) leen por referencia con lastN(), range() o since().
+ *
+ * \see ChannelRing, EmotiBitController, FormPlot
+ * \author Enrique Fuentes
+ * \date 2025-05-20
+ */
+class TimeSeriesStore {
+public:
+    explicit TimeSeriesStore(double retentionSeconds = 60.0);
+
+    // Devuelve el anillo del canal, creándolo si no existe (solo escritor)
+    ChannelRing *channel(const QString &channelID, double nominalHz);
+
+    // Acceso de lectura; nullptr si el canal aún no existe
+    const ChannelRing *find(const QString &channelID) const;
+
+    QStringList channelIds() const;
+
+    // Vacía todos los canales (solo escritor); los cursores de los lectores se recolocan solos
+    void clear();
+
+    double retentionSeconds() const { return m_retentionSeconds; }
+
+private:
+    double m_retentionSeconds;
+    mutable QReadWriteLock m_lock;   // protege solo el mapa, no las muestras
+    QHash<QString, std::shared_ptr<ChannelRing>> m_channels;
+};
+
+#endif // TIMESERIESSTORE_H
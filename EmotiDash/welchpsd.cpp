@@ -0,0 +1,151 @@
+/****************************************************************************
+ * WelchPsd.cpp
+ *
+ * Descripción: Estimación incremental de la densidad espectral de potencia
+ * por el método de Welch (segmentos solapados, ventana de Hann y media de
+ * periodogramas reutilizados entre saltos).
+ *
+ * Fecha: 2025-05-28
+ ****************************************************************************/
+
+#include "welchpsd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+}
+
+
+
+/**
+ * @param segmentSize Muestras por segmento (potencia de dos).
+ * @param hop Muestras nuevas entre segmentos (segmentSize/2 = 50 % de solape).
+ * @param averages Número de periodogramas promediados.
+ * @param sampleHz Frecuencia de muestreo.
+ */
+WelchPsd::WelchPsd(int segmentSize, int hop, int averages, double sampleHz)
+    : m_segment(segmentSize),
+    m_hop(std::max(1, hop)),
+    m_averages(std::max(1, averages)),
+    m_sampleHz(sampleHz),
+    m_fft(new RealFft(segmentSize)),
+    m_window(segmentSize),
+    m_ring(segmentSize, 0.0f),
+    m_work(segmentSize),
+    m_power(segmentSize / 2 + 1),
+    m_history(size_t(m_averages) * (segmentSize / 2 + 1), 0.0f),
+    m_sum(segmentSize / 2 + 1, 0.0),
+    m_psd(segmentSize / 2 + 1, 0.0f)
+{
+    double windowPower = 0.0;
+    for (int i = 0; i < m_segment; ++i) {
+        m_window[i] = float(0.5 - 0.5 * std::cos(2.0 * kPi * i / m_segment));
+        windowPower += double(m_window[i]) * m_window[i];
+    }
+    m_scale = 1.0 / (m_sampleHz * windowPower);
+}
+
+
+
+void WelchPsd::reset(){
+    std::fill(m_ring.begin(), m_ring.end(), 0.0f);
+    std::fill(m_sum.begin(), m_sum.end(), 0.0);
+    std::fill(m_psd.begin(), m_psd.end(), 0.0f);
+    m_writePos = m_filled = m_sinceLast = 0;
+    m_historyPos = m_count = 0;
+}
+
+
+
+/**
+ * Añade muestras y calcula un segmento cada hop muestras una vez lleno el anillo.
+ *
+ * @param values Muestras.
+ * @param n Número de muestras.
+ * @return Segmentos nuevos calculados.
+ */
+int WelchPsd::push(const float *values, int n){
+    int computed = 0;
+    for (int i = 0; i < n; ++i) {
+        m_ring[m_writePos] = values[i];
+        m_writePos = (m_writePos + 1) % m_segment;
+        if (m_filled < m_segment) ++m_filled;
+        if (m_filled == m_segment && ++m_sinceLast >= m_hop) {
+            m_sinceLast = 0;
+            computeSegment();
+            ++computed;
+        }
+    }
+    return computed;
+}
+
+
+
+// Periodograma del segmento actual y actualización de la media
+void WelchPsd::computeSegment(){
+    // Segmento en orden temporal y sin componente continua
+    double mean = 0.0;
+    for (int i = 0; i < m_segment; ++i) mean += m_ring[i];
+    mean /= m_segment;
+    const int head = m_segment - m_writePos;
+    for (int i = 0; i < head; ++i)
+        m_work[i] = float(m_ring[m_writePos + i] - mean) * m_window[i];
+    for (int i = 0; i < m_writePos; ++i)
+        m_work[head + i] = float(m_ring[i] - mean) * m_window[head + i];
+
+    m_fft->power(m_work.data(), m_power.data());
+
+    // Unilateral: se duplican todos los bins salvo continua y Nyquist
+    const int nb = bins();
+    for (int k = 0; k < nb; ++k) {
+        const double factor = (k == 0 || k == nb - 1) ? 1.0 : 2.0;
+        m_power[k] = float(m_power[k] * m_scale * factor);
+    }
+
+    // El periodograma que sale de la media se resta y el nuevo ocupa su lugar
+    float *slot = m_history.data() + size_t(m_historyPos) * nb;
+    const bool replacing = m_count == m_averages;
+    for (int k = 0; k < nb; ++k) {
+        if (replacing) m_sum[k] -= slot[k];
+        m_sum[k] += m_power[k];
+        slot[k] = m_power[k];
+    }
+    m_historyPos = (m_historyPos + 1) % m_averages;
+    if (!replacing) ++m_count;
+
+    for (int k = 0; k < nb; ++k)
+        m_psd[k] = float(std::max(0.0, m_sum[k]) / m_count);
+}
+
+
+
+/**
+ * @param f0 Frecuencia inicial en Hz.
+ * @param f1 Frecuencia final en Hz (excluida).
+ * @return Potencia en la banda (unidades²).
+ */
+double WelchPsd::bandPower(double f0, double f1) const {
+    if (!isReady()) return 0.0;
+    const double df = binHz();
+    double sum = 0.0;
+    for (int k = std::max(0, int(std::ceil(f0 / df))); k < bins() && k * df < f1; ++k)
+        sum += m_psd[k];
+    return sum * df;
+}
+
+
+
+/**
+ * @param f0 Frecuencia inicial en Hz.
+ * @param f1 Frecuencia final en Hz (excluida).
+ * @return Frecuencia del bin de mayor potencia, o 0 si aún no hay PSD.
+ */
+double WelchPsd::peakFrequency(double f0, double f1) const {
+    if (!isReady()) return 0.0;
+    const double df = binHz();
+    int best = -1;
+    for (int k = std::max(1, int(std::ceil(f0 / df))); k < bins() && k * df < f1; ++k)
+        if (best < 0 || m_psd[k] > m_psd[best]) best = k;
+    return best < 0 ? 0.0 : best * df;
+}
@@ -0,0 +1,89 @@
+/**
+*  file WelchPsd.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef WELCHPSD_H
+#define WELCHPSD_H
+
+#include <memory>
+#include <vector>
+#include "realfft.h"
+
+/*!
+ * \class WelchPsd
+ * \brief Densidad espectral de potencia por el método de Welch, calculada en streaming.
+ *
+ * Las muestras entran en un anillo del tamaño del segmento. Cada hop muestras nuevas se toma el
+ * segmento más reciente, se le resta la media, se aplica una ventana de Hann y se calcula su
+ * periodograma con RealFft. Cada periodograma se calcula una sola vez y se guarda: la PSD es la
+ * media de los últimos `averages` periodogramas, mantenida con una suma corriente a la que se
+ * añade el nuevo y se resta el que sale. El coste por muestra es el de una FFT cada hop muestras.
+ *
+ * La PSD es unilateral, en unidades²/Hz.
+ *
+ * \see RealFft, HrvSpectrum
+ * \author Enrique Fuentes
+ * \date 2025-05-28
+ */
+class WelchPsd {
+public:
+    WelchPsd(int segmentSize, int hop, int averages, double sampleHz);
+
+    // Añade muestras; devuelve el número de segmentos nuevos calculados
+    int push(const float *values, int n);
+    void reset();
+
+    bool isReady() const { return m_count > 0; }
+    int segmentSize() const { return m_segment; }
+    int bins() const { return m_segment / 2 + 1; }
+    double binHz() const { return m_sampleHz / m_segment; }
+    double sampleHz() const { return m_sampleHz; }
+
+    // PSD promediada (bins() valores)
+    const std::vector<float> &psd() const { return m_psd; }
+
+    // Potencia integrada en [f0, f1) Hz
+    double bandPower(double f0, double f1) const;
+
+    // Frecuencia del máximo de la PSD dentro de [f0, f1) Hz
+    double peakFrequency(double f0, double f1) const;
+
+private:
+    void computeSegment();
+
+    int m_segment;
+    int m_hop;
+    int m_averages;
+    double m_sampleHz;
+    double m_scale;                     // 1 / (fs · Σw²)
+
+    std::unique_ptr<RealFft> m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_ring;          // últimas m_segment muestras
+    int m_writePos = 0;
+    int m_filled = 0;
+    int m_sinceLast = 0;
+
+    std::vector<float> m_work;
+    std::vector<float> m_power;
+    std::vector<float> m_history;       // m_averages periodogramas seguidos
+    int m_historyPos = 0;
+    int m_count = 0;                    // periodogramas válidos en el historial
+    std::vector<double> m_sum;
+    std::vector<float> m_psd;
+};
+
+#endif // WELCHPSD_H
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * WindowedStats.cpp
+ *
+ * Descripción: Estadísticas de ventana deslizante por canal (mínimo, máximo,
+ * media y desviación típica) con coste constante por muestra.
+ *
+ * Fecha: 2025-05-30
+ ****************************************************************************/
+
+#include "windowedstats.h"
+#include <algorithm>
+#include <cmath>
+
+WindowedStats::WindowedStats(double windowSeconds)
+    : m_windowUs(qint64(std::max(0.001, windowSeconds) * 1e6))
+{
+}
+
+
+
+/**
+ * Cambia la longitud de la ventana. Si se acorta, las muestras sobrantes salen en la
+ * siguiente llamada a add().
+ */
+void WindowedStats::setWindowSeconds(double seconds){
+    m_windowUs = qint64(std::max(0.001, seconds) * 1e6);
+}
+
+
+
+void WindowedStats::add(const qint64 *tUs, const float *values, int n){
+    for (int i = 0; i < n; ++i)
+        add(tUs[i], values[i]);
+}
+
+
+
+void WindowedStats::add(qint64 tUs, float value){
+    if (std::isnan(value)) return;
+    // El jitter de las marcas puede adelantar la primera muestra de un paquete a la última del
+    // anterior: se toma con el último tiempo (un reinicio de sesión pasa por ChannelStats::clear())
+    if (!m_t.empty() && tUs < m_lastT) tUs = m_lastT;
+
+    expire(tUs);
+
+    m_t.push_back(tUs);
+    m_v.push_back(value);
+    m_lastT = tUs;
+
+    while (!m_min.empty() && m_min.back().second >= value) m_min.pop_back();
+    m_min.emplace_back(tUs, value);
+    while (!m_max.empty() && m_max.back().second <= value) m_max.pop_back();
+    m_max.emplace_back(tUs, value);
+
+    // Welford: entrada
+    const double delta = value - m_mean;
+    m_mean += delta / double(m_t.size());
+    m_m2 += delta * (value - m_mean);
+}
+
+
+
+void WindowedStats::reset(){
+    m_t.clear();
+    m_v.clear();
+    m_min.clear();
+    m_max.clear();
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_removed = 0;
+    m_lastT = 0;
+}
+
+
+
+double WindowedStats::variance() const {
+    return m_t.size() > 1 ? std::max(0.0, m_m2 / double(m_t.size() - 1)) : 0.0;
+}
+
+
+
+double WindowedStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+
+
+// Saca de la ventana las muestras anteriores a newestUs − ventana
+void WindowedStats::expire(qint64 newestUs){
+    const qint64 limit = newestUs - m_windowUs;
+    bool removed = false;
+
+    while (!m_t.empty() && m_t.front() < limit) {
+        const double x = m_v.front();
+        m_t.pop_front();
+        m_v.pop_front();
+        removed = true;
+        ++m_removed;
+
+        // Welford: salida
+        const size_t n = m_t.size();
+        if (n == 0) {
+            m_mean = 0.0;
+            m_m2 = 0.0;
+        } else {
+            const double oldMean = m_mean;
+            m_mean -= (x - m_mean) / double(n);
+            m_m2 -= (x - oldMean) * (x - m_mean);
+        }
+    }
+
+    while (!m_min.empty() && m_min.front().first < limit) m_min.pop_front();
+    while (!m_max.empty() && m_max.front().first < limit) m_max.pop_front();
+
+    if (removed && m_removed >= rebuildInterval)
+        rebuild();
+}
+
+
+
+// Recalcula media y M2 desde cero (O(ventana) cada rebuildInterval salidas: O(1) amortizado)
+void WindowedStats::rebuild(){
+    m_removed = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    double n = 0.0;
+    for (float x : m_v) {
+        n += 1.0;
+        const double delta = x - m_mean;
+        m_mean += delta / n;
+        m_m2 += delta * (x - m_mean);
+    }
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      ChannelStats
+// ---------------------------------------------------------------------------
+
+void ChannelStats::setWindowSeconds(double seconds){
+    m_windowSeconds = seconds;
+    for (WindowedStats &stats : m_channels)
+        stats.setWindowSeconds(seconds);
+}
+
+
+
+void ChannelStats::add(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    if (n <= 0) return;
+    auto it = m_channels.find(channelID);
+    if (it == m_channels.end())
+        it = m_channels.insert(channelID, WindowedStats(m_windowSeconds));
+    it.value().add(tUs, values, n);
+}
+
+
+
+const WindowedStats *ChannelStats::find(const QString &channelID) const {
+    auto it = m_channels.constFind(channelID);
+    return it != m_channels.constEnd() ? &it.value() : nullptr;
+}
@@ -0,0 +1,117 @@
+/**
+*  file WindowedStats.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef WINDOWEDSTATS_H
+#define WINDOWEDSTATS_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <deque>
+#include <utility>
+
+/*!
+ * \class WindowedStats
+ * \brief Mínimo, máximo, media y desviación típica de los últimos N segundos de un canal.
+ *
+ * Cada muestra cuesta O(1) amortizado, sea cual sea la longitud de la ventana:
+ * - mínimo y máximo con colas monótonas (cada muestra entra y sale una sola vez);
+ * - media y varianza con actualizaciones de Welford al entrar y al salir cada muestra. Para
+ *   acotar el error acumulado, la suma se recalcula desde cero cada rebuildInterval salidas.
+ *
+ * La consulta es inmediata: la interfaz puede autoescalar o mostrar lecturas en vivo sin
+ * recorrer las muestras.
+ *
+ * \see ChannelStats
+ * \author Enrique Fuentes
+ * \date 2025-05-30
+ */
+class WindowedStats {
+public:
+    explicit WindowedStats(double windowSeconds = 10.0);
+
+    void setWindowSeconds(double seconds);
+    double windowSeconds() const { return m_windowUs / 1e6; }
+
+    // Añade muestras con tiempos crecientes (µs); las NaN se ignoran y las que llegan antes
+    // de la última se cuentan con el tiempo de esta
+    void add(qint64 tUs, float value);
+    void add(const qint64 *tUs, const float *values, int n);
+    void reset();
+
+    bool isEmpty() const { return m_t.empty(); }
+    int count() const { return int(m_t.size()); }
+    qint64 lastTime() const { return m_lastT; }
+
+    float min() const { return m_min.empty() ? 0.0f : m_min.front().second; }
+    float max() const { return m_max.empty() ? 0.0f : m_max.front().second; }
+    double mean() const { return m_mean; }
+    double variance() const;
+    double stddev() const;
+
+private:
+    void expire(qint64 newestUs);
+    void rebuild();
+
+    static constexpr int rebuildInterval = 4096;
+
+    qint64 m_windowUs;
+    qint64 m_lastT = 0;
+
+    std::deque<qint64> m_t;                       // muestras de la ventana (SoA)
+    std::deque<float>  m_v;
+    std::deque<std::pair<qint64, float>> m_min;   // valores crecientes: el frente es el mínimo
+    std::deque<std::pair<qint64, float>> m_max;   // valores decrecientes: el frente es el máximo
+
+    double m_mean = 0.0;
+    double m_m2 = 0.0;      // suma de cuadrados de las desviaciones
+    int m_removed = 0;
+};
+
+
+
+/*!
+ * \class ChannelStats
+ * \brief Estadísticas de ventana de todos los canales, compartidas por todos los consumidores.
+ *
+ * El controlador las actualiza con cada lote que publica; FormPlot las usa para autoescalar
+ * el eje Y y cualquier otra vista puede leerlas sin volver a recorrer las muestras. Se
+ * actualizan y se leen en el hilo del controlador (el de la interfaz).
+ *
+ * \see WindowedStats, EmotiBitController, FormPlot
+ */
+class ChannelStats {
+public:
+    explicit ChannelStats(double windowSeconds = 10.0) : m_windowSeconds(windowSeconds) {}
+
+    void setWindowSeconds(double seconds);
+    double windowSeconds() const { return m_windowSeconds; }
+
+    void add(const QString &channelID, const qint64 *tUs, const float *values, int n);
+    void clear() { m_channels.clear(); }
+
+    // nullptr si el canal aún no tiene muestras
+    const WindowedStats *find(const QString &channelID) const;
+    QStringList channelIds() const { return m_channels.keys(); }
+
+private:
+    double m_windowSeconds;
+    QHash<QString, WindowedStats> m_channels;
+};
+
+#endif // WINDOWEDSTATS_H
@@ -9,17 +9,33 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    csvpacketsource.cpp \
     emotibitemulator.cpp \
+    emotibitfleet.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    mappedcsvpacketsource.cpp \
+    replayengine.cpp \
+    replaystream.cpp \
+    syntheticpacketsource.cpp
 
 HEADERS += \
+    csvpacketsource.h \
     emotibitemulator.h \
-    mainwindow.h
+    emotibitfleet.h \
+    mainwindow.h \
+    mappedcsvpacketsource.h \
+    packetsource.h \
+    replayengine.h \
+    replaystream.h \
+    syntheticpacketsource.h
 
 FORMS += \
     mainwindow.ui
 
+# Resolución de 1 ms del temporizador del sistema para la reproducción (timeBeginPeriod)
+win32: LIBS += -lwinmm
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
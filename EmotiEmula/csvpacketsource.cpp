@@ -0,0 +1,89 @@
+#include "csvpacketsource.h"
+#include <QFileInfo>
+
+CsvPacketSource::CsvPacketSource(const QString &filePath)
+    : m_file(filePath)
+{
+}
+
+
+
+bool CsvPacketSource::open(QString *error)
+{
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("No se puede abrir %1: %2").arg(m_file.fileName(), m_file.errorString());
+        return false;
+    }
+
+    // La marca del primer paquete fija el origen de la reproducción
+    m_first = -1;
+    rewind();
+    ReplayPacket packet;
+    if (next(packet)) m_first = packet.deviceMs;
+    rewind();
+
+    if (m_first < 0) {
+        if (error) *error = QString("%1 no contiene paquetes").arg(m_file.fileName());
+        return false;
+    }
+    return true;
+}
+
+
+
+void CsvPacketSource::close()
+{
+    m_file.close();
+    m_first = -1;
+}
+
+
+
+void CsvPacketSource::rewind()
+{
+    if (m_file.isOpen()) m_file.seek(0);
+}
+
+
+
+bool CsvPacketSource::next(ReplayPacket &packet)
+{
+    while (m_file.isOpen() && !m_file.atEnd()) {
+        m_line = m_file.readLine();
+        int size = int(m_line.size());
+        while (size > 0 && (m_line[size - 1] == '\n' || m_line[size - 1] == '\r')) --size;
+        if (parseLine(m_line.constData(), size, packet)) return true;
+    }
+    return false;
+}
+
+
+
+QString CsvPacketSource::describe() const
+{
+    return QString("%1 (%2 bytes)").arg(QFileInfo(m_file.fileName()).fileName()).arg(m_file.size());
+}
+
+
+
+/**
+ * @param line Línea sin fin de línea.
+ * @param size Longitud de la línea.
+ * @param packet Recibe la marca de tiempo y el resto de la línea.
+ * @return true si la línea empieza por una marca de tiempo seguida de más campos.
+ */
+bool CsvPacketSource::parseLine(const char *line, int size, ReplayPacket &packet)
+{
+    qint64 ts = 0;
+    int i = 0;
+    while (i < size && line[i] >= '0' && line[i] <= '9') {
+        ts = ts * 10 + (line[i] - '0');
+        ++i;
+    }
+    if (i == 0 || i >= size || line[i] != ',') return false;
+
+    packet.deviceMs = ts;
+    packet.rest = line + i;
+    packet.restSize = size - i;
+    return true;
+}
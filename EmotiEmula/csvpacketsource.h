@@ -0,0 +1,36 @@
+#ifndef CSVPACKETSOURCE_H
+#define CSVPACKETSOURCE_H
+
+#include <QFile>
+#include <QByteArray>
+#include "packetsource.h"
+
+/**
+ * @class CsvPacketSource
+ * @brief Lee paquetes de un archivo CSV de EmotiBit línea a línea.
+ *
+ * Cada línea válida es un paquete completo (timestamp,packetNumber,dataLength,typeTag,...).
+ * Las líneas vacías, las cabeceras y las que no empiezan por un número se saltan.
+ */
+class CsvPacketSource : public PacketSource
+{
+public:
+    explicit CsvPacketSource(const QString &filePath);
+
+    bool open(QString *error = nullptr) override;
+    void close() override;
+    void rewind() override;
+    bool next(ReplayPacket &packet) override;
+    qint64 firstTimestamp() const override { return m_first; }
+    QString describe() const override;
+
+    // Separa la marca de tiempo del resto de la línea; false si la línea no es un paquete
+    static bool parseLine(const char *line, int size, ReplayPacket &packet);
+
+private:
+    QFile m_file;
+    QByteArray m_line;
+    qint64 m_first = -1;
+};
+
+#endif // CSVPACKETSOURCE_H
@@ -1,17 +1,36 @@
 #include "EmotiBitEmulator.h"
+#include "csvpacketsource.h"
+#include "syntheticpacketsource.h"
+#include "mappedcsvpacketsource.h"
 #include <QDateTime>
+#include <QTimer>
 #include <QNetworkInterface>
 #include <QHostAddress>
 #include <QDebug>
+#include <algorithm>
 
 EmotiBitEmulator::EmotiBitEmulator(QObject *parent) :
+    EmotiBitEmulator(Options(), parent)
+{
+}
+
+
+
+EmotiBitEmulator::EmotiBitEmulator(const Options &options, QObject *parent) :
     QObject(parent),
     advertisingSocket(new QUdpSocket(this)),
     dataSocket(new QUdpSocket(this)),
     controlClientSocket(nullptr),
-    dataTimer(new QTimer(this)),
+    replay(options.engine ? options.engine : new ReplayEngine(this)),
+    ownsEngine(!options.engine),
+    counters(std::make_shared<ReplayCounters>()),
+    csvFilePath(options.csvFile),
+    synthetic(options.synthetic),
+    seed(options.seed),
     isConnected(false),
-    deviceId("Simulador_EmotiBit"),
+    listening(false),
+    deviceId(options.deviceId),
+    localAddress(options.address),
     advertisingPort(3131),
     dataPort(0),    // Se establecerá luego del EMOTIBIT_CONNECT
     controlPort(0), // Se establecerá luego del EMOTIBIT_CONNECT
@@ -22,11 +41,27 @@ EmotiBitEmulator::EmotiBitEmulator(QObject *parent) :
         emit messageLogged("Error al configurar los puertos de advertising. Emulador no iniciado.");   //pong Añadido asegur stard
         return;
     }
+    listening = true;
 
     // Conectar señales
     connect(advertisingSocket, &QUdpSocket::readyRead, this, &EmotiBitEmulator::readAdvertisingMessage);
-    if(!csvFile.isOpen()) csvFile.open(QIODevice::ReadOnly | QIODevice::Text);
-    connect(dataTimer, &QTimer::timeout, this, &EmotiBitEmulator::sendData);
+    connect(replay, &ReplayEngine::streamFinished, this, [this](int id) {
+        if (id != streamId) return;
+        streamId = -1;
+        emit messageLogged(QString("Transmisión de datos completada (%1 paquetes).").arg(counters->packets.load()));
+        qDebug() << "Transmisión de datos completada.";
+    });
+    connect(replay, &ReplayEngine::looped, this, [this](int id, int count) {
+        if (id != streamId) return;
+        emit messageLogged(QString("Reproducción: vuelta %1 (%2 paquetes enviados).").arg(count + 1).arg(counters->packets.load()));
+    });
+    // Con motor compartido los errores y el ritmo de envío los muestra la flota una sola vez
+    if (ownsEngine) {
+        connect(replay, &ReplayEngine::sendError, this, &EmotiBitEmulator::messageLogged);
+        auto *statsTimer = new QTimer(this);
+        connect(statsTimer, &QTimer::timeout, this, &EmotiBitEmulator::logReplayStats);
+        statsTimer->start(kStatsIntervalMs);
+    }
 }
 
 
@@ -34,17 +69,9 @@ EmotiBitEmulator::EmotiBitEmulator(QObject *parent) :
 
 EmotiBitEmulator::~EmotiBitEmulator()
 {
-    // Detener el temporizador si está activo
-    if (dataTimer->isActive()) {
-        dataTimer->stop();
-    }
-
-    // Cerrar el archivo CSV si está abierto
-    if (csvFile.isOpen()) {
-        csvFile.close();
-        qDebug() << "Archivo CSV cerrado en el destructor.";
-        emit messageLogged("Archivo CSV cerrado en el destructor.");
-    }
+    // Detener la reproducción (con motor propio, espera a que termine su hilo)
+    if (ownsEngine) replay->stop();
+    else stopReplay();
 
     // Desconectar y destruir el socket de control si está activo
     if (controlClientSocket) {
@@ -79,71 +106,106 @@ EmotiBitEmulator::~EmotiBitEmulator()
 
 bool EmotiBitEmulator::setupAdvertisingSocket()
 {
-    if (!advertisingSocket->bind(advertisingPort, QUdpSocket::ShareAddress)) {
-        emit messageLogged(QString("Error al vincular el socket de advertising al puerto %1: %2")
+    if (!advertisingSocket->bind(localAddress, advertisingPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        emit messageLogged(QString("Error al vincular el socket de advertising a %1:%2: %3")
+                               .arg(localAddress.toString())
                                .arg(advertisingPort)
                                .arg(advertisingSocket->errorString()));
         return false;
     }
-    emit messageLogged(QString("Socket de advertising vinculado al puerto %1").arg(advertisingPort));
+    emit messageLogged(QString("Socket de advertising vinculado a %1:%2").arg(localAddress.toString()).arg(advertisingPort));
     return true;
 }
 
 void EmotiBitEmulator::setCsvFile(const QString &filePath)
 {
-    csvFile.setFileName(filePath);
+    csvFilePath = filePath;
 }
 
 void EmotiBitEmulator::startEmulation(){
+    // Iniciar el temporizador para medir el tiempo transcurrido
+    elapsedTimer.start();
+    emit messageLogged("_________________________Emulación iniciada.");
+    qDebug() << "_________________________Emulación iniciada.";
+    startReplay();
+}
 
-        if (!csvFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            emit messageLogged("Error al abrir el archivo CSV.");
-            qDebug() << "Error al abrir el archivo CSV.";
-            return;
-        }
-        csvStream.setDevice(&csvFile);
-        emit messageLogged("_________________________Emulación iniciada.");
-        qDebug() << "_________________________Emulación iniciada.";
-
-        // Iniciar el temporizador para medir el tiempo transcurrido
-        elapsedTimer.start();
-
-        // Log tamaño del archivo
-        qDebug() << "CSV file opened. Size:" << csvFile.size();
-        emit messageLogged(QString("CSV file opened. Size: %1 bytes").arg(csvFile.size()));
-
-        // Leer y loguear las primeras líneas para verificar contenido
-        if (csvFile.size() > 0) {
-            for(int i = 0; i < 5; ++i) { // Leer las primeras 5 líneas
-                QString line = csvStream.readLine();
-                if (line.isNull()) break;
-                qDebug() << "Line " << i+1 << ": " << line;
-                emit messageLogged(QString("Line %1: %2").arg(i+1).arg(line));
-            }
-            // Resetear el puntero de lectura al inicio
-            csvStream.seek(0);
-            qDebug() << "csvStream position after seek: " << csvStream.pos();
+
+
+/**
+ * Abre el CSV (o la señal sintética) y entrega el flujo al motor de reproducción, hacia el
+ * puerto de datos del host. Solo se inicia cuando hay conexión de control y origen de datos;
+ * si ya está en marcha no hace nada.
+ */
+void EmotiBitEmulator::startReplay()
+{
+    if (!isConnected || streamId >= 0 || (csvFilePath.isEmpty() && !synthetic)) return;
+    if (senderAddress.isNull() || dataPort <= 0) {
+        emit messageLogged("Error al enviar datos: senderAddress o dataPort no válidos.");
+        return;
+    }
+
+    // El CSV se proyecta en memoria e indexa una vez; si no se puede, se lee línea a línea
+    std::unique_ptr<PacketSource> source;
+    QString error;
+    if (synthetic) {
+        source = std::make_unique<SyntheticPacketSource>(seed);
+    } else {
+        source = std::make_unique<MappedCsvPacketSource>(csvFilePath);
+        if (!source->open(&error)) {
+            emit messageLogged(error + "; se lee línea a línea.");
+            source = std::make_unique<CsvPacketSource>(csvFilePath);
         }
     }
+    if (!source->open(&error)) {
+        emit messageLogged("Error al abrir el archivo CSV: " + error);
+        qDebug() << "Error al abrir el archivo CSV:" << error;
+        return;
+    }
+    emit messageLogged("Origen de datos: " + source->describe());
+
+    auto stream = std::make_unique<ReplayStream>(deviceId, std::move(source));
+    stream->setDestination(senderAddress, dataPort);
+    stream->setLocal(localAddress, dataPort);   // el host aprende la IP y el puerto de datos del remitente
+    stream->setTimestampBase(QDateTime::currentMSecsSinceEpoch() - localTimestampOffset);
+    stream->setPacking(replayPacking);
+    counters = std::make_shared<ReplayCounters>();
+    lastStatsPackets = 0;
+    lastStatsDatagrams = 0;
+    statsClock.start();
+    stream->setCounters(counters);
+    streamId = replay->addStream(std::move(stream));
+
+    emit messageLogged(QString("Reproducción a velocidad %1, %2")
+                           .arg(replay->speed() > 0.0 ? QString::number(replay->speed()) + "x" : QString("máxima"))
+                           .arg(replayPacking.intervalMs > 0
+                                    ? QString("datagramas de hasta %1 bytes cada %2 ms, enviados %3 veces")
+                                          .arg(replayPacking.maxDatagramBytes).arg(replayPacking.intervalMs).arg(replayPacking.copies)
+                                    : QString("un paquete por datagrama")));
+}
+
+
+
+void EmotiBitEmulator::stopReplay()
+{
+    if (streamId < 0) return;
+    replay->removeStream(streamId);
+    streamId = -1;
+}
 
 
 
 void EmotiBitEmulator::stopEmulation()
 {
-    dataTimer->stop();
-    //if (csvFile.isOpen()) {
-    //    csvFile.close();
-    //}
-    emit messageLogged("_________________________Emulación detenida.");
+    stopReplay();
+    emit messageLogged(QString("_________________________Emulación detenida (%1 paquetes en %2 datagramas).")
+                           .arg(counters->packets.load()).arg(counters->datagrams.load()));
     qDebug() << "_________________________Emulación detenida.";
 }
 
 void EmotiBitEmulator::readAdvertisingMessage()
 {
-    qDebug() << "readAdvertisingMessage()";
-
     while (advertisingSocket->hasPendingDatagrams()) {
-        qDebug() << "Hay paquetes de publicidad pendientes de lectura";
         QByteArray datagram;
         datagram.resize(int(advertisingSocket->pendingDatagramSize()));
         QHostAddress sender;
@@ -152,30 +214,25 @@ void EmotiBitEmulator::readAdvertisingMessage()
         advertisingSocket->readDatagram(datagram.data(), datagram.size(), &sender, &port);
 
         QString message = QString::fromUtf8(datagram);
-        emit messageLogged("Recibido: " + message);
-        qDebug() << "Recibido: " << message;
-
         QStringList packetFields = message.split(',');
         if (packetFields.size() < 4) {
+            emit messageLogged("Recibido: " + message);
             emit messageLogged("Formato del mensaje no válido.");
             qDebug() << "Formato del mensaje no válido.";
             continue;
         }
 
+        // Los PING llegan cada segundo: se cuentan y solo se registra una muestra
         QString typeTag = packetFields.at(3);
-        emit messageLogged("Tipo de mensaje recibido: " + typeTag);
-        qDebug() << "Tipo de mensaje recibido: " << typeTag;
+        if (typeTag != "PN") {
+            emit messageLogged("Recibido: " + message);
+            qDebug() << "Recibido: " << message;
+            emit messageLogged("Tipo de mensaje recibido: " + typeTag);
+            qDebug() << "Tipo de mensaje recibido: " << typeTag;
+        }
 
         if (typeTag == "HE") { // HELLO_EMOTIBIT
-            senderAddress = sender;
-            senderPort = port;
-
-            sendHelloHostMessage(senderAddress, senderPort);
-
-            hostIp = senderAddress;
-            hostAddress = senderAddress;
-
-            // No enviar PONG aún. Esperaremos a recibir EMOTIBIT_CONNECT (EC)
+            answerHello(sender, port);
 
         } else if (typeTag == "EC") { // EMOTIBIT_CONNECT
             emit messageLogged("EMOTIBIT_CONNECT entrando");
@@ -203,7 +260,7 @@ void EmotiBitEmulator::readAdvertisingMessage()
                     // Establecer el archvo CSV después de conectar
                     //setCsvFile("D://emuladorEmotiBit8//2024-11-10_13-18-28-299019.csv");
 
-                    setCsvFile("muestras.csv");
+                    if (csvFilePath.isEmpty() && !synthetic) setCsvFile("muestras.csv");
 
                     // Iniciar la emulación
                     startEmulation();
@@ -217,8 +274,10 @@ void EmotiBitEmulator::readAdvertisingMessage()
             }
 
         } else if (typeTag == "PN") { // PING
-            emit messageLogged("Recibido PING (PN).");
-            qDebug() << "Recibido PING (PN).";
+            if (sampled(++pingsReceived)) {
+                emit messageLogged(QString("Recibido PING (PN) nº %1 (se registra 1 de cada %2).").arg(pingsReceived).arg(kLogEvery));
+                qDebug() << "Recibido PING (PN) nº" << pingsReceived;
+            }
             // Enviar PONG en respuesta
             sendPongMessage();
         } else {
@@ -262,8 +321,8 @@ void EmotiBitEmulator::connectHost(quint16 controlPort, quint16 dataPort)
         // Enviar PONG después de establecer la conexión
         sendPongMessage();
 
-        // Iniciar el envío de datos
-        dataTimer->start(5);     //________________________________________________________________________________________
+        // Iniciar el envío de datos (si el CSV ya está elegido)
+        startReplay();
     });
 
     connect(controlClientSocket, &QTcpSocket::readyRead, this, [this]() {
@@ -278,10 +337,12 @@ void EmotiBitEmulator::connectHost(quint16 controlPort, quint16 dataPort)
         emit messageLogged("Conexión de control cerrada por el Oscilloscope.");
         qDebug() << "Conexión de control cerrada por el Oscilloscope.";
         isConnected = false;
-        dataTimer->stop();
+        stopReplay();
     });
 
-    // Conectar al puerto de control usando TCP
+    // Conectar al puerto de control usando TCP (desde el alias del dispositivo, si lo tiene)
+    if (localAddress != QHostAddress::Any && localAddress != QHostAddress::AnyIPv4)
+        controlClientSocket->bind(localAddress);
     controlClientSocket->connectToHost(senderAddress, controlPort);
     qDebug() << "Intentando conectar al puerto de control:" << controlPort;
 
@@ -296,7 +357,7 @@ void EmotiBitEmulator::connectHost(quint16 controlPort, quint16 dataPort)
 
 
     // Configurar el socket de datos para escuchar en el puerto especificado
-    if (!dataSocket->bind(dataPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+    if (!dataSocket->bind(localAddress, dataPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
         emit messageLogged(QString("Error al vincular el socket de datos al puerto %1: %2")
                                .arg(dataPort)
                                .arg(dataSocket->errorString()));
@@ -340,6 +401,22 @@ QString EmotiBitEmulator::formatPacket(const QString &payload)
 
 
 
+void EmotiBitEmulator::answerHello(const QHostAddress &sender, quint16 port)
+{
+    senderAddress = sender;
+    senderPort = port;
+
+    sendHelloHostMessage(senderAddress, senderPort);
+
+    hostIp = senderAddress;
+    hostAddress = senderAddress;
+
+    // No enviar PONG aún. Esperaremos a recibir EMOTIBIT_CONNECT (EC)
+}
+
+
+
+
 void EmotiBitEmulator::sendHelloHostMessage(const QHostAddress &sender, quint16 senderPort){
     QString localIp = getLocalIpAddress();
 
@@ -401,7 +478,7 @@ void EmotiBitEmulator::sendPongMessage()
     if (bytesSent == -1) {
         emit messageLogged("Error al enviar PONG: " + advertisingSocket->errorString());
         qDebug() << "Error al enviar PONG:" << advertisingSocket->errorString();
-    } else {
+    } else if (sampled(++pongsSent)) {
         emit messageLogged(QString("Enviado PONG: %1 al Host: %2 Puerto: %3")
                                .arg(pongMessage.trimmed())
                                .arg(senderAddress.toString())
@@ -418,63 +495,6 @@ void EmotiBitEmulator::sendPongMessage()
 
 
 
-void EmotiBitEmulator::sendData()
-{
-    if (!csvStream.atEnd()) {
-        QString line = csvStream.readLine().trimmed();
-
-        if (line.isEmpty()) {
-            emit messageLogged("Línea vacía en el archivo CSV.");
-            qDebug() << "Línea vacía en el archivo CSV.";
-            return;
-        }
-
-        // Calcular el timestamp sincronizado
-        qint64 currentLocalTime = QDateTime::currentMSecsSinceEpoch();
-        qint64 syncedTimestamp = currentLocalTime - localTimestampOffset;
-
-        // Formatear el paquete reemplazando el timestamp con el sincronizado
-        QStringList fields = line.split(',');
-        if (!fields.isEmpty()) {
-            fields[0] = QString::number(syncedTimestamp);
-        }
-
-        QString formattedPacket = fields.join(',').trimmed();
-        if (!formattedPacket.endsWith('\n')) {
-            formattedPacket += '\n';
-        }
-
-        QByteArray dataPacket = formattedPacket.toUtf8();
-
-        // Verificar que senderAddress y dataPort están correctamente establecidos
-        if (senderAddress.isNull() || dataPort <= 0 || dataPort > 65535) {
-            emit messageLogged("Error al enviar datos: senderAddress o dataPort no válidos.");
-            qDebug() << "Error al enviar datos: senderAddress o dataPort no válidos.";
-            return;
-        }
-
-        // Enviar los datos
-        qint64 bytesSent = dataSocket->writeDatagram(dataPacket, senderAddress, dataPort);
-        if (bytesSent == -1) {
-            emit messageLogged("Error al enviar datos: " + dataSocket->errorString());
-            qDebug() << "Error al enviar datos:" << dataSocket->errorString();
-        } else {
-            emit messageLogged("Paquete de datos enviado: " + formattedPacket);
-            qDebug() << "Paquete de datos enviado:" << formattedPacket;
-        }
-    } else {
-        dataTimer->stop();
-        if (csvFile.isOpen()) {
-            csvFile.close();
-        }
-        emit messageLogged("Transmisión de datos completada.");
-        qDebug() << "Transmisión de datos completada.";
-    }
-}
-
-
-
-
 void EmotiBitEmulator::readDataMessage()
 {
     while (dataSocket->hasPendingDatagrams()) {
@@ -486,8 +506,7 @@ void EmotiBitEmulator::readDataMessage()
         dataSocket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
 
         QString message = QString::fromUtf8(datagram);
-        emit messageLogged("Mensaje recibido en el puerto de datos: " + message);
-        qDebug() << "Mensaje recibido en el puerto de datos:" << message;
+        ++dataMessagesReceived;
 
         // Extraer el timestamp del mensaje (asumiendo que está en el primer campo)
         QStringList fields = message.split(',');
@@ -497,8 +516,10 @@ void EmotiBitEmulator::readDataMessage()
             if (ok) {
                 hostTimestamp = receivedTimestamp; // Actualizar la variable global
                 localTimestampOffset = QDateTime::currentMSecsSinceEpoch() - hostTimestamp;
-                emit messageLogged(QString("Timestamp sincronizado con el host: %1").arg(hostTimestamp));
-                qDebug() << "Timestamp sincronizado con el host:" << hostTimestamp;
+                if (sampled(++timeSyncs)) {
+                    emit messageLogged(QString("Timestamp sincronizado con el host: %1").arg(hostTimestamp));
+                    qDebug() << "Timestamp sincronizado con el host:" << hostTimestamp;
+                }
             }
         }
     }
@@ -506,3 +527,22 @@ void EmotiBitEmulator::readDataMessage()
 
 
 
+/**
+ * Ritmo de envío de la reproducción en curso: sustituye al registro por paquete, que no es
+ * viable a decenas de miles de paquetes por segundo.
+ */
+void EmotiBitEmulator::logReplayStats()
+{
+    if (streamId < 0) return;
+    const quint64 packets = counters->packets.load(std::memory_order_relaxed);
+    const quint64 datagrams = counters->datagrams.load(std::memory_order_relaxed);
+    const double seconds = std::max<qint64>(1, statsClock.restart()) / 1000.0;
+    emit messageLogged(QString("Enviando: %1 paquetes/s en %2 datagramas/s (%3 paquetes, %4 errores, %5 mensajes del host).")
+                           .arg((packets - lastStatsPackets) / seconds, 0, 'f', 0)
+                           .arg((datagrams - lastStatsDatagrams) / seconds, 0, 'f', 0)
+                           .arg(packets)
+                           .arg(counters->errors.load(std::memory_order_relaxed))
+                           .arg(dataMessagesReceived));
+    lastStatsPackets = packets;
+    lastStatsDatagrams = datagrams;
+}
@@ -4,24 +4,51 @@
 #include <QObject>
 #include <QUdpSocket>
 #include <QTcpSocket>
-#include <QTimer>
-#include <QFile>
-#include <QTextStream>
 #include <QHostAddress>
 #include <QElapsedTimer>
+#include <memory>
+#include "replayengine.h"
 
 class EmotiBitEmulator : public QObject
 {
     Q_OBJECT
 
 public:
+    // Identidad y origen de datos de un dispositivo virtual (los valores por defecto son los del emulador único)
+    struct Options {
+        QString deviceId = "Simulador_EmotiBit";
+        QHostAddress address = QHostAddress(QHostAddress::Any);   // en una flota, un alias de loopback propio
+        QString csvFile;                  // vacío = muestras.csv al conectar
+        bool synthetic = false;           // señal generada en lugar de CSV
+        quint32 seed = 0;                 // semilla de la señal sintética
+        ReplayEngine *engine = nullptr;   // motor compartido (flota); nullptr = uno propio
+    };
+
     explicit EmotiBitEmulator(QObject *parent = nullptr);
+    explicit EmotiBitEmulator(const Options &options, QObject *parent = nullptr);
     ~EmotiBitEmulator();
 
+    const QString &id() const { return deviceId; }
+    const QHostAddress &address() const { return localAddress; }
+    bool isListening() const { return listening; }
+    bool isReplaying() const { return streamId >= 0; }
+
     void setCsvFile(const QString &filePath);
     void startEmulation();
     void stopEmulation();
 
+    // Reproducción: velocidad (0 = lo más rápido posible), bucle y salto a un instante de la grabación
+    void setReplaySpeed(double factor) { replay->setSpeed(factor); }
+    void setReplayLoop(bool loop) { replay->setLoop(loop); }
+    void seekReplay(qint64 offsetMs) { replay->seek(offsetMs); }
+    // Datagramas como los del firmware (varios paquetes por datagrama y envío múltiple); desde la próxima reproducción
+    void setReplayPacking(const ReplayStream::Packing &packing) { replayPacking = packing; }
+    const ReplayEngine *replayEngine() const { return replay; }
+    const ReplayCounters &replayCounters() const { return *counters; }
+
+    // Responde a un HELLO_EMOTIBIT recibido por otro socket (descubrimiento compartido de la flota)
+    void answerHello(const QHostAddress &sender, quint16 senderPort);
+
 signals:
     void messageLogged(const QString &message);
 
@@ -30,31 +57,54 @@ private slots:
     void readDataMessage();
     void sendHelloHostMessage(const QHostAddress &sender, quint16 senderPort);
     void sendPongMessage();
-    void sendData();
+    void logReplayStats();
 
 private:
     bool setupAdvertisingSocket();
     QString getLocalIpAddress();
     void connectHost(quint16 controlPort, quint16 dataPort);
     QString formatPacket(const QString &payload);
+    void startReplay();
+    void stopReplay();
+
+    // Registro muestreado de los mensajes periódicos: el primero y uno de cada kLogEvery
+    static constexpr int kLogEvery = 60;
+    static constexpr int kStatsIntervalMs = 5000;
+    static bool sampled(quint64 count) { return count == 1 || count % kLogEvery == 0; }
 
     // Sockets para comunicación
     QUdpSocket *advertisingSocket;
     QUdpSocket *dataSocket;
     QTcpSocket *controlClientSocket;
-    QTimer *dataTimer;
+    ReplayEngine *replay;       // envía los paquetes desde su propio hilo (compartido en una flota)
+    bool ownsEngine;
+    int streamId = -1;          // flujo en curso en el motor
+    std::shared_ptr<ReplayCounters> counters;
+    ReplayStream::Packing replayPacking;
+
+    // Contadores que sustituyen al registro por mensaje
+    quint64 pingsReceived = 0;
+    quint64 pongsSent = 0;
+    quint64 timeSyncs = 0;
+    quint64 dataMessagesReceived = 0;
+    quint64 lastStatsPackets = 0;
+    quint64 lastStatsDatagrams = 0;
+    QElapsedTimer statsClock;
 
     qint64 hostTimestamp = -1;  // Timestamp más reciente recibido del host
     qint64 localTimestampOffset = 0; // Diferencia entre el tiempo local y el del host
 
 
-    // Variables para el archivo CSV
-    QFile csvFile;
-    QTextStream csvStream;
+    // Archivo CSV que se reproduce, o señal sintética
+    QString csvFilePath;
+    bool synthetic;
+    quint32 seed;
 
     // Estado de conexión y configuración
     bool isConnected;
+    bool listening;
     QString deviceId;
+    QHostAddress localAddress;
     quint16 advertisingPort;
     quint16 dataPort;    // Se establecerá luego del EMOTIBIT_CONNECT
     quint16 controlPort; // Se establecerá luego del EMOTIBIT_CONNECT
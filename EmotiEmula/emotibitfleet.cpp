@@ -0,0 +1,183 @@
+#include "emotibitfleet.h"
+#include <QUdpSocket>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+constexpr quint16 kAdvertisingPort = 3131;
+constexpr int kStatsIntervalMs = 5000;
+}
+
+EmotiBitFleet::EmotiBitFleet(QObject *parent) :
+    QObject(parent),
+    discoverySocket(new QUdpSocket(this)),
+    statsTimer(new QTimer(this))
+{
+    connect(discoverySocket, &QUdpSocket::readyRead, this, &EmotiBitFleet::readDiscoveryMessage);
+    connect(statsTimer, &QTimer::timeout, this, &EmotiBitFleet::logStats);
+}
+
+
+
+EmotiBitFleet::~EmotiBitFleet()
+{
+    stop();
+}
+
+
+
+/**
+ * @brief Crea los motores y los dispositivos y abre el socket de descubrimiento.
+ * @return false si no se ha podido poner a escuchar ningún dispositivo.
+ */
+bool EmotiBitFleet::start(const Settings &settings)
+{
+    stop();
+
+    if (!discoverySocket->bind(QHostAddress::AnyIPv4, kAdvertisingPort,
+                               QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        emit messageLogged(QString("Flota: error al vincular el socket de descubrimiento al puerto %1: %2")
+                               .arg(kAdvertisingPort).arg(discoverySocket->errorString()));
+        return false;
+    }
+
+    const int threads = std::clamp(settings.threads, 1, std::max(1, settings.devices));
+    for (int t = 0; t < threads; ++t) {
+        auto *engine = new ReplayEngine(this);
+        connect(engine, &ReplayEngine::sendError, this, &EmotiBitFleet::messageLogged);
+        engines.append(engine);
+    }
+
+    const quint32 firstIp = settings.firstAddress.toIPv4Address();
+    for (int i = 0; i < settings.devices; ++i) {
+        EmotiBitEmulator::Options options;
+        options.deviceId = settings.idPrefix + QString::number(i + 1).rightJustified(2, '0');
+        options.address = QHostAddress(firstIp + quint32(i));
+        if (settings.csvFiles.isEmpty()) {
+            options.synthetic = true;
+            options.seed = quint32(i + 1);
+        } else {
+            options.csvFile = settings.csvFiles.at(i % settings.csvFiles.size());
+        }
+        options.engine = engines.at(i % threads);
+
+        auto *device = new EmotiBitEmulator(options, this);
+        const QString prefix = "[" + options.deviceId + "] ";
+        connect(device, &EmotiBitEmulator::messageLogged, this, [this, prefix](const QString &message) {
+            emit messageLogged(prefix + message);
+        });
+        if (!device->isListening()) {
+            emit messageLogged(QString("Flota: %1 no puede escuchar en %2:%3 (¿falta el alias de loopback?)")
+                                   .arg(options.deviceId, options.address.toString()).arg(kAdvertisingPort));
+            delete device;
+            continue;
+        }
+        devices.append(device);
+    }
+
+    if (devices.isEmpty()) {
+        stop();
+        return false;
+    }
+
+    lastSentPackets = 0;
+    statsClock.start();
+    statsTimer->start(kStatsIntervalMs);
+    emit messageLogged(QString("Flota iniciada: %1 dispositivos (%2 - %3) en %4 hilo(s) de envío, %5.")
+                           .arg(devices.size())
+                           .arg(devices.first()->address().toString(), devices.last()->address().toString())
+                           .arg(engines.size())
+                           .arg(settings.csvFiles.isEmpty() ? QString("señal sintética")
+                                                            : QString("%1 CSV").arg(settings.csvFiles.size())));
+    return true;
+}
+
+
+
+void EmotiBitFleet::stop()
+{
+    statsTimer->stop();
+    qDeleteAll(devices);          // cada dispositivo quita su flujo del motor
+    devices.clear();
+    for (ReplayEngine *engine : std::as_const(engines)) engine->stop();
+    qDeleteAll(engines);
+    engines.clear();
+    if (discoverySocket->state() == QAbstractSocket::BoundState) discoverySocket->close();
+}
+
+
+
+void EmotiBitFleet::setReplaySpeed(double factor)
+{
+    for (ReplayEngine *engine : std::as_const(engines)) engine->setSpeed(factor);
+}
+
+
+
+void EmotiBitFleet::setReplayLoop(bool loop)
+{
+    for (ReplayEngine *engine : std::as_const(engines)) engine->setLoop(loop);
+}
+
+
+
+void EmotiBitFleet::seekReplay(qint64 offsetMs)
+{
+    for (ReplayEngine *engine : std::as_const(engines)) engine->seek(offsetMs);
+}
+
+
+
+void EmotiBitFleet::setReplayPacking(const ReplayStream::Packing &packing)
+{
+    for (EmotiBitEmulator *device : std::as_const(devices)) device->setReplayPacking(packing);
+}
+
+
+
+quint64 EmotiBitFleet::sentPackets() const
+{
+    quint64 total = 0;
+    for (const ReplayEngine *engine : engines) total += engine->totals().packets.load(std::memory_order_relaxed);
+    return total;
+}
+
+
+
+/**
+ * Los HELLO_EMOTIBIT de difusión llegan a este socket y no a los de los alias: se reparten a
+ * todos los dispositivos, que contestan cada uno desde su dirección. El resto de mensajes
+ * (EC, PN) los recibe ya cada dispositivo en su alias.
+ */
+void EmotiBitFleet::readDiscoveryMessage()
+{
+    while (discoverySocket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(int(discoverySocket->pendingDatagramSize()));
+        QHostAddress sender;
+        quint16 port;
+        discoverySocket->readDatagram(datagram.data(), datagram.size(), &sender, &port);
+
+        const QList<QByteArray> fields = datagram.split(',');
+        if (fields.size() < 4 || fields.at(3) != "HE") continue;
+        for (EmotiBitEmulator *device : std::as_const(devices)) device->answerHello(sender, port);
+    }
+}
+
+
+
+void EmotiBitFleet::logStats()
+{
+    int replaying = 0;
+    for (const EmotiBitEmulator *device : std::as_const(devices))
+        if (device->isReplaying()) ++replaying;
+
+    const quint64 sent = sentPackets();
+    const double seconds = std::max<qint64>(1, statsClock.restart()) / 1000.0;
+    emit messageLogged(QString("Flota: %1/%2 dispositivos enviando, %3 paquetes/s (%4 en total).")
+                           .arg(replaying).arg(devices.size())
+                           .arg((sent - lastSentPackets) / seconds, 0, 'f', 0)
+                           .arg(sent));
+    lastSentPackets = sent;
+}
@@ -0,0 +1,75 @@
+#ifndef EMOTIBITFLEET_H
+#define EMOTIBITFLEET_H
+
+#include <QObject>
+#include <QList>
+#include <QStringList>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include "emotibitemulator.h"
+
+class QUdpSocket;
+class QTimer;
+
+/**
+ * @class EmotiBitFleet
+ * @brief Flota de N EmotiBits virtuales en un solo proceso, para pruebas de carga del host.
+ *
+ * El host identifica cada dispositivo por la IP del remitente y le habla siempre al puerto
+ * 3131, así que cada dispositivo virtual tiene su propio alias de loopback (127.0.0.10,
+ * 127.0.0.11...) con sus sockets de advertising, datos y control, y su propio ID
+ * (Simulador_EmotiBit_01...). Un socket de descubrimiento compartido en el puerto 3131 recibe
+ * los HELLO_EMOTIBIT de difusión y cada dispositivo responde desde su alias.
+ *
+ * Todos los dispositivos viven en el bucle de eventos de la interfaz; el envío de datos lo
+ * hacen 'threads' motores de reproducción (uno por hilo) entre los que se reparten. Cada
+ * dispositivo reproduce un CSV de la lista (por turno) o, si no hay lista, una señal
+ * sintética con su propia semilla.
+ */
+class EmotiBitFleet : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Settings {
+        int devices = 16;
+        QString idPrefix = "Simulador_EmotiBit_";
+        QHostAddress firstAddress = QHostAddress("127.0.0.10");
+        QStringList csvFiles;          // se reparten por turno; vacío = señal sintética
+        int threads = 1;               // motores de reproducción
+    };
+
+    explicit EmotiBitFleet(QObject *parent = nullptr);
+    ~EmotiBitFleet();
+
+    bool start(const Settings &settings);
+    void stop();
+    bool isRunning() const { return !devices.isEmpty(); }
+
+    const QList<EmotiBitEmulator *> &fleetDevices() const { return devices; }
+
+    void setReplaySpeed(double factor);
+    void setReplayLoop(bool loop);
+    void seekReplay(qint64 offsetMs);
+    void setReplayPacking(const ReplayStream::Packing &packing);
+
+    quint64 sentPackets() const;
+
+signals:
+    void messageLogged(const QString &message);
+
+private slots:
+    void readDiscoveryMessage();
+    void logStats();
+
+private:
+    QUdpSocket *discoverySocket;
+    QTimer *statsTimer;
+    QList<ReplayEngine *> engines;
+    QList<EmotiBitEmulator *> devices;
+
+    quint64 lastSentPackets = 0;
+    QElapsedTimer statsClock;
+};
+
+#endif // EMOTIBITFLEET_H
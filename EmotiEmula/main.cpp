@@ -1,11 +1,29 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    // Modo flota para pruebas de carga: --flota 16 [--csv a.csv --csv b.csv] [--hilos 2]
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption fleetOption("flota", "Número de EmotiBits virtuales.", "n");
+    QCommandLineOption csvOption("csv", "CSV a reproducir (se reparten por turno; sin CSV, señal sintética).", "archivo");
+    QCommandLineOption threadsOption("hilos", "Hilos de envío de la flota.", "n", "1");
+    parser.addOptions({ fleetOption, csvOption, threadsOption });
+    parser.process(a);
+
     MainWindow w;
     w.show();
+    if (parser.isSet(fleetOption)) {
+        EmotiBitFleet::Settings settings;
+        settings.devices = qMax(1, parser.value(fleetOption).toInt());
+        settings.csvFiles = parser.values(csvOption);
+        settings.threads = qMax(1, parser.value(threadsOption).toInt());
+        w.startFleet(settings);
+    }
     return a.exec();
 }
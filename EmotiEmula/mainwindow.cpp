@@ -3,6 +3,10 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include <iterator>
+
+// Factores de velocidad de comboBoxVelocidad, en el mismo orden (0 = lo más rápido posible)
+static const double kReplaySpeeds[] = { 0.5, 1.0, 2.0, 10.0, 0.0 };
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -61,6 +65,67 @@ void MainWindow::on_pushButtonStop_clicked()
     displayMessage("Emulación detenida.");
 }
 
+void MainWindow::on_comboBoxVelocidad_currentIndexChanged(int index)
+{
+    if (index < 0 || index >= int(std::size(kReplaySpeeds))) return;
+    if (fleet) fleet->setReplaySpeed(kReplaySpeeds[index]);
+    else if (emulator) emulator->setReplaySpeed(kReplaySpeeds[index]);
+}
+
+void MainWindow::on_checkBoxBucle_toggled(bool checked)
+{
+    if (fleet) fleet->setReplayLoop(checked);
+    else if (emulator) emulator->setReplayLoop(checked);
+}
+
+void MainWindow::on_checkBoxEmpaquetar_toggled(bool checked)
+{
+    const ReplayStream::Packing packing = checked ? ReplayStream::Packing::firmware() : ReplayStream::Packing();
+    if (fleet) fleet->setReplayPacking(packing);
+    else if (emulator) emulator->setReplayPacking(packing);
+    displayMessage(checked ? "Datagramas como el firmware (desde la próxima reproducción)."
+                           : "Un paquete por datagrama (desde la próxima reproducción).");
+}
+
+void MainWindow::on_pushButtonIr_clicked()
+{
+    if (fleet) fleet->seekReplay(qint64(ui->spinBoxIr->value()) * 1000);
+    else if (emulator) emulator->seekReplay(qint64(ui->spinBoxIr->value()) * 1000);
+    displayMessage(QString("Reproducción desde el segundo %1.").arg(ui->spinBoxIr->value()));
+}
+
+void MainWindow::on_pushButtonFlota_clicked()
+{
+    EmotiBitFleet::Settings settings;
+    settings.devices = ui->spinBoxFlota->value();
+    startFleet(settings);
+}
+
+bool MainWindow::startFleet(const EmotiBitFleet::Settings &settings)
+{
+    // El emulador único deja libre el puerto 3131 para el descubrimiento de la flota
+    delete emulator;
+    emulator = nullptr;
+
+    if (!fleet) {
+        fleet = new EmotiBitFleet(this);
+        connect(fleet, &EmotiBitFleet::messageLogged, this, &MainWindow::displayMessage);
+    }
+    if (!fleet->start(settings)) {
+        displayMessage("No se ha podido iniciar la flota.");
+        return false;
+    }
+
+    // Los dispositivos nuevos toman la configuración de reproducción de la ventana
+    on_comboBoxVelocidad_currentIndexChanged(ui->comboBoxVelocidad->currentIndex());
+    on_checkBoxBucle_toggled(ui->checkBoxBucle->isChecked());
+    fleet->setReplayPacking(ui->checkBoxEmpaquetar->isChecked() ? ReplayStream::Packing::firmware() : ReplayStream::Packing());
+    ui->spinBoxFlota->setValue(settings.devices);
+    ui->spinBoxFlota->setEnabled(false);
+    ui->pushButtonFlota->setEnabled(false);
+    return true;
+}
+
 void MainWindow::displayMessage(const QString &message)
 {
     ui->textBrowserMensajes->append(message);
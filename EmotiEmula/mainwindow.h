@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include "EmotiBitEmulator.h"
+#include "emotibitfleet.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -16,16 +17,25 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Sustituye el emulador único por una flota de dispositivos virtuales
+    bool startFleet(const EmotiBitFleet::Settings &settings);
+
 private slots:
     void on_pushButtonLoadCsv_clicked();
     void on_pushButtonStart_clicked();
     void on_pushButtonStop_clicked();
+    void on_comboBoxVelocidad_currentIndexChanged(int index);
+    void on_checkBoxBucle_toggled(bool checked);
+    void on_checkBoxEmpaquetar_toggled(bool checked);
+    void on_pushButtonIr_clicked();
+    void on_pushButtonFlota_clicked();
 
     void displayMessage(const QString &message);
 
 private:
     Ui::MainWindow *ui;
     EmotiBitEmulator *emulator;
+    EmotiBitFleet *fleet = nullptr;
 
 };
 
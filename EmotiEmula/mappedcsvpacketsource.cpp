@@ -0,0 +1,114 @@
+#include "mappedcsvpacketsource.h"
+#include "csvpacketsource.h"
+#include <QFileInfo>
+#include <algorithm>
+#include <cstring>
+
+MappedCsvPacketSource::MappedCsvPacketSource(const QString &filePath)
+    : m_file(filePath)
+{
+}
+
+
+
+MappedCsvPacketSource::~MappedCsvPacketSource()
+{
+    close();
+}
+
+
+
+bool MappedCsvPacketSource::open(QString *error)
+{
+    close();
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("No se puede abrir %1: %2").arg(m_file.fileName(), m_file.errorString());
+        return false;
+    }
+    m_size = m_file.size();
+    uchar *data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!data) {
+        if (error) *error = QString("No se puede proyectar %1 en memoria: %2").arg(m_file.fileName(), m_file.errorString());
+        close();
+        return false;
+    }
+    m_data = reinterpret_cast<const char *>(data);
+
+    buildIndex();
+    if (m_index.empty()) {
+        if (error) *error = QString("%1 no contiene paquetes").arg(m_file.fileName());
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+
+void MappedCsvPacketSource::close()
+{
+    if (m_data) m_file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_data)));
+    m_data = nullptr;
+    m_size = 0;
+    m_file.close();
+    m_index.clear();
+    m_index.shrink_to_fit();
+    m_next = 0;
+}
+
+
+
+bool MappedCsvPacketSource::next(ReplayPacket &packet)
+{
+    if (m_next >= m_index.size()) return false;
+    const Line &line = m_index[m_next++];
+    packet.deviceMs = line.deviceMs;
+    packet.rest = m_data + line.restOffset;
+    packet.restSize = line.restSize;
+    return true;
+}
+
+
+
+QString MappedCsvPacketSource::describe() const
+{
+    return QString("%1 (%2 paquetes, %3 bytes, proyectado en memoria)")
+        .arg(QFileInfo(m_file.fileName()).fileName()).arg(packetCount()).arg(m_size);
+}
+
+
+
+bool MappedCsvPacketSource::seek(qint64 offsetMs, ReplayPacket &packet)
+{
+    const qint64 target = firstTimestamp() + std::max<qint64>(0, offsetMs);
+    if (!m_sorted) return PacketSource::seek(offsetMs, packet);
+    const auto it = std::lower_bound(m_index.begin(), m_index.end(), target,
+                                     [](const Line &line, qint64 ms) { return line.deviceMs < ms; });
+    m_next = size_t(it - m_index.begin());
+    return next(packet);
+}
+
+
+
+// Una pasada por la proyección: cada línea que es un paquete queda en el índice
+void MappedCsvPacketSource::buildIndex()
+{
+    m_index.clear();
+    m_index.reserve(size_t(m_size / 48));   // las líneas de EmotiBit rondan los 40-80 bytes
+    m_sorted = true;
+
+    const char *p = m_data;
+    const char *end = m_data + m_size;
+    ReplayPacket packet;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        const char *lineEnd = eol ? eol : end;
+        int size = int(lineEnd - p);
+        while (size > 0 && p[size - 1] == '\r') --size;
+        if (CsvPacketSource::parseLine(p, size, packet)) {
+            if (!m_index.empty() && packet.deviceMs < m_index.back().deviceMs) m_sorted = false;
+            m_index.push_back({ packet.deviceMs, qint64(packet.rest - m_data), packet.restSize });
+        }
+        p = lineEnd + 1;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef MAPPEDCSVPACKETSOURCE_H
+#define MAPPEDCSVPACKETSOURCE_H
+
+#include <QFile>
+#include <vector>
+#include "packetsource.h"
+
+/**
+ * @class MappedCsvPacketSource
+ * @brief Fuente CSV proyectada en memoria, con las líneas indexadas al abrir.
+ *
+ * El archivo se proyecta una vez y se recorre entero para guardar, por paquete, su marca de
+ * tiempo y dónde empieza el resto de la línea. Después next() no lee ni copia nada: devuelve
+ * punteros a la proyección, y seek() busca en el índice (búsqueda binaria si las marcas están
+ * ordenadas). Es la fuente para reproducir a alta velocidad; las líneas válidas son las mismas
+ * que acepta CsvPacketSource.
+ */
+class MappedCsvPacketSource : public PacketSource
+{
+public:
+    explicit MappedCsvPacketSource(const QString &filePath);
+    ~MappedCsvPacketSource() override;
+
+    bool open(QString *error = nullptr) override;
+    void close() override;
+    void rewind() override { m_next = 0; }
+    bool next(ReplayPacket &packet) override;
+    qint64 firstTimestamp() const override { return m_index.empty() ? -1 : m_index.front().deviceMs; }
+    QString describe() const override;
+    bool seek(qint64 offsetMs, ReplayPacket &packet) override;
+
+    int packetCount() const { return int(m_index.size()); }
+
+private:
+    struct Line {
+        qint64 deviceMs;
+        qint64 restOffset;      // posición de la primera coma en la proyección
+        int restSize;
+    };
+
+    void buildIndex();
+
+    QFile m_file;
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+    std::vector<Line> m_index;
+    size_t m_next = 0;
+    bool m_sorted = true;       // marcas no decrecientes: seek() por búsqueda binaria
+};
+
+#endif // MAPPEDCSVPACKETSOURCE_H
@@ -0,0 +1,64 @@
+#ifndef PACKETSOURCE_H
+#define PACKETSOURCE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <algorithm>
+
+/**
+ * @brief Paquete de una grabación, tal como lo entrega una PacketSource.
+ *
+ * La marca de tiempo original (columna 0) ya viene separada; 'rest' apunta al resto de la
+ * línea desde la primera coma (incluida) y sin fin de línea, de modo que el emisor solo tiene
+ * que escribir la marca nueva delante. El puntero es válido hasta la siguiente llamada a la fuente.
+ */
+struct ReplayPacket {
+    qint64 deviceMs = 0;
+    const char *rest = nullptr;
+    int restSize = 0;
+};
+
+/**
+ * @class PacketSource
+ * @brief Origen de paquetes para ReplayEngine (archivo CSV, sintético...).
+ *
+ * Las fuentes se usan desde un único hilo a la vez: se abren en el hilo de la interfaz y
+ * después solo las toca el hilo de reproducción.
+ */
+class PacketSource
+{
+public:
+    virtual ~PacketSource() = default;
+
+    virtual bool open(QString *error = nullptr) = 0;
+    virtual void close() = 0;
+
+    // Vuelve al primer paquete
+    virtual void rewind() = 0;
+
+    // Siguiente paquete en orden de archivo; false al llegar al final
+    virtual bool next(ReplayPacket &packet) = 0;
+
+    // Marca de tiempo del primer paquete (-1 si la fuente está vacía o cerrada)
+    virtual qint64 firstTimestamp() const = 0;
+
+    virtual QString describe() const = 0;
+
+    /**
+     * @brief Coloca la fuente en el primer paquete a offsetMs o más del inicio.
+     * @param offsetMs Desplazamiento respecto al primer paquete, en ms.
+     * @param packet Recibe ese paquete.
+     * @return false si no hay ningún paquete tan avanzado.
+     *
+     * La versión por defecto recorre la fuente desde el principio; las fuentes indexadas la sustituyen.
+     */
+    virtual bool seek(qint64 offsetMs, ReplayPacket &packet) {
+        rewind();
+        const qint64 target = firstTimestamp() + std::max<qint64>(0, offsetMs);
+        while (next(packet))
+            if (packet.deviceMs >= target) return true;
+        return false;
+    }
+};
+
+#endif // PACKETSOURCE_H
@@ -0,0 +1,269 @@
+#include "replayengine.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <chrono>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace {
+constexpr qint64 kSpinNs = 1500000;      // último tramo de la espera en espera activa
+constexpr qint64 kMaxSleepUs = 20000;    // para atender stop/seek/velocidad/flujos con rapidez
+}
+
+ReplayEngine::ReplayEngine(QObject *parent)
+    : QObject(parent)
+{
+}
+
+
+
+ReplayEngine::~ReplayEngine()
+{
+    stop();
+}
+
+
+
+/**
+ * @brief Entrega un flujo configurado al motor; empieza a enviar en cuanto lo recoge el hilo.
+ * @return Identificador del flujo para removeStream() y las señales.
+ */
+int ReplayEngine::addStream(std::unique_ptr<ReplayStream> stream)
+{
+    if (!stream) return -1;
+    int id;
+    bool restart;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        id = m_nextId++;
+        stream->setTotals(&m_totals);
+        m_added.push_back({ id, std::move(stream), 0 });
+        m_pending = true;
+        restart = !m_thread || m_exiting;
+    }
+    m_streamCount.fetch_add(1, std::memory_order_relaxed);
+    if (restart) startThread();
+    return id;
+}
+
+
+
+void ReplayEngine::removeStream(int id)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    auto it = std::find_if(m_added.begin(), m_added.end(), [id](const Entry &e) { return e.id == id; });
+    if (it != m_added.end()) {
+        m_added.erase(it);
+        m_streamCount.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    m_removed.append(id);
+    m_pending = true;
+}
+
+
+
+void ReplayEngine::setSpeed(double factor)
+{
+    m_speed.store(std::max(0.0, factor), std::memory_order_relaxed);
+}
+
+
+
+void ReplayEngine::seek(qint64 offsetMs)
+{
+    m_seekMs.store(std::max<qint64>(0, offsetMs), std::memory_order_relaxed);
+}
+
+
+
+void ReplayEngine::stop()
+{
+    if (m_thread) {
+        m_stop = true;
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    QMutexLocker locker(&m_pendingMutex);
+    m_added.clear();
+    m_removed.clear();
+    m_pending = false;
+    m_exiting = false;
+    m_streamCount = 0;
+}
+
+
+
+bool ReplayEngine::isRunning() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+
+
+void ReplayEngine::startThread()
+{
+    if (m_thread) {   // hilo anterior que ya estaba terminando
+        m_thread->wait();
+        delete m_thread;
+    }
+    m_exiting = false;
+    m_stop = false;
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start(QThread::TimeCriticalPriority);
+}
+
+
+
+qint64 ReplayEngine::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+/**
+ * @brief Recoge en el hilo de reproducción los flujos añadidos y quitados.
+ * @param clockMs Reloj virtual actual: los flujos nuevos empiezan en él.
+ * @return false si no queda ningún flujo y el hilo debe terminar.
+ */
+bool ReplayEngine::takePending(std::vector<Entry> &active, double clockMs)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    for (int id : std::as_const(m_removed)) {
+        auto it = std::find_if(active.begin(), active.end(), [id](const Entry &e) { return e.id == id; });
+        if (it == active.end()) continue;   // ya había terminado
+        it->stream->close(false);
+        active.erase(it);
+        m_streamCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    m_removed.clear();
+
+    for (Entry &e : m_added) {
+        QString warning;
+        if (!e.stream->open(&warning)) {
+            emit sendError(e.stream->name() + ": la fuente no tiene paquetes o no hay destino");
+            m_streamCount.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!warning.isEmpty()) emit sendError(warning);
+        e.offsetMs = qint64(clockMs) - e.stream->dueMs();
+        active.push_back(std::move(e));
+    }
+    m_added.clear();
+    m_pending = false;
+
+    if (active.empty()) m_exiting = true;
+    return !active.empty();
+}
+
+
+
+/**
+ * @brief Espera hasta dueNs: duerme mientras falta mucho y apura el final en espera activa.
+ * @return false si hay que volver a planificar (parada, salto, velocidad o flujos nuevos).
+ */
+bool ReplayEngine::waitUntil(qint64 dueNs, double speed) const
+{
+    for (;;) {
+        if (m_stop.load(std::memory_order_relaxed)
+            || m_pending.load(std::memory_order_relaxed)
+            || m_seekMs.load(std::memory_order_relaxed) >= 0
+            || m_speed.load(std::memory_order_relaxed) != speed)
+            return false;
+        const qint64 left = dueNs - nowNs();
+        if (left <= 0) return true;
+        if (left > kSpinNs) QThread::usleep(std::min<qint64>((left - kSpinNs) / 1000, kMaxSleepUs));
+        else QThread::yieldCurrentThread();
+    }
+}
+
+
+
+/**
+ * @brief Bucle del hilo de reproducción.
+ *
+ * Cada flujo vence en su tiempo (ReplayStream::dueMs) más un desplazamiento fijado al
+ * recogerlo, sobre un reloj virtual común que avanza a la velocidad elegida desde un ancla;
+ * el ancla se mueve al cambiar la velocidad. En cada paso se atiende el flujo que antes
+ * vence, así que con N dispositivos el coste es de un hilo y N sockets.
+ */
+void ReplayEngine::run()
+{
+#ifdef Q_OS_WIN
+    timeBeginPeriod(1);
+#endif
+    std::vector<Entry> active;
+    double speed = -1.0;
+    qint64 anchorNs = nowNs();
+    double anchorClock = 0.0;    // reloj virtual (ms) en anchorNs
+    auto clock = [&]() {
+        return speed > 0.0 ? anchorClock + (nowNs() - anchorNs) * speed / 1e6 : anchorClock;
+    };
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        if ((m_pending.load(std::memory_order_relaxed) || active.empty()) && !takePending(active, clock()))
+            break;
+
+        const qint64 seekMs = m_seekMs.exchange(-1, std::memory_order_relaxed);
+        if (seekMs >= 0) {
+            // se salta en el contenido, no en las marcas enviadas: siguen creciendo
+            const double now = clock();
+            for (Entry &e : active) {
+                e.stream->seek(seekMs);
+                e.offsetMs = qint64(now) - e.stream->dueMs();
+            }
+        }
+
+        const double s = m_speed.load(std::memory_order_relaxed);
+        if (s != speed) {
+            anchorClock = clock();
+            anchorNs = nowNs();
+            speed = s;
+        }
+
+        auto next = active.end();
+        qint64 due = 0;
+        for (auto it = active.begin(); it != active.end(); ++it) {
+            if (it->stream->atEnd()) { next = it; break; }   // fin tras un salto: se retira abajo
+            const qint64 d = it->stream->dueMs() + it->offsetMs;
+            if (next == active.end() || d < due) {
+                next = it;
+                due = d;
+            }
+        }
+        if (next == active.end()) continue;
+
+        ReplayStream *stream = next->stream.get();
+        if (!stream->atEnd()) {
+            if (speed > 0.0) {
+                if (!waitUntil(anchorNs + qint64((due - anchorClock) * 1e6 / speed), speed)) continue;
+            } else {
+                anchorClock = std::max(anchorClock, double(due));
+            }
+            stream->sendCurrent(m_loop.load(std::memory_order_relaxed));
+            if (stream->takeLooped()) emit looped(next->id, stream->loops());
+            const QString error = stream->takeError();
+            if (!error.isEmpty()) emit sendError(error);
+        }
+
+        if (stream->atEnd()) {
+            const int id = next->id;
+            stream->close(true);
+            active.erase(next);
+            m_streamCount.fetch_sub(1, std::memory_order_relaxed);
+            emit streamFinished(id);
+        }
+    }
+    for (Entry &e : active) e.stream->close(false);
+
+#ifdef Q_OS_WIN
+    timeEndPeriod(1);
+#endif
+    if (!m_stop.load(std::memory_order_relaxed)) emit finished();
+}
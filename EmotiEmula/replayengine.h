@@ -0,0 +1,94 @@
+#ifndef REPLAYENGINE_H
+#define REPLAYENGINE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "replaystream.h"
+
+/**
+ * @class ReplayEngine
+ * @brief Reproduce uno o varios flujos respetando las marcas de tiempo originales.
+ *
+ * Un hilo propio envía cada paquete cuando le toca según su marca de tiempo (columna 0)
+ * dividida por el factor de velocidad, así que se conservan la cadencia y las ráfagas de la
+ * sesión real. Con varios flujos (una flota de dispositivos virtuales) el hilo atiende siempre
+ * el que antes vence, sobre un reloj virtual común. Para esperar duerme hasta poco antes del
+ * instante y apura el resto con espera activa (en Windows se sube la resolución del
+ * temporizador del sistema a 1 ms).
+ *
+ * - Velocidad: 0.5, 1, 10... o 0 para enviar lo más rápido posible. Se puede cambiar en marcha.
+ * - Bucle: al terminar cada flujo vuelve a empezar; las marcas enviadas siguen creciendo.
+ * - seek(): salta a un desplazamiento desde el inicio de la grabación en todos los flujos.
+ *
+ * Los flujos se añaden y se quitan en marcha desde el hilo de la interfaz; uno que se añade
+ * empieza a enviar en ese momento. El hilo termina cuando no le quedan flujos.
+ */
+class ReplayEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Packing = ReplayStream::Packing;
+
+    explicit ReplayEngine(QObject *parent = nullptr);
+    ~ReplayEngine();
+
+    int addStream(std::unique_ptr<ReplayStream> stream);   // devuelve su identificador
+    void removeStream(int id);
+    int streamCount() const { return m_streamCount.load(std::memory_order_relaxed); }
+
+    void setSpeed(double factor);                 // 0 = lo más rápido posible
+    double speed() const { return m_speed.load(std::memory_order_relaxed); }
+    void setLoop(bool loop) { m_loop.store(loop, std::memory_order_relaxed); }
+    bool loop() const { return m_loop.load(std::memory_order_relaxed); }
+    void seek(qint64 offsetMs);
+
+    void stop();                                  // quita todos los flujos sin enviar lo pendiente
+    bool isRunning() const;
+
+    // Totales de todos los flujos desde la creación del motor
+    const ReplayCounters &totals() const { return m_totals; }
+
+signals:
+    void streamFinished(int id);                  // fin de la grabación de un flujo sin bucle
+    void finished();                              // ya no queda ningún flujo
+    void looped(int id, int count);
+    void sendError(const QString &message);
+
+private:
+    struct Entry {
+        int id;
+        std::unique_ptr<ReplayStream> stream;
+        qint64 offsetMs;         // reloj virtual - tiempo del flujo
+    };
+
+    void startThread();
+    void run();
+    bool takePending(std::vector<Entry> &active, double clockMs);
+    bool waitUntil(qint64 dueNs, double speed) const;
+    static qint64 nowNs();
+
+    QThread *m_thread = nullptr;
+    std::atomic<bool> m_stop {false};
+    std::atomic<double> m_speed {1.0};
+    std::atomic<bool> m_loop {false};
+    std::atomic<qint64> m_seekMs {-1};            // salto pendiente (-1 = ninguno)
+
+    QMutex m_pendingMutex;
+    std::vector<Entry> m_added;
+    QVector<int> m_removed;
+    bool m_exiting = false;                       // el hilo va a terminar: hay que lanzar otro
+    std::atomic<bool> m_pending {false};
+    int m_nextId = 0;
+    std::atomic<int> m_streamCount {0};
+
+    ReplayCounters m_totals;
+};
+
+#endif // REPLAYENGINE_H
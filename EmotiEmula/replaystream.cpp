@@ -0,0 +1,214 @@
+#include "replaystream.h"
+#include <QUdpSocket>
+#include <algorithm>
+
+namespace {
+// Escribe la marca en decimal justo antes de bufferEnd y devuelve dónde empieza (sin reservar memoria)
+const char *formatStamp(qint64 value, char *bufferEnd)
+{
+    const bool negative = value < 0;
+    quint64 u = negative ? quint64(-(value + 1)) + 1 : quint64(value);
+    char *p = bufferEnd;
+    do {
+        *--p = char('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (negative) *--p = '-';
+    return p;
+}
+}
+
+ReplayStream::ReplayStream(const QString &name, std::unique_ptr<PacketSource> source)
+    : m_name(name),
+    m_source(std::move(source))
+{
+}
+
+
+
+ReplayStream::~ReplayStream() = default;
+
+
+
+void ReplayStream::setDestination(const QHostAddress &address, quint16 port)
+{
+    m_address = address;
+    m_port = port;
+}
+
+
+
+void ReplayStream::setLocal(const QHostAddress &address, quint16 port)
+{
+    m_localAddress = address;
+    m_localPort = port;
+}
+
+
+
+/**
+ * @brief Crea el socket (en el hilo del motor) y se coloca en el primer paquete.
+ * @param warning Recibe un aviso si no se ha podido enviar desde la dirección local pedida.
+ * @return false si la fuente no tiene paquetes o no hay destino.
+ */
+bool ReplayStream::open(QString *warning)
+{
+    if (!m_source || m_address.isNull() || m_port == 0) return false;
+
+    m_socket = std::make_unique<QUdpSocket>();
+    const bool anyAddress = m_localAddress == QHostAddress::Any || m_localAddress == QHostAddress::AnyIPv4;
+    const QHostAddress local = anyAddress ? QHostAddress(QHostAddress::AnyIPv4) : m_localAddress;
+    if ((m_localPort != 0 || !anyAddress)
+        && !m_socket->bind(local, m_localPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        if (warning)
+            *warning = QString("%1: no se puede enviar desde %2:%3 (%4); se usa un puerto efímero")
+                           .arg(m_name, m_localAddress.toString()).arg(m_localPort).arg(m_socket->errorString());
+    }
+
+    m_packingOn = m_packing.intervalMs > 0;
+    m_interval = std::max(1, m_packing.intervalMs);
+    m_maxBytes = std::max(64, m_packing.maxDatagramBytes);
+    m_copies = std::clamp(m_packing.copies, 1, 8);
+    m_datagram.clear();
+    m_datagram.reserve(std::max(2048, m_maxBytes));
+    m_inDatagram = 0;
+    m_bucket = -1;
+
+    m_first = m_source->firstTimestamp();
+    m_loopShift = 0;
+    m_lastVt = m_first;
+    m_lastGap = 1;
+    m_sentAny = false;
+    m_loops = 0;
+    m_source->rewind();
+    m_have = m_source->next(m_packet);
+    return m_have;
+}
+
+
+
+void ReplayStream::close(bool sendPending)
+{
+    if (sendPending) flush();
+    m_datagram.clear();
+    m_inDatagram = 0;
+    m_socket.reset();
+    m_have = false;
+}
+
+
+
+/**
+ * @return Tiempo del flujo (ms desde el primer paquete) del envío del paquete actual; con
+ * empaquetado, el final de su intervalo, que es cuando el firmware envía el datagrama.
+ */
+qint64 ReplayStream::dueMs() const
+{
+    const qint64 vt = m_packet.deviceMs + m_loopShift;
+    if (!m_packingOn) return vt - m_first;
+    return std::max(vt, m_first + (bucketOf(vt) + 1) * m_interval) - m_first;
+}
+
+
+
+/**
+ * @brief Escribe la marca nueva delante del resto de la línea, lo añade al datagrama y avanza.
+ *
+ * Es el único campo que se toca: el resto se copia tal cual de la fuente al búfer de envío,
+ * que se reutiliza entre datagramas. El datagrama sale en cuanto el siguiente paquete es de otro intervalo (o no cabe), así que
+ * se envía en el instante de dueMs() del último paquete que contiene.
+ */
+void ReplayStream::sendCurrent(bool loop)
+{
+    if (!m_have) return;
+    const qint64 vt = m_packet.deviceMs + m_loopShift;
+    char digits[24];
+    const char *stamp = formatStamp(m_timestampBase + vt - m_first, digits + sizeof(digits));
+    const int stampSize = int(digits + sizeof(digits) - stamp);
+    if (m_packingOn && m_inDatagram > 0 && m_datagram.size() + stampSize + m_packet.restSize + 1 > m_maxBytes)
+        flush();
+    m_datagram.append(stamp, stampSize);
+    m_datagram.append(m_packet.rest, m_packet.restSize);
+    m_datagram += '\n';
+    ++m_inDatagram;
+    m_bucket = bucketOf(vt);
+    if (m_counters) m_counters->positionMs.store(m_packet.deviceMs - m_first, std::memory_order_relaxed);
+
+    if (vt > m_lastVt) m_lastGap = vt - m_lastVt;
+    m_lastVt = vt;
+    m_sentAny = true;
+    advance(loop);
+
+    if (!m_packingOn || !m_have || bucketOf(m_packet.deviceMs + m_loopShift) != m_bucket)
+        flush();
+}
+
+
+
+/**
+ * @brief Salta en el contenido de la grabación; el tiempo del flujo y las marcas siguen creciendo.
+ * @param offsetMs Desplazamiento desde el primer paquete.
+ */
+void ReplayStream::seek(qint64 offsetMs)
+{
+    if (!m_source) return;
+    flush();
+    m_have = m_source->seek(offsetMs, m_packet);
+    if (m_have && m_sentAny) m_loopShift = m_lastVt + m_lastGap - m_packet.deviceMs;
+}
+
+
+
+bool ReplayStream::takeLooped()
+{
+    const bool looped = m_looped;
+    m_looped = false;
+    return looped;
+}
+
+
+
+QString ReplayStream::takeError()
+{
+    if (m_error.isEmpty() || m_errorReported) return QString();
+    m_errorReported = true;
+    return m_error;
+}
+
+
+
+// Siguiente paquete; al final, con bucle, la vuelta siguiente empieza un intervalo típico después del último
+void ReplayStream::advance(bool loop)
+{
+    m_have = m_source->next(m_packet);
+    if (m_have || !loop) return;
+    m_source->rewind();
+    m_have = m_source->next(m_packet);
+    if (!m_have) return;
+    m_loopShift = m_lastVt + m_lastGap - m_packet.deviceMs;
+    ++m_loops;
+    m_looped = true;
+}
+
+
+
+void ReplayStream::flush()
+{
+    if (m_inDatagram == 0 || !m_socket) return;
+    bool ok = true;
+    for (int c = 0; c < m_copies; ++c) {
+        if (m_socket->writeDatagram(m_datagram, m_address, m_port) < 0) {
+            ok = false;
+            if (m_error.isEmpty()) m_error = QString("%1: error al enviar datos: %2").arg(m_name, m_socket->errorString());
+            if (m_counters) m_counters->errors.fetch_add(1, std::memory_order_relaxed);
+            if (m_totals) m_totals->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    for (ReplayCounters *c : { m_counters.get(), m_totals }) {
+        if (!c) continue;
+        c->datagrams.fetch_add(1, std::memory_order_relaxed);
+        if (ok) c->packets.fetch_add(quint64(m_inDatagram), std::memory_order_relaxed);
+    }
+    m_datagram.resize(0);   // conserva la reserva
+    m_inDatagram = 0;
+}
@@ -0,0 +1,116 @@
+#ifndef REPLAYSTREAM_H
+#define REPLAYSTREAM_H
+
+#include <QHostAddress>
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "packetsource.h"
+
+class QUdpSocket;
+
+/**
+ * @brief Contadores de un flujo (o de todos los de un motor), legibles desde cualquier hilo.
+ */
+struct ReplayCounters {
+    std::atomic<quint64> packets {0};
+    std::atomic<quint64> datagrams {0};     // sin contar las copias del envío múltiple
+    std::atomic<quint64> errors {0};
+    std::atomic<qint64> positionMs {0};     // desplazamiento del último paquete en la grabación
+};
+
+/**
+ * @class ReplayStream
+ * @brief Reproducción de una fuente hacia un destino: el tráfico de un dispositivo virtual.
+ *
+ * Lleva el tiempo de la grabación y el envío; cuándo enviar lo decide ReplayEngine, que puede
+ * mover muchos flujos desde un mismo hilo. El tiempo del flujo (ms desde su primer paquete)
+ * continúa entre vueltas y saltos, y la marca enviada es base + ese tiempo.
+ *
+ * Por defecto cada paquete va en su propio datagrama. Con setPacking() se imita al firmware:
+ * los paquetes de un mismo intervalo de envío se juntan en datagramas de hasta
+ * maxDatagramBytes, separados por '\n', y cada datagrama se envía 'copies' veces (envío
+ * múltiple que el host descarta por el número del primer paquete).
+ *
+ * La configuración se hace antes de entregar el flujo al motor; desde entonces solo lo usa el
+ * hilo del motor (el socket se crea en ese hilo).
+ */
+class ReplayStream
+{
+public:
+    struct Packing {
+        int intervalMs = 0;            // intervalo de envío del firmware (0 = un paquete por datagrama)
+        int maxDatagramBytes = 1472;   // MTU Ethernet (1500) menos cabeceras IP y UDP
+        int copies = 1;                // veces que se envía cada datagrama
+
+        // Valores parecidos a los del firmware de EmotiBit
+        static Packing firmware() { return { 100, 1472, 2 }; }
+    };
+
+    ReplayStream(const QString &name, std::unique_ptr<PacketSource> source);
+    ~ReplayStream();
+
+    void setDestination(const QHostAddress &address, quint16 port);
+    void setLocal(const QHostAddress &address, quint16 port);   // puerto 0 = efímero
+    void setTimestampBase(qint64 ms) { m_timestampBase = ms; }
+    void setPacking(const Packing &packing) { m_packing = packing; }
+    void setCounters(std::shared_ptr<ReplayCounters> counters) { m_counters = std::move(counters); }
+    void setTotals(ReplayCounters *totals) { m_totals = totals; }
+
+    const QString &name() const { return m_name; }
+    PacketSource *source() const { return m_source.get(); }
+
+    // ---- Hilo del motor ----
+    bool open(QString *warning = nullptr);
+    void close(bool sendPending);
+
+    bool atEnd() const { return !m_have; }
+    qint64 dueMs() const;                  // tiempo del flujo en que toca enviar el paquete actual
+    void sendCurrent(bool loop);           // envía o acumula el paquete actual y avanza
+    void seek(qint64 offsetMs);
+
+    bool takeLooped();                     // true una vez tras cada vuelta
+    int loops() const { return m_loops; }
+    QString takeError();                   // primer error aún no notificado
+
+private:
+    void advance(bool loop);
+    void flush();
+    qint64 bucketOf(qint64 vt) const { return (vt - m_first) / m_interval; }
+
+    QString m_name;
+    std::unique_ptr<PacketSource> m_source;
+    QHostAddress m_address;
+    quint16 m_port = 0;
+    QHostAddress m_localAddress = QHostAddress::AnyIPv4;
+    quint16 m_localPort = 0;
+    qint64 m_timestampBase = 0;
+    Packing m_packing;
+    std::shared_ptr<ReplayCounters> m_counters;
+    ReplayCounters *m_totals = nullptr;
+
+    std::unique_ptr<QUdpSocket> m_socket;
+    ReplayPacket m_packet;
+    bool m_have = false;
+    qint64 m_first = 0;
+    qint64 m_loopShift = 0;      // ms añadidos por las vueltas y los saltos
+    qint64 m_lastVt = 0;
+    qint64 m_lastGap = 1;
+    bool m_sentAny = false;
+    int m_loops = 0;
+    bool m_looped = false;
+
+    bool m_packingOn = false;
+    qint64 m_interval = 1;
+    int m_maxBytes = 1472;
+    int m_copies = 1;
+    QByteArray m_datagram;
+    int m_inDatagram = 0;
+    qint64 m_bucket = -1;
+
+    QString m_error;
+    bool m_errorReported = false;
+};
+
+#endif // REPLAYSTREAM_H
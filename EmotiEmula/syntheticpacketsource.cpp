@@ -0,0 +1,124 @@
+#include "syntheticpacketsource.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586;
+}
+
+SyntheticPacketSource::SyntheticPacketSource(quint32 seed, qint64 durationMs)
+    : m_seed(seed),
+    m_durationMs(durationMs),
+    m_random(seed)
+{
+}
+
+
+
+bool SyntheticPacketSource::open(QString *error)
+{
+    Q_UNUSED(error);
+    std::mt19937 random(m_seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double pulseMs = 700.0 + 400.0 * unit(random);     // entre 55 y 85 ppm
+    const double breathMs = 3500.0 + 2000.0 * unit(random);
+
+    // Frecuencias como las del host (EmotiDash) y paquetes de unos 100 ms
+    m_channels = {
+        { "EA", 15.0, 2, 0.4 + unit(random), 0.05, 20000.0 + 10000.0 * unit(random), 0, 0 },
+        { "EL", 15.0, 2, 0.4 + unit(random), 0.03, 30000.0, 0, 0 },
+        { "PI", 25.0, 3, 120000.0, 2000.0, pulseMs, 0, 0 },
+        { "PR", 25.0, 3, 90000.0, 1500.0, pulseMs, 0, 0 },
+        { "PG", 25.0, 3, 5000.0, 300.0, pulseMs, 0, 0 },
+        { "AX", 25.0, 3, 0.0, 0.05, breathMs, 0, 0 },
+        { "AY", 25.0, 3, 0.0, 0.05, breathMs, 0, 0 },
+        { "AZ", 25.0, 3, 1.0, 0.02, breathMs, 0, 0 },
+        { "GX", 25.0, 3, 0.0, 2.0, breathMs, 0, 0 },
+        { "GY", 25.0, 3, 0.0, 2.0, breathMs, 0, 0 },
+        { "GZ", 25.0, 3, 0.0, 2.0, breathMs, 0, 0 },
+        { "MX", 25.0, 3, 30.0, 2.0, 60000.0, 0, 0 },
+        { "MY", 25.0, 3, -10.0, 2.0, 60000.0, 0, 0 },
+        { "MZ", 25.0, 3, 40.0, 2.0, 60000.0, 0, 0 },
+        { "T1", 7.5, 1, 32.0 + unit(random), 0.2, 120000.0, 0, 0 },
+        { "TH", 7.5, 1, 31.5 + unit(random), 0.2, 120000.0, 0, 0 },
+    };
+    for (Channel &c : m_channels) c.phase = kTwoPi * unit(random);
+
+    m_packetNumber = 0;
+    m_line.reserve(128);
+    rewind();
+    return true;
+}
+
+
+
+void SyntheticPacketSource::close()
+{
+    m_channels.clear();
+}
+
+
+
+void SyntheticPacketSource::rewind()
+{
+    m_random.seed(m_seed);
+    for (Channel &c : m_channels) c.nextMs = 0.0;
+}
+
+
+
+/**
+ * @brief Paquete del canal que antes toca, con samplesPerPacket muestras.
+ *
+ * El número de paquete sigue creciendo entre vueltas, como en un dispositivo que no se reinicia.
+ */
+bool SyntheticPacketSource::next(ReplayPacket &packet)
+{
+    Channel *c = nullptr;
+    for (Channel &candidate : m_channels)
+        if (!c || candidate.nextMs < c->nextMs) c = &candidate;
+    if (!c || c->nextMs >= double(m_durationMs)) return false;
+
+    const double sampleMs = 1000.0 / c->rateHz;
+    m_line.clear();
+    m_line += ',';
+    m_line += QByteArray::number(++m_packetNumber);
+    m_line += ',';
+    m_line += QByteArray::number(c->samplesPerPacket);
+    m_line += ',';
+    m_line += c->tag;
+    m_line += ",1,100";
+    for (int k = 0; k < c->samplesPerPacket; ++k) {
+        const double t = c->nextMs + k * sampleMs;
+        const double value = c->base + c->amplitude * (std::sin(kTwoPi * t / c->periodMs + c->phase)
+                                                       + 0.05 * m_noise(m_random));
+        m_line += ',';
+        m_line += QByteArray::number(value, 'f', 4);
+    }
+
+    packet.deviceMs = qint64(c->nextMs);
+    packet.rest = m_line.constData();
+    packet.restSize = int(m_line.size());
+    c->nextMs += c->samplesPerPacket * sampleMs;
+    return true;
+}
+
+
+
+QString SyntheticPacketSource::describe() const
+{
+    return QString("señal sintética (semilla %1, %2 canales, %3 s)")
+        .arg(m_seed).arg(m_channels.size()).arg(m_durationMs / 1000);
+}
+
+
+
+// Sin recorrer: cada canal se coloca en su primer paquete a offsetMs o más
+bool SyntheticPacketSource::seek(qint64 offsetMs, ReplayPacket &packet)
+{
+    for (Channel &c : m_channels) {
+        const double packetMs = c.samplesPerPacket * 1000.0 / c.rateHz;
+        c.nextMs = std::ceil(std::max<qint64>(0, offsetMs) / packetMs) * packetMs;
+    }
+    return next(packet);
+}
@@ -0,0 +1,51 @@
+#ifndef SYNTHETICPACKETSOURCE_H
+#define SYNTHETICPACKETSOURCE_H
+
+#include <QByteArray>
+#include <QVector>
+#include <random>
+#include "packetsource.h"
+
+/**
+ * @class SyntheticPacketSource
+ * @brief Genera paquetes de EmotiBit sin archivo: EDA, PPG, IMU y temperatura a sus frecuencias.
+ *
+ * Cada canal es una onda (pulso, respiración, deriva térmica...) con ruido; la semilla cambia
+ * fases, pulso y ruido, de modo que cada dispositivo virtual de una flota envía una señal
+ * distinta. Las marcas empiezan en 0 y la fuente termina a los durationMs.
+ */
+class SyntheticPacketSource : public PacketSource
+{
+public:
+    explicit SyntheticPacketSource(quint32 seed, qint64 durationMs = 10 * 60 * 1000);
+
+    bool open(QString *error = nullptr) override;
+    void close() override;
+    void rewind() override;
+    bool next(ReplayPacket &packet) override;
+    qint64 firstTimestamp() const override { return 0; }
+    QString describe() const override;
+    bool seek(qint64 offsetMs, ReplayPacket &packet) override;
+
+private:
+    struct Channel {
+        const char *tag;
+        double rateHz;
+        int samplesPerPacket;
+        double base;
+        double amplitude;
+        double periodMs;
+        double phase;
+        double nextMs;          // marca del siguiente paquete
+    };
+
+    quint32 m_seed;
+    qint64 m_durationMs;
+    QVector<Channel> m_channels;
+    std::mt19937 m_random;
+    std::normal_distribution<double> m_noise {0.0, 1.0};
+    quint32 m_packetNumber = 0;
+    QByteArray m_line;
+};
+
+#endif // SYNTHETICPACKETSOURCE_H
@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QMap>
+#include <QSet>
 
 class ChannelFrequencies {
 public:
@@ -18,8 +19,12 @@ public:
     // para obtener todas las frecuencias
     QMap<QString, double> getAllFrequencies() const;
 
+    // para saber si un canal es de eventos (sin frecuencia fija)
+    bool isEventChannel(const QString& channel) const;
+
 private:
     QMap<QString, double> channelFrequencies;
+    QSet<QString> eventChannels;
 };
 
 #endif
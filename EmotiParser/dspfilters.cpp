@@ -0,0 +1,108 @@
+/****************************************************************************
+ * DspFilters.cpp
+ *
+ * Descripción: Filtros IIR básicos para el procesado en línea de las
+ * señales: paso bajo de un polo y secciones bicuadráticas con las fórmulas
+ * de Robert Bristow-Johnson (Audio EQ Cookbook).
+ *
+ * Fecha: 2025-05-24
+ ****************************************************************************/
+
+#include "dspfilters.h"
+#include <cmath>
+
+namespace {
+const double kPi = 3.14159265358979323846;
+}
+
+
+
+/**
+ * @param cutoffHz Frecuencia de corte (-3 dB).
+ * @param sampleHz Frecuencia de muestreo.
+ */
+void OnePole::setCutoff(double cutoffHz, double sampleHz){
+    if (cutoffHz <= 0.0 || sampleHz <= 0.0) { m_a = 1.0; return; }
+    m_a = 1.0 - std::exp(-2.0 * kPi * cutoffHz / sampleHz);
+}
+
+
+
+/**
+ * @param tauSeconds Constante de tiempo (63 % de la respuesta al escalón).
+ * @param sampleHz Frecuencia de muestreo.
+ */
+void OnePole::setTimeConstant(double tauSeconds, double sampleHz){
+    if (tauSeconds <= 0.0 || sampleHz <= 0.0) { m_a = 1.0; return; }
+    m_a = 1.0 - std::exp(-1.0 / (tauSeconds * sampleHz));
+}
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//      Biquad
+// ---------------------------------------------------------------------------
+
+Biquad Biquad::fromRbj(double b0, double b1, double b2, double a0, double a1, double a2){
+    Biquad f;
+    f.m_b0 = b0 / a0;
+    f.m_b1 = b1 / a0;
+    f.m_b2 = b2 / a0;
+    f.m_a1 = a1 / a0;
+    f.m_a2 = a2 / a0;
+    return f;
+}
+
+
+
+Biquad Biquad::lowPass(double cutoffHz, double sampleHz, double q){
+    const double w0 = 2.0 * kPi * cutoffHz / sampleHz;
+    const double cw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    return fromRbj((1.0 - cw) / 2.0, 1.0 - cw, (1.0 - cw) / 2.0,
+                   1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+}
+
+
+
+Biquad Biquad::highPass(double cutoffHz, double sampleHz, double q){
+    const double w0 = 2.0 * kPi * cutoffHz / sampleHz;
+    const double cw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    return fromRbj((1.0 + cw) / 2.0, -(1.0 + cw), (1.0 + cw) / 2.0,
+                   1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+}
+
+
+
+// Paso banda con ganancia 0 dB en la frecuencia central
+Biquad Biquad::bandPass(double centerHz, double sampleHz, double q){
+    const double w0 = 2.0 * kPi * centerHz / sampleHz;
+    const double cw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    return fromRbj(alpha, 0.0, -alpha,
+                   1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+}
+
+
+
+// Ganancia en continua: H(1) = (b0 + b1 + b2) / (1 + a1 + a2)
+double Biquad::dcGain() const {
+    const double den = 1.0 + m_a1 + m_a2;
+    return den != 0.0 ? (m_b0 + m_b1 + m_b2) / den : 0.0;
+}
+
+
+
+/**
+ * Coloca el estado en régimen permanente para una entrada constante x.
+ *
+ * @param x Valor de entrada supuesto antes de la primera muestra.
+ */
+void Biquad::reset(double x){
+    const double y = dcGain() * x;
+    m_z2 = m_b2 * x - m_a2 * y;
+    m_z1 = m_b1 * x - m_a1 * y + m_z2;
+}
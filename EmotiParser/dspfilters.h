@@ -0,0 +1,89 @@
+/**
+*  file DspFilters.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef DSPFILTERS_H
+#define DSPFILTERS_H
+
+/*!
+ * \class OnePole
+ * \brief Filtro paso bajo de un polo: y += a·(x − y). Una multiplicación por muestra.
+ *
+ * Se configura por frecuencia de corte o por constante de tiempo. Sirve para seguir líneas
+ * base lentas (nivel tónico de EDA) y para suavizar indicadores.
+ *
+ * \see Biquad, EdaAnalyzer
+ * \author Enrique Fuentes
+ * \date 2025-05-24
+ */
+class OnePole {
+public:
+    void setCutoff(double cutoffHz, double sampleHz);
+    void setTimeConstant(double tauSeconds, double sampleHz);
+    void reset(double value) { m_y = value; m_primed = true; }
+    bool isPrimed() const { return m_primed; }
+    double value() const { return m_y; }
+
+    double process(double x){
+        if (!m_primed) reset(x);
+        m_y += m_a * (x - m_y);
+        return m_y;
+    }
+
+private:
+    double m_a = 1.0;
+    double m_y = 0.0;
+    bool m_primed = false;
+};
+
+
+
+/*!
+ * \class Biquad
+ * \brief Sección bicuadrática (forma directa II transpuesta) con diseños RBJ.
+ *
+ * Coste fijo de cinco multiplicaciones por muestra y dos valores de estado. reset(x) coloca el
+ * estado en régimen permanente para una entrada constante x y evita el transitorio inicial.
+ *
+ * \see OnePole
+ * \author Enrique Fuentes
+ * \date 2025-05-24
+ */
+class Biquad {
+public:
+    static Biquad lowPass(double cutoffHz, double sampleHz, double q = 0.70710678);
+    static Biquad highPass(double cutoffHz, double sampleHz, double q = 0.70710678);
+    static Biquad bandPass(double centerHz, double sampleHz, double q);
+
+    void reset(double x = 0.0);
+    double dcGain() const;
+
+    double process(double x){
+        const double y = m_b0 * x + m_z1;
+        m_z1 = m_b1 * x - m_a1 * y + m_z2;
+        m_z2 = m_b2 * x - m_a2 * y;
+        return y;
+    }
+
+private:
+    static Biquad fromRbj(double b0, double b1, double b2, double a0, double a1, double a2);
+
+    double m_b0 = 1.0, m_b1 = 0.0, m_b2 = 0.0;
+    double m_a1 = 0.0, m_a2 = 0.0;
+    double m_z1 = 0.0, m_z2 = 0.0;
+};
+
+#endif // DSPFILTERS_H
@@ -10,16 +10,22 @@ CONFIG += c++17
 
 SOURCES += \
     channelfrequencies.cpp \
+    dspfilters.cpp \
     main.cpp \
     mainwindow.cpp \
+    multirateresampler.cpp \
     qemotibirparser.cpp \
-    qemotibitpacket.cpp
+    qemotibitpacket.cpp \
+    rateestimator.cpp
 
 HEADERS += \
     channelfrequencies.h \
+    dspfilters.h \
     mainwindow.h \
+    multirateresampler.h \
     qemotibirparser.h \
-    qemotibitpacket.h
+    qemotibitpacket.h \
+    rateestimator.h
 
 FORMS += \
     mainwindow.ui
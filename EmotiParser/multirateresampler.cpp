@@ -0,0 +1,191 @@
+/****************************************************************************
+ * MultiRateResampler.cpp
+ *
+ * Descripción: Remuestreo en streaming de canales de distinta frecuencia
+ * (y de canales de eventos) a tramas alineadas en una rejilla común.
+ *
+ * Fecha: 2025-05-29
+ ****************************************************************************/
+
+#include "multirateresampler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MultiRateResampler::MultiRateResampler()
+    : MultiRateResampler(Settings())
+{
+}
+
+MultiRateResampler::MultiRateResampler(const Settings &settings)
+{
+    setSettings(settings);
+}
+
+
+
+/**
+ * Cambia la frecuencia de salida o la latencia máxima. Reinicia la rejilla y los filtros.
+ */
+void MultiRateResampler::setSettings(const Settings &settings){
+    m_settings = settings;
+    if (m_settings.outputHz <= 0.0) m_settings.outputHz = 1.0;
+    for (Channel &c : m_channels)
+        configureFilter(c);
+    reset();
+}
+
+
+
+/**
+ * Declara un canal. El orden de declaración es el orden de las columnas.
+ *
+ * @param channelID Identificador del canal.
+ * @param inputHz Frecuencia nominal de entrada (0 para canales de eventos).
+ * @param mode Linear para señales continuas, Hold para eventos.
+ */
+void MultiRateResampler::addChannel(const QString &channelID, double inputHz, Mode mode){
+    if (m_index.contains(channelID)) return;
+
+    Channel c;
+    c.mode = mode;
+    c.inputHz = inputHz;
+    configureFilter(c);
+
+    m_index.insert(channelID, int(m_channels.size()));
+    m_channels.push_back(std::move(c));
+    m_frames.channels << channelID;
+    m_frames.clear();
+}
+
+
+
+void MultiRateResampler::reset(){
+    for (Channel &c : m_channels) {
+        c.t.clear();
+        c.v.clear();
+        c.primed = false;
+        c.hasData = false;
+        c.lastT = 0;
+    }
+    m_started = false;
+    m_originUs = 0;
+    m_nextFrame = 0;
+    m_newestUs = 0;
+    m_frames.clear();
+}
+
+
+
+/**
+ * Añade muestras de un canal y deja en frames() las tramas que han quedado completas.
+ * Las muestras que retroceden en el tiempo se descartan.
+ */
+void MultiRateResampler::addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n){
+    m_frames.clear();
+    auto it = m_index.constFind(channelID);
+    if (it == m_index.constEnd() || n <= 0) return;
+
+    Channel &c = m_channels[size_t(it.value())];
+    for (int i = 0; i < n; ++i) {
+        if (c.hasData && tUs[i] < c.lastT) continue;
+
+        double x = values[i];
+        if (c.filtered) {
+            if (!c.primed) { c.filter.reset(x); c.primed = true; }
+            x = c.filter.process(x);
+        }
+        c.t.push_back(tUs[i]);
+        c.v.push_back(float(x));
+        c.lastT = tUs[i];
+        c.hasData = true;
+
+        if (!m_started) {
+            m_started = true;
+            m_originUs = tUs[i];
+            m_nextFrame = 0;
+            m_newestUs = tUs[i];
+        }
+        m_newestUs = std::max(m_newestUs, tUs[i]);
+    }
+
+    emitFrames(false);
+}
+
+
+
+void MultiRateResampler::finish(){
+    m_frames.clear();
+    if (m_started)
+        emitFrames(true);
+}
+
+
+
+// Antialias solo si el canal es claramente más rápido que la salida
+void MultiRateResampler::configureFilter(Channel &c) const {
+    c.filtered = m_settings.antiAlias && c.mode == Mode::Linear
+                 && c.inputHz > m_settings.outputHz * 1.25;
+    if (c.filtered)
+        c.filter = Biquad::lowPass(0.4 * m_settings.outputHz, c.inputHz);
+    c.primed = false;
+}
+
+
+
+qint64 MultiRateResampler::frameTime(qint64 k) const {
+    return m_originUs + qint64(std::llround(double(k) * 1e6 / m_settings.outputHz));
+}
+
+
+
+// Una trama está lista cuando todos los canales continuos la han superado o cuando el
+// canal más adelantado va maxLatencySeconds por delante
+bool MultiRateResampler::frameReady(qint64 tUs, qint64 newestUs) const {
+    bool allPast = true;
+    for (const Channel &c : m_channels) {
+        if (c.mode == Mode::Linear && (!c.hasData || c.lastT < tUs)) {
+            allPast = false;
+            break;
+        }
+    }
+    if (allPast) return true;
+
+    return m_settings.maxLatencySeconds > 0.0
+           && newestUs - tUs > qint64(m_settings.maxLatencySeconds * 1e6);
+}
+
+
+
+void MultiRateResampler::emitFrames(bool flush){
+    const int columns = int(m_channels.size());
+    forever {
+        const qint64 t = frameTime(m_nextFrame);
+        if (flush ? t > m_newestUs : !frameReady(t, m_newestUs))
+            break;
+
+        m_frames.t.push_back(t);
+        for (int i = 0; i < columns; ++i)
+            m_frames.values.push_back(valueAt(m_channels[size_t(i)], t));
+        ++m_nextFrame;
+    }
+}
+
+
+
+// Valor del canal en el instante t; descarta las muestras que ya no harán falta
+float MultiRateResampler::valueAt(Channel &c, qint64 tUs) const {
+    while (c.t.size() >= 2 && c.t[1] <= tUs) {
+        c.t.pop_front();
+        c.v.pop_front();
+    }
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    if (c.t.empty() || c.t.front() > tUs) return nan;
+    if (c.mode == Mode::Hold || c.t.size() == 1) return c.v.front();
+
+    const qint64 t0 = c.t[0], t1 = c.t[1];
+    if (t1 == t0) return c.v[1];
+    const double a = double(tUs - t0) / double(t1 - t0);
+    return float(c.v[0] + a * (c.v[1] - c.v[0]));
+}
@@ -0,0 +1,129 @@
+/**
+*  file MultiRateResampler.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef MULTIRATERESAMPLER_H
+#define MULTIRATERESAMPLER_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <deque>
+#include <vector>
+#include "dspfilters.h"
+
+/// Tabla ancha de tramas alineadas: una fila por instante y una columna por canal.
+struct AlignedFrames {
+    QStringList channels;
+    std::vector<qint64> t;          // µs
+    std::vector<float>  values;     // t.size() × channels.size(), fila a fila; NaN = sin dato
+
+    int frameCount() const { return int(t.size()); }
+    const float *frame(int i) const { return values.data() + size_t(i) * size_t(channels.size()); }
+    void clear() { t.clear(); values.clear(); }
+};
+
+
+
+/*!
+ * \class MultiRateResampler
+ * \brief Remuestreo en streaming de varios canales a una base de tiempos común.
+ *
+ * Los canales llegan a 25 Hz (IMU, PPG), 15 Hz (EDA), 7,5 Hz (temperatura) o por eventos
+ * (HR, BI, SCR). El remuestreador produce tramas a outputHz con un valor por canal:
+ * - canales continuos: interpolación lineal entre las dos muestras que rodean el instante,
+ *   con un paso bajo antialias previo (Butterworth de orden 2 a 0,4·outputHz) cuando el canal
+ *   es más rápido que la salida;
+ * - canales de eventos: retención del último valor recibido (NaN antes del primero).
+ *
+ * Una trama se emite en cuanto todos los canales continuos tienen una muestra posterior a ella,
+ * es decir, al ritmo del canal más lento. Si un canal se retrasa o deja de llegar, la trama se
+ * emite igualmente cuando el canal más adelantado la supera en maxLatencySeconds, manteniendo el
+ * último valor del canal retrasado. Con maxLatencySeconds <= 0 no hay límite (uso offline) y las
+ * tramas pendientes se vacían con finish().
+ *
+ * Se elige interpolación lineal en lugar de un banco polifásico porque los tiempos de entrada
+ * no son una rejilla exacta: vienen de RateEstimator y de paquetes con jitter.
+ *
+ * \see RateEstimator, EmotiBitController
+ * \author Enrique Fuentes
+ * \date 2025-05-29
+ */
+class MultiRateResampler {
+public:
+    enum class Mode { Linear, Hold };
+
+    struct Settings {
+        double outputHz          = 25.0;
+        double maxLatencySeconds = 2.0;    // <= 0: sin límite
+        bool   antiAlias         = true;
+    };
+
+    MultiRateResampler();
+    explicit MultiRateResampler(const Settings &settings);
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+
+    // Declara un canal (columna); inputHz se usa para decidir el filtro antialias
+    void addChannel(const QString &channelID, double inputHz, Mode mode);
+    QStringList channels() const { return m_frames.channels; }
+    bool hasChannel(const QString &channelID) const { return m_index.contains(channelID); }
+
+    // Borra los datos pendientes y reinicia la rejilla de salida (mantiene los canales)
+    void reset();
+
+    // Añade muestras de un canal (tiempos en µs, crecientes) y emite las tramas completas
+    void addSamples(const QString &channelID, const qint64 *tUs, const float *values, int n);
+
+    // Emite todas las tramas hasta la última muestra recibida (fin de un archivo)
+    void finish();
+
+    // Tramas emitidas en la última llamada a addSamples() o finish()
+    const AlignedFrames &frames() const { return m_frames; }
+
+private:
+    struct Channel {
+        Mode mode = Mode::Linear;
+        double inputHz = 0.0;
+        bool filtered = false;
+        Biquad filter;
+        bool primed = false;
+        std::deque<qint64> t;
+        std::deque<float>  v;
+        qint64 lastT = 0;
+        bool hasData = false;
+    };
+
+    void configureFilter(Channel &c) const;
+    qint64 frameTime(qint64 k) const;
+    bool frameReady(qint64 tUs, qint64 newestUs) const;
+    void emitFrames(bool flush);
+    float valueAt(Channel &c, qint64 tUs) const;
+
+    Settings m_settings;
+    std::vector<Channel> m_channels;
+    QHash<QString, int> m_index;
+
+    bool m_started = false;
+    qint64 m_originUs = 0;       // instante de la trama 0
+    qint64 m_nextFrame = 0;      // índice de la siguiente trama
+    qint64 m_newestUs = 0;       // muestra más reciente de cualquier canal
+    AlignedFrames m_frames;
+};
+
+#endif // MULTIRATERESAMPLER_H
@@ -1,4 +1,5 @@
 #include "qemotibirparser.h"
+#include "multirateresampler.h"
 
 
 #include <QFile>
@@ -7,6 +8,7 @@
 #include <QDebug>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <cmath>
 
 qemotibirparser::qemotibirparser() {}
 
@@ -38,6 +40,7 @@ QStringList qemotibirparser::loadCsvFile(const QString &filePath)
     };
 
     QMap<QString, QVector<Sample>> channelData;
+    QMap<QString, RateEstimator> rates;   // frecuencia real estimada por canal
 
     while (!in.atEnd()) {
         QString line = in.readLine().trimmed();
@@ -68,7 +71,10 @@ QStringList qemotibirparser::loadCsvFile(const QString &filePath)
         double freq = freqMap[channelID];
         if (freq <= 0.0) continue;
 
-        double sampleInterval = 1.0 / freq;
+        // Intervalo entre muestras según la frecuencia real estimada del canal
+        if (!rates.contains(channelID))
+            rates.insert(channelID, RateEstimator(freq, channelFreq.isEventChannel(channelID)));
+        double sampleInterval = rates[channelID].update(timestamp, numSamples);
 
         for (int i = 0; i < numSamples; ++i) {
             bool ok;
@@ -83,7 +89,7 @@ QStringList qemotibirparser::loadCsvFile(const QString &filePath)
     file.close();
 
     for (auto it = channelData.begin(); it != channelData.end(); ++it) {
-        QVector<Sample> samples = it.value();
+        QVector<Sample> &samples = it.value();
         std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) {
             return a.time < b.time;
         });
@@ -107,5 +113,63 @@ QStringList qemotibirparser::loadCsvFile(const QString &filePath)
         archivosGenerados << outFileName;
     }
 
+    // Tabla ancha con todos los canales alineados a la frecuencia del canal continuo más rápido
+    double alignedHz = 0.0;
+    for (auto it = channelData.cbegin(); it != channelData.cend(); ++it)
+        if (!channelFreq.isEventChannel(it.key()))
+            alignedHz = std::max(alignedHz, freqMap.value(it.key()));
+    if (alignedHz <= 0.0) return archivosGenerados;
+
+    MultiRateResampler::Settings alignSettings;
+    alignSettings.outputHz = alignedHz;
+    alignSettings.maxLatencySeconds = 0.0;   // archivo completo: sin límite de latencia
+    MultiRateResampler resampler(alignSettings);
+    for (auto it = channelData.cbegin(); it != channelData.cend(); ++it) {
+        const bool isEvent = channelFreq.isEventChannel(it.key());
+        resampler.addChannel(it.key(), freqMap.value(it.key()),
+                             isEvent ? MultiRateResampler::Mode::Hold : MultiRateResampler::Mode::Linear);
+    }
+
+    QString alignedFileName = QString("%1/%2_ALIGNED.CSV").arg(dir, baseName);
+    QFile alignedFile(alignedFileName);
+    if (!alignedFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "No se pudo escribir el archivo:" << alignedFileName;
+        return archivosGenerados;
+    }
+
+    QTextStream alignedStream(&alignedFile);
+    alignedStream << "time," << resampler.channels().join(',') << "\n";
+
+    auto writeFrames = [&]() {
+        const AlignedFrames &frames = resampler.frames();
+        for (int f = 0; f < frames.frameCount(); ++f) {
+            alignedStream << QString::number(frames.t[f] / 1e6, 'f', 6);
+            const float *row = frames.frame(f);
+            for (int c = 0; c < frames.channels.size(); ++c) {
+                alignedStream << ',';
+                if (!std::isnan(row[c])) alignedStream << QString::number(row[c], 'f', 6);
+            }
+            alignedStream << "\n";
+        }
+    };
+
+    std::vector<qint64> tUs;
+    std::vector<float> values;
+    for (auto it = channelData.cbegin(); it != channelData.cend(); ++it) {
+        tUs.clear();
+        values.clear();
+        for (const Sample &s : it.value()) {
+            tUs.push_back(qRound64(s.time * 1e6));
+            values.push_back(float(s.value));
+        }
+        resampler.addSamples(it.key(), tUs.data(), values.data(), int(values.size()));
+        writeFrames();
+    }
+    resampler.finish();
+    writeFrames();
+
+    alignedFile.close();
+    archivosGenerados << alignedFileName;
+
     return archivosGenerados;
 }
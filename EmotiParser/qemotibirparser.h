@@ -3,6 +3,7 @@
 
 #include <QString>
 #include "ChannelFrequencies.h"
+#include "rateestimator.h"
 
 class qemotibirparser
 {
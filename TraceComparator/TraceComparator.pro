@@ -11,14 +11,20 @@ CONFIG += c++17
 
 SOURCES += \
     channelfrequencies.cpp \
+    chartdecimation.cpp \
     emotibitparser.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    plotdecimator.cpp \
+    rateestimator.cpp
 
 HEADERS += \
     channelfrequencies.h \
+    chartdecimation.h \
     emotibitparser.h \
-    mainwindow.h
+    mainwindow.h \
+    plotdecimator.h \
+    rateestimator.h
 
 FORMS += \
     mainwindow.ui
@@ -37,6 +37,10 @@ ChannelFrequencies::ChannelFrequencies() {
     channelFrequencies["BI"] = 1; // este es calculado intervalo entre latidos
     channelFrequencies["BV"] = 1;
 
+    // Los canales calculados se emiten por eventos (latidos, respuestas EDA), no a frecuencia fija;
+    // la frecuencia indicada arriba es solo su tasa nominal de referencia
+    eventChannels = { "HR", "SR", "SF", "SA", "BI", "BV" };
+
 }
 
 // Obtiene la frecuencia de un canal específico
@@ -54,4 +58,7 @@ QMap<QString, double> ChannelFrequencies::getAllFrequencies() const {
     return channelFrequencies;
 }
 
-
+// Indica si el canal es de eventos (sin frecuencia fija)
+bool ChannelFrequencies::isEventChannel(const QString& channel) const {
+    return eventChannels.contains(channel);
+}
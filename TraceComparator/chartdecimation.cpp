@@ -0,0 +1,107 @@
+/****************************************************************************
+ * ChartDecimation.cpp
+ *
+ * Descripción: Enlaza las series de una QChartView con su diezmado por
+ * píxel y lo recalcula al hacer zoom o al cambiar el tamaño de la vista.
+ *
+ * Fecha: 2025-05-30
+ ****************************************************************************/
+
+#include "chartdecimation.h"
+#include <QEvent>
+#include <QTimer>
+#include <algorithm>
+
+ChartDecimation::ChartDecimation(QChartView *view, QObject *parent)
+    : QObject(parent), m_view(view)
+{
+    if (m_view)
+        m_view->installEventFilter(this);
+}
+
+
+
+void ChartDecimation::clear(){
+    if (m_axisConnection)
+        disconnect(m_axisConnection);
+    m_axisX = nullptr;
+    m_bindings.clear();
+}
+
+
+
+/**
+ * Registra una serie. Se carga ya diezmada sobre el rango completo de sus datos para que
+ * createDefaultAxes() calcule los ejes sin recorrer todas las muestras.
+ *
+ * @param series Serie de la gráfica (no se toma su propiedad).
+ * @param x Tiempos, crecientes.
+ * @param y Valores.
+ */
+void ChartDecimation::addSeries(QXYSeries *series, std::vector<double> x, std::vector<double> y){
+    Binding binding { series, PlotDecimator(m_mode) };
+    binding.decimator.setData(std::move(x), std::move(y));
+    if (binding.decimator.update(binding.decimator.firstX(), binding.decimator.lastX(), pixelWidth()))
+        series->replace(binding.decimator.points());
+    m_bindings.push_back(std::move(binding));
+}
+
+
+
+void ChartDecimation::attachAxis(QValueAxis *axisX){
+    if (m_axisConnection)
+        disconnect(m_axisConnection);
+    m_axisX = axisX;
+    if (axisX)
+        m_axisConnection = connect(axisX, &QValueAxis::rangeChanged, this, &ChartDecimation::refresh);
+    refresh();
+}
+
+
+
+void ChartDecimation::setMode(PlotDecimator::Mode mode){
+    m_mode = mode;
+    for (Binding &b : m_bindings)
+        b.decimator.setMode(mode);
+    refresh();
+}
+
+
+
+/**
+ * Recalcula los puntos de cada serie para el rango y el ancho actuales. Las series cuyo
+ * resultado no cambia no se tocan.
+ */
+void ChartDecimation::refresh(){
+    if (!m_axisX) return;
+    const double x0 = m_axisX->min();
+    const double x1 = m_axisX->max();
+    const int width = pixelWidth();
+
+    for (Binding &b : m_bindings) {
+        if (!b.series) continue;
+        if (b.decimator.update(x0, x1, width))
+            b.series->replace(b.decimator.points());
+    }
+}
+
+
+
+// Al redimensionar, el área de dibujo se recoloca después del evento: se recalcula a continuación
+bool ChartDecimation::eventFilter(QObject *watched, QEvent *event){
+    if (watched == m_view && event->type() == QEvent::Resize)
+        QTimer::singleShot(0, this, &ChartDecimation::refresh);
+    return QObject::eventFilter(watched, event);
+}
+
+
+
+int ChartDecimation::pixelWidth() const {
+    if (!m_view) return 1;
+    int width = 0;
+    if (m_view->chart())
+        width = int(m_view->chart()->plotArea().width());
+    if (width <= 0)
+        width = m_view->viewport()->width();
+    return std::max(1, width);
+}
@@ -0,0 +1,80 @@
+/**
+*  file ChartDecimation.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef CHARTDECIMATION_H
+#define CHARTDECIMATION_H
+
+#include <QObject>
+#include <QPointer>
+#include <QtCharts/QChartView>
+#include <QtCharts/QXYSeries>
+#include <QtCharts/QValueAxis>
+#include <vector>
+#include "plotdecimator.h"
+
+/*!
+ * \class ChartDecimation
+ * \brief Mantiene diezmadas las series de una QChartView según el rango X y el ancho visibles.
+ *
+ * Cada serie registrada guarda sus datos completos en un PlotDecimator y la QXYSeries recibe
+ * solo los puntos que caben en el ancho del área de dibujo. Al hacer zoom (cambia el rango del
+ * eje X) o al redimensionar la vista se recalcula; el resto de repintados no tocan los datos.
+ *
+ * \see PlotDecimator, MainWindow
+ * \author Enrique Fuentes
+ * \date 2025-05-30
+ */
+class ChartDecimation : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ChartDecimation(QChartView *view, QObject *parent = nullptr);
+
+    // Olvida las series anteriores (al cargar una gráfica nueva)
+    void clear();
+
+    // Registra una serie con sus datos completos (x creciente) y le carga la vista inicial
+    void addSeries(QXYSeries *series, std::vector<double> x, std::vector<double> y);
+
+    // Eje cuyo rango manda; se llama después de crear los ejes de la gráfica
+    void attachAxis(QValueAxis *axisX);
+
+    void setMode(PlotDecimator::Mode mode);
+
+public slots:
+    void refresh();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct Binding {
+        QPointer<QXYSeries> series;
+        PlotDecimator decimator;
+    };
+
+    int pixelWidth() const;
+
+    QChartView *m_view;
+    QPointer<QValueAxis> m_axisX;
+    QMetaObject::Connection m_axisConnection;
+    std::vector<Binding> m_bindings;
+    PlotDecimator::Mode m_mode = PlotDecimator::Mode::MinMax;
+};
+
+#endif // CHARTDECIMATION_H
@@ -23,6 +23,10 @@ QVector<Sample> EmotiBitParser::parseFile(const QString &filePath,
 
     QTextStream in(&file);
 
+    // Frecuencia real del canal, estimada a partir de sus propios paquetes
+    const double nominalFreq = channelFreq.getFrequency(channelID);
+    RateEstimator rate(nominalFreq, channelFreq.isEventChannel(channelID));
+
     while (!in.atEnd()) {
         QString line = in.readLine().trimmed();
         if (line.isEmpty()) continue;
@@ -43,12 +47,10 @@ QVector<Sample> EmotiBitParser::parseFile(const QString &filePath,
         if (dataFields.size() < numSamples)
             continue;
 
-        // Frecuencia del canal
-        double freq = channelFreq.getFrequency(channelID);
-        if (freq <= 0.0)
+        if (nominalFreq <= 0.0)
             continue;
 
-        double sampleInterval = 1.0 / freq;
+        double sampleInterval = rate.update(timestamp, numSamples);
 
         // Usar el referenceTimestamp en lugar de un initialTimestamp local
         double relativeTimeBase = double(timestamp - referenceTimestamp) / 1000.0;
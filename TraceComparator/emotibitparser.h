@@ -4,6 +4,7 @@
 #include <QVector>
 #include <QString>
 #include "ChannelFrequencies.h"
+#include "rateestimator.h"
 
 // Estructura para almacenar cada muestra
 struct Sample {
@@ -9,7 +9,9 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QAreaSeries>
 #include <QtCharts/QChart>
+#include <QtCharts/QValueAxis>
 #include "EmotiBitParser.h"
+#include "chartdecimation.h"
 #include <cmath>
 #include "ui_mainwindow.h"
 
@@ -23,6 +25,36 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->filePcBtn, &QPushButton::clicked, this, &MainWindow::onSelectPcFile);
     connect(ui->plotBtn, &QPushButton::clicked, this, &MainWindow::onPlot);
     connect(ui->calcCoincidenceBtn, &QPushButton::clicked, this, &MainWindow::onCalculateCoincidence);
+
+    // Las series se dibujan diezmadas al ancho de cada vista; zoom horizontal con el ratón
+    // (botón derecho para deshacer) y el diezmado se recalcula con el nuevo rango
+    decimationCombined = new ChartDecimation(ui->chartViewCombined, this);
+    decimationPc = new ChartDecimation(ui->chartViewPc, this);
+    decimationSd = new ChartDecimation(ui->chartViewSd, this);
+    for (QChartView *view : { ui->chartViewCombined, ui->chartViewPc, ui->chartViewSd })
+        view->setRubberBand(QChartView::HorizontalRubberBand);
+}
+
+
+
+// Separa las muestras en vectores de tiempos y valores para el diezmado
+static void splitSamples(const QVector<Sample> &samples, std::vector<double> &x, std::vector<double> &y){
+    x.clear();
+    y.clear();
+    x.reserve(samples.size());
+    y.reserve(samples.size());
+    for (const Sample &s : samples) {
+        x.push_back(s.time);
+        y.push_back(s.value);
+    }
+}
+
+
+
+// Eje X (de valores) de una gráfica ya configurada
+static QValueAxis *horizontalAxis(QChart *chart){
+    const auto axes = chart->axes(Qt::Horizontal);
+    return axes.isEmpty() ? nullptr : qobject_cast<QValueAxis *>(axes.first());
 }
 
 qint64 MainWindow::getEarliestTimestamp(const QString &filePath) {
@@ -90,12 +122,19 @@ void MainWindow::onPlot() {
         return;
     }
 
+    std::vector<double> pcX, pcY, sdX, sdY;
+    splitSamples(pcSamples, pcX, pcY);
+    splitSamples(sdSamples, sdX, sdY);
+
     // --- Gráfica combinada ---
+    decimationCombined->clear();
     auto *pcUpperSeries = new QLineSeries;
     auto *pcBaseline = new QLineSeries;
-    for (const Sample &s : pcSamples) {
-        pcUpperSeries->append(s.time, s.value);
-        pcBaseline->append(s.time, 0.0);
+    decimationCombined->addSeries(pcUpperSeries, pcX, pcY);
+    if (!pcSamples.isEmpty()) {
+        // la base es una recta: basta con sus extremos
+        pcBaseline->append(pcSamples.first().time, 0.0);
+        pcBaseline->append(pcSamples.last().time, 0.0);
     }
     auto *pcAreaSeries = new QAreaSeries(pcUpperSeries, pcBaseline);
     pcAreaSeries->setName("PC");
@@ -103,8 +142,7 @@ void MainWindow::onPlot() {
     pcAreaSeries->setBrush(areaBrush);
 
     auto *sdSeriesCombined = new QLineSeries;
-    for (const Sample &s : sdSamples)
-        sdSeriesCombined->append(s.time, s.value);
+    decimationCombined->addSeries(sdSeriesCombined, sdX, sdY);
     sdSeriesCombined->setName("SD");
 
     auto *chartCombined = new QChart;
@@ -114,30 +152,33 @@ void MainWindow::onPlot() {
     chartCombined->createDefaultAxes();
     chartCombined->legend()->setAlignment(Qt::AlignBottom);
     ui->chartViewCombined->setChart(chartCombined);
+    decimationCombined->attachAxis(horizontalAxis(chartCombined));
 
     // --- Gráfica PC sola ---
+    decimationPc->clear();
     auto *pcSeriesAlone = new QLineSeries;
     pcSeriesAlone->setName("PC");
-    for (const Sample &s : pcSamples)
-        pcSeriesAlone->append(s.time, s.value);
+    decimationPc->addSeries(pcSeriesAlone, std::move(pcX), std::move(pcY));
     auto *chartPc = new QChart;
     chartPc->setTitle(QString("Gráfica PC canal %1").arg(chan));
     chartPc->addSeries(pcSeriesAlone);
     chartPc->createDefaultAxes();
     chartPc->legend()->setAlignment(Qt::AlignBottom);
     ui->chartViewPc->setChart(chartPc);
+    decimationPc->attachAxis(horizontalAxis(chartPc));
 
     // --- Gráfica SD sola ---
+    decimationSd->clear();
     auto *sdSeriesAlone = new QLineSeries;
     sdSeriesAlone->setName("SD");
-    for (const Sample &s : sdSamples)
-        sdSeriesAlone->append(s.time, s.value);
+    decimationSd->addSeries(sdSeriesAlone, std::move(sdX), std::move(sdY));
     auto *chartSd = new QChart;
     chartSd->setTitle(QString("Gráfica SD canal %1").arg(chan));
     chartSd->addSeries(sdSeriesAlone);
     chartSd->createDefaultAxes();
     chartSd->legend()->setAlignment(Qt::AlignBottom);
     ui->chartViewSd->setChart(chartSd);
+    decimationSd->attachAxis(horizontalAxis(chartSd));
 }
 
 
@@ -9,6 +9,8 @@
 #include <QPushButton>
 #include <QLabel>
 
+class ChartDecimation;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -62,6 +64,11 @@ private:
 
     ChannelFrequencies channelFreq;  // Instancia con las frecuencias definidas
 
+    // Diezmado por píxel de las series de cada vista
+    ChartDecimation *decimationCombined = nullptr;
+    ChartDecimation *decimationPc = nullptr;
+    ChartDecimation *decimationSd = nullptr;
+
     qint64 pcEarliestTimestamp = -1;   // Se fijará al seleccionar el archivo PC
 
 };
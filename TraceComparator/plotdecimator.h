@@ -0,0 +1,79 @@
+/**
+*  file PlotDecimator.h
+* @author Enrique
+* @date Mayo 2025
+*
+* @details
+* Proyecto desarrollado en C++ con Qt 6.7.2 para la UNED.
+*
+* - Framework: Qt (módulos: Network, Widgets, Core, etc.)
+* - Compilador: MSVC / MinGW (según configuración)
+* - Entorno: Windows 10/11
+* - Herramientas de documentación: Doxygen, Graphviz
+* - Licencia: MIT (si corresponde)
+*
+* @note Este proyecto forma parte del Trabajo de Fin de Grado.
+*/
+
+#ifndef PLOTDECIMATOR_H
+#define PLOTDECIMATOR_H
+
+#include <QList>
+#include <QPointF>
+#include <vector>
+
+/*!
+ * \class PlotDecimator
+ * \brief Reduce una serie a lo que cabe en el ancho de la gráfica (como mucho 2 puntos por píxel).
+ *
+ * Modos:
+ * - MinMax: divide el rango visible en una columna por píxel y conserva el mínimo y el máximo de
+ *   cada una, en su orden original. Mantiene todos los picos, que es lo que se busca al comparar
+ *   trazas.
+ * - Lttb: Largest-Triangle-Three-Buckets con 2 puntos por píxel; conserva mejor la forma
+ *   visual, aunque puede recortar algún extremo aislado.
+ *
+ * Si el rango visible contiene menos de 2 puntos por píxel, se devuelven sin reducir. Se añade
+ * siempre el punto anterior y el posterior al rango para que la línea llegue a los bordes.
+ *
+ * update() solo recalcula cuando cambia el rango, el ancho o los datos; el coste de dibujar
+ * queda acotado por el ancho del widget y no por el tamaño de la serie.
+ *
+ * \author Enrique Fuentes
+ * \date 2025-05-30
+ */
+class PlotDecimator {
+public:
+    enum class Mode { MinMax, Lttb };
+
+    explicit PlotDecimator(Mode mode = Mode::MinMax) : m_mode(mode) {}
+
+    // Datos con x creciente
+    void setData(std::vector<double> x, std::vector<double> y);
+    void setMode(Mode mode);
+    Mode mode() const { return m_mode; }
+
+    int size() const { return int(m_x.size()); }
+    double firstX() const { return m_x.empty() ? 0.0 : m_x.front(); }
+    double lastX() const  { return m_x.empty() ? 0.0 : m_x.back(); }
+
+    // Recalcula los puntos para [x0, x1] y pixelWidth columnas; false si no ha cambiado nada
+    bool update(double x0, double x1, int pixelWidth);
+    const QList<QPointF> &points() const { return m_points; }
+
+    // Núcleos sin estado, reutilizables con cualquier origen de datos
+    static void minMax(const double *x, const double *y, int n, double x0, double x1,
+                       int buckets, QList<QPointF> &out);
+    static void lttb(const double *x, const double *y, int n, int threshold, QList<QPointF> &out);
+
+private:
+    Mode m_mode;
+    std::vector<double> m_x, m_y;
+    QList<QPointF> m_points;
+
+    bool m_valid = false;
+    double m_x0 = 0.0, m_x1 = 0.0;
+    int m_width = 0;
+};
+
+#endif // PLOTDECIMATOR_H
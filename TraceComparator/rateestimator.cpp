@@ -0,0 +1,173 @@
+/****************************************************************************
+ * RateEstimator.cpp
+ *
+ * Descripción: Estimación en línea de la frecuencia de muestreo real de
+ * cada canal mediante un ajuste por mínimos cuadrados con ventana de las
+ * muestras acumuladas frente al timestamp del dispositivo.
+ *
+ * Fecha: 2025-05-23
+ ****************************************************************************/
+
+#include "rateestimator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int    kMinPoints = 4;          // paquetes mínimos para confiar en el ajuste
+const double kMinSpanSeconds = 2.0;   // duración mínima de la ventana ajustada
+const double kMaxDeviation = 0.2;     // desviación admitida respecto a la nominal (20 %)
+const int    kRebaseEvery = 512;      // recálculo periódico de las sumas
+}
+
+
+
+/**
+ * @param nominalHz Frecuencia nominal del canal (0 si no se conoce).
+ * @param eventChannel true si el canal es de eventos y no tiene frecuencia fija.
+ * @param windowSeconds Duración de la ventana del ajuste.
+ */
+RateEstimator::RateEstimator(double nominalHz, bool eventChannel, double windowSeconds)
+    : m_nominalHz(nominalHz),
+    m_event(eventChannel),
+    m_windowSeconds(windowSeconds)
+{
+}
+
+
+
+void RateEstimator::reset(){
+    m_points.clear();
+    m_hasLast = false;
+    m_count = 0.0;
+    m_sx = m_sy = m_sxx = m_sxy = 0.0;
+    m_removedSinceRebase = 0;
+    m_fitHz = 0.0;
+}
+
+
+
+/**
+ * @return Frecuencia estimada; la nominal mientras el ajuste no es válido.
+ */
+double RateEstimator::rate() const {
+    return m_fitHz > 0.0 ? m_fitHz : m_nominalHz;
+}
+
+
+
+/**
+ * Registra un paquete y calcula el intervalo entre muestras que debe usarse para él.
+ * La última muestra del paquete corresponde a timestampMs.
+ *
+ * @param timestampMs Timestamp del paquete en milisegundos (reloj del dispositivo).
+ * @param numSamples Número de muestras del paquete.
+ * @return Intervalo entre muestras en segundos (0 si todas caen en el mismo instante).
+ */
+double RateEstimator::update(qint64 timestampMs, int numSamples){
+    if (numSamples <= 0) return 0.0;
+
+    const qint64 previousMs = m_lastTimestampMs;
+    const bool hadPrevious = m_hasLast;
+
+    // Un salto hacia atrás o un hueco largo (pérdida de paquetes, reinicio) invalida la ventana
+    if (hadPrevious) {
+        const qint64 gapMs = timestampMs - previousMs;
+        const double expectedMs = rate() > 0.0 ? 1000.0 * numSamples / rate() : 0.0;
+        if (gapMs < 0 || (!m_event && gapMs > std::max(1000.0, 4.0 * expectedMs)))
+            reset();
+    }
+
+    if (m_points.empty()) {
+        m_originMs = timestampMs;
+        m_count = 0.0;
+    } else {
+        m_count += numSamples;
+    }
+    addPoint({ double(timestampMs - m_originMs) / 1000.0, m_count });
+
+    while (m_points.size() > 2 && m_points.back().x - m_points.front().x > m_windowSeconds)
+        removeFront();
+    fit();
+
+    m_lastTimestampMs = timestampMs;
+    m_hasLast = true;
+
+    if (numSamples == 1) return 0.0;
+
+    // Eventos: se reparten en el tiempo transcurrido desde el paquete anterior
+    if (m_event) {
+        if (hadPrevious && timestampMs > previousMs)
+            return double(timestampMs - previousMs) / 1000.0 / numSamples;
+        return rate() > 0.0 ? 1.0 / rate() : 0.0;
+    }
+
+    return rate() > 0.0 ? 1.0 / rate() : 0.0;
+}
+
+
+
+void RateEstimator::addPoint(const Point &p){
+    m_points.push_back(p);
+    m_sx += p.x;
+    m_sy += p.y;
+    m_sxx += p.x * p.x;
+    m_sxy += p.x * p.y;
+}
+
+
+
+void RateEstimator::removeFront(){
+    const Point &p = m_points.front();
+    m_sx -= p.x;
+    m_sy -= p.y;
+    m_sxx -= p.x * p.x;
+    m_sxy -= p.x * p.y;
+    m_points.pop_front();
+
+    if (++m_removedSinceRebase >= kRebaseEvery)
+        rebase();
+}
+
+
+
+// Desplaza el origen al primer punto de la ventana y recalcula las sumas desde cero,
+// para que en sesiones largas no se acumule error de redondeo por las restas
+void RateEstimator::rebase(){
+    m_removedSinceRebase = 0;
+    if (m_points.empty()) return;
+
+    const Point origin = m_points.front();
+    const qint64 shiftMs = std::llround(origin.x * 1000.0);
+    const double dx = shiftMs / 1000.0;
+    m_originMs += shiftMs;
+    m_count -= origin.y;
+
+    m_sx = m_sy = m_sxx = m_sxy = 0.0;
+    for (Point &p : m_points) {
+        p.x -= dx;
+        p.y -= origin.y;
+        m_sx += p.x;
+        m_sy += p.y;
+        m_sxx += p.x * p.x;
+        m_sxy += p.x * p.y;
+    }
+}
+
+
+
+// Pendiente de la recta muestras = a + f·t; solo se acepta si es coherente con la nominal
+void RateEstimator::fit(){
+    m_fitHz = 0.0;
+    const double n = double(m_points.size());
+    if (n < kMinPoints) return;
+    if (m_points.back().x - m_points.front().x < kMinSpanSeconds) return;
+
+    const double den = n * m_sxx - m_sx * m_sx;
+    if (den <= 0.0) return;
+    const double slope = (n * m_sxy - m_sx * m_sy) / den;
+    if (!(slope > 0.0)) return;
+
+    if (!m_event && m_nominalHz > 0.0 && std::abs(slope - m_nominalHz) > kMaxDeviation * m_nominalHz)
+        return;
+    m_fitHz = slope;
+}